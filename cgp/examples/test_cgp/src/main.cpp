@@ -13,6 +13,18 @@
 #include "cgp/19_camera_controller/test/test_camera_controller.hpp"
 #include "cgp/06_mat/test/test_matrix_stack.hpp"
 #include "cgp/06_mat/functions/test/test_vec_mat.hpp"
+#include "cgp/08_random_noise/random_stream/test/test_random_stream.hpp"
+#include "cgp/01_base/thread_pool/test/test_thread_pool.hpp"
+#include "cgp/13_opengl/shaders/uniform_id/test/test_uniform_id.hpp"
+#include "cgp/09_geometric_transformation/affine/model_matrix_cache/test/test_model_matrix_cache.hpp"
+#include "cgp/12_shape/frustum/test/test_frustum.hpp"
+#include "cgp/12_shape/occlusion_buffer/test/test_occlusion_buffer.hpp"
+#include "cgp/11_mesh/simplification/test/test_simplification.hpp"
+#include "cgp/16_drawable/impostor_atlas/test/test_impostor_atlas.hpp"
+#include "cgp/20_format_parser/mesh_loader/obj/test/test_obj.hpp"
+#include "cgp/20_format_parser/mesh_loader/mesh_cache/test/test_mesh_cache.hpp"
+#include "cgp/20_format_parser/texture_cache/test/test_texture_cache.hpp"
+#include "cgp/21_scene_project_helper/asset_loader/test/test_asset_loader.hpp"
 
 
 using namespace cgp;
@@ -30,6 +42,18 @@ int main(int, char* argv[])
 	cgp_test::test_camera_controller();
 	cgp_test::test_matrix_stack();
 	cgp_test::test_vec_mat();
+	cgp_test::test_random_stream();
+	cgp_test::test_thread_pool();
+	cgp_test::test_uniform_id();
+	cgp_test::test_model_matrix_cache();
+	cgp_test::test_frustum();
+	cgp_test::test_occlusion_buffer();
+	cgp_test::test_simplification();
+	cgp_test::test_impostor_atlas();
+	cgp_test::test_obj();
+	cgp_test::test_mesh_cache();
+	cgp_test::test_texture_cache();
+	cgp_test::test_asset_loader();
 
 
 	return 0;
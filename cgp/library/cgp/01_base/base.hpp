@@ -6,4 +6,4 @@
 #include "stl/stl.hpp"
 #include "types/types.hpp"
 #include "string/string.hpp"
-
+#include "thread_pool/thread_pool.hpp"
@@ -0,0 +1,79 @@
+#include "cgp/01_base/base.hpp"
+
+#include <vector>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test 
+{
+
+	void test_thread_pool()
+	{
+		using namespace cgp;
+
+		for (int number_of_threads : {1, 4}) {
+			thread_pool pool(number_of_threads);
+
+			// every index is visited once
+			{
+				int const N = 10000;
+				std::vector<int> visit(N, 0);
+				parallel_for(0, N, [&](int k) { visit[k]++; }, 0, pool);
+				for (int k = 0; k < N; ++k)
+					assert_cgp_no_msg(visit[k] == 1);
+			}
+
+			// nested loops and small grain
+			{
+				int const N = 64;
+				std::vector<int> sum(N, 0);
+				parallel_for(0, N, [&](int i) {
+					std::atomic<int> s(0);
+					parallel_for(0, 100, [&](int j) { s += j; }, 1, pool);
+					sum[i] = s;
+				}, 1, pool);
+				for (int k = 0; k < N; ++k)
+					assert_cgp_no_msg(sum[k] == 4950);
+			}
+
+			// the default pool of a worker is its own pool
+			{
+				std::thread::id const caller = std::this_thread::get_id();
+				std::atomic<int> wrong(0);
+				parallel_for(0, 256, [&](int) {
+					thread_pool const& current = thread_pool_default();
+					if (std::this_thread::get_id() != caller && &current != &pool)
+						wrong++;
+				}, 1, pool);
+				assert_cgp_no_msg(wrong == 0);
+			}
+
+			// empty range
+			{
+				bool called = false;
+				pool.parallel_for(3, 3, [&](int, int) { called = true; });
+				assert_cgp_no_msg(!called);
+			}
+
+			// task graph: each task starts after its dependencies
+			{
+				std::atomic<int> clock(0);
+				std::vector<int> date(4, -1);
+				task_graph graph;
+				int const a = graph.add([&]() { date[0] = clock++; });
+				int const b = graph.add([&]() { date[1] = clock++; }, { a });
+				int const c = graph.add([&]() { date[2] = clock++; }, { a });
+				graph.add([&]() { date[3] = clock++; }, { b, c });
+				graph.run(pool);
+				assert_cgp_no_msg(clock == 4);
+				assert_cgp_no_msg(date[0] < date[1] && date[0] < date[2]);
+				assert_cgp_no_msg(date[1] < date[3] && date[2] < date[3]);
+
+				graph.run(pool); // A graph can be run again
+				assert_cgp_no_msg(clock == 8);
+			}
+		}
+	}
+}
@@ -0,0 +1,209 @@
+#include "thread_pool.hpp"
+#include "cgp/01_base/base.hpp"
+
+#include <algorithm>
+
+namespace cgp
+{
+	// Pool and queue index of the current thread when it is a worker
+	static thread_local thread_pool* worker_pool = nullptr;
+	static thread_local int worker_queue = 0;
+
+	thread_pool::thread_pool(int number_of_threads)
+		:queued(0), idle_workers(0), stopping(false)
+	{
+#ifndef __EMSCRIPTEN__
+		if (number_of_threads <= 0)
+			number_of_threads = std::max(1, int(std::thread::hardware_concurrency()));
+#else
+		number_of_threads = 1;
+#endif
+		int const number_of_workers = number_of_threads - 1; // The thread waiting for the tasks also runs them
+		for (int k = 0; k < number_of_workers + 1; ++k)
+			queues.push_back(std::unique_ptr<task_queue>(new task_queue()));
+		for (int k = 1; k <= number_of_workers; ++k)
+			workers.push_back(std::thread([this, k]() { worker_loop(k); }));
+	}
+
+	thread_pool::~thread_pool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(sleep_mutex);
+			stopping = true;
+		}
+		wake_up.notify_all();
+		for (std::thread& worker : workers)
+			worker.join();
+	}
+
+	int thread_pool::size() const
+	{
+		return int(workers.size()) + 1;
+	}
+
+	int thread_pool::current_queue() const
+	{
+		return worker_pool == this ? worker_queue : 0;
+	}
+
+	void thread_pool::submit(std::function<void()> task)
+	{
+		if (workers.empty()) {
+			task();
+			return;
+		}
+
+		task_queue& queue = *queues[current_queue()];
+		{
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			queue.tasks.push_back(std::move(task));
+		}
+		queued++;
+
+		// A worker increments idle_workers before checking the queues under sleep_mutex: if it was not counted yet, it will see the task
+		if (idle_workers > 0) {
+			{ std::lock_guard<std::mutex> lock(sleep_mutex); }
+			wake_up.notify_one();
+		}
+	}
+
+	bool thread_pool::run_one_task(int queue_index)
+	{
+		if (queued == 0)
+			return false;
+
+		std::function<void()> task;
+		int const N = int(queues.size());
+		for (int k = 0; k < N && !task; ++k) {
+			int const index = (queue_index + k) % N;
+			task_queue& queue = *queues[index];
+			std::lock_guard<std::mutex> lock(queue.mutex);
+			if (queue.tasks.empty())
+				continue;
+			if (k == 0) { // Own queue: last pushed task (still in cache)
+				task = std::move(queue.tasks.back());
+				queue.tasks.pop_back();
+			}
+			else { // Stolen: oldest task (usually the largest part of a split range)
+				task = std::move(queue.tasks.front());
+				queue.tasks.pop_front();
+			}
+		}
+		if (!task)
+			return false;
+
+		queued--;
+		task();
+		return true;
+	}
+
+	void thread_pool::worker_loop(int queue_index)
+	{
+		worker_pool = this;
+		worker_queue = queue_index;
+		while (true) {
+			if (run_one_task(queue_index))
+				continue;
+
+			std::unique_lock<std::mutex> lock(sleep_mutex);
+			idle_workers++;
+			wake_up.wait(lock, [this]() { return stopping || queued > 0; });
+			idle_workers--;
+			if (stopping && queued == 0)
+				return;
+		}
+	}
+
+	void thread_pool::wait(std::atomic<int> const& counter)
+	{
+		int const queue_index = current_queue();
+		while (counter > 0) {
+			if (!run_one_task(queue_index))
+				std::this_thread::yield();
+		}
+	}
+
+	void thread_pool::split_range(std::function<void(int, int)> const& body, int begin, int end, int grain, std::atomic<int>& remaining)
+	{
+		while (end - begin > grain && (idle_workers > 0 || queued < size())) {
+			int const middle = begin + (end - begin) / 2;
+			submit([this, &body, middle, end, grain, &remaining]() { split_range(body, middle, end, grain, remaining); });
+			end = middle;
+		}
+		body(begin, end);
+		remaining -= end - begin;
+	}
+
+	void thread_pool::parallel_for(int begin, int end, std::function<void(int, int)> const& body, int grain)
+	{
+		int const N = end - begin;
+		if (N <= 0)
+			return;
+		if (grain <= 0)
+			grain = std::max(1, N / (8 * size()));
+		if (workers.empty() || N <= grain) {
+			body(begin, end);
+			return;
+		}
+
+		std::atomic<int> remaining(N);
+		split_range(body, begin, end, grain, remaining);
+		wait(remaining);
+	}
+
+	thread_pool& thread_pool_default()
+	{
+		if (worker_pool != nullptr)
+			return *worker_pool;
+		static thread_pool pool;
+		return pool;
+	}
+
+
+	int task_graph::add(std::function<void()> task, std::vector<int> const& dependencies)
+	{
+		int const index = int(nodes.size());
+		node n;
+		n.task = std::move(task);
+		n.dependency_count = int(dependencies.size());
+		nodes.push_back(std::move(n));
+		for (int d : dependencies) {
+			assert_cgp(d >= 0 && d < index, "Task " + str(index) + " depends on task " + str(d) + " which is not added before");
+			nodes[d].successors.push_back(index);
+		}
+		return index;
+	}
+
+	void task_graph::run(thread_pool& pool)
+	{
+		int const N = int(nodes.size());
+		std::vector<std::atomic<int> > dependencies_left(N);
+		for (int k = 0; k < N; ++k)
+			dependencies_left[k] = nodes[k].dependency_count;
+		std::atomic<int> unfinished(N);
+
+		std::function<void(int)> launch = [&](int k) {
+			pool.submit([&, k]() {
+				nodes[k].task();
+				for (int s : nodes[k].successors)
+					if (--dependencies_left[s] == 0)
+						launch(s);
+				unfinished--;
+			});
+		};
+		for (int k = 0; k < N; ++k)
+			if (nodes[k].dependency_count == 0)
+				launch(k);
+		pool.wait(unfinished);
+	}
+
+	int task_graph::size() const
+	{
+		return int(nodes.size());
+	}
+
+	void task_graph::clear()
+	{
+		nodes.clear();
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cgp
+{
+	/** Persistent pool of worker threads with work stealing
+	 * - Each worker has its own queue of tasks: it runs the last task it pushed, and steals the oldest task of another queue when its own is empty.
+	 * - A thread waiting for tasks (wait, parallel_for, task_graph::run) runs queued tasks in the meantime: calls can be nested.
+	 * - Tasks must not throw exceptions.
+	 * Without thread support (Emscripten), the pool has no worker and every task runs on the calling thread. */
+	struct thread_pool
+	{
+		/** Pool with number_of_threads threads running tasks, including the calling thread (0: one per hardware core) */
+		explicit thread_pool(int number_of_threads = 0);
+		~thread_pool();
+		thread_pool(thread_pool const&) = delete;
+		thread_pool& operator=(thread_pool const&) = delete;
+
+		/** Number of threads running tasks: the workers and the thread waiting for them */
+		int size() const;
+
+		/** Add a task to the queue of the current thread */
+		void submit(std::function<void()> task);
+
+		/** Run queued tasks until counter reaches 0 */
+		void wait(std::atomic<int> const& counter);
+
+		/** Call body(b, e) on sub-ranges [b,e[ covering [begin,end[
+		 * Ranges are split in halves while they are larger than grain and some worker is idle (lazy splitting):
+		 * a small loop, or a loop run while the workers are busy, is not cut into more tasks than needed.
+		 * grain = 0 gives a default grain of (end-begin)/(8*size()). A range not larger than grain runs on the calling thread without any task. */
+		void parallel_for(int begin, int end, std::function<void(int, int)> const& body, int grain = 0);
+
+	private:
+		struct task_queue {
+			std::mutex mutex;
+			std::deque<std::function<void()> > tasks;
+		};
+
+		std::vector<std::unique_ptr<task_queue> > queues; // queues[0] for the threads outside of the pool, queues[k] for the worker k
+		std::vector<std::thread> workers;
+
+		std::atomic<int> queued;       // Number of tasks in the queues
+		std::atomic<int> idle_workers; // Number of workers sleeping
+		std::atomic<bool> stopping;
+		std::mutex sleep_mutex;
+		std::condition_variable wake_up;
+
+		int current_queue() const;
+		bool run_one_task(int queue_index);
+		void worker_loop(int queue_index);
+		void split_range(std::function<void(int, int)> const& body, int begin, int end, int grain, std::atomic<int>& remaining);
+	};
+
+	/** Pool shared by the library and the application, created at the first call
+	 * Called by a worker of another pool, returns that pool: the parallel loops of its tasks stay on it (ex. images decoded on the pool of an asset_loader). */
+	thread_pool& thread_pool_default();
+
+	/** Call f(k) for every k in [begin,end[ on the threads of the pool */
+	template <typename F>
+	void parallel_for(int begin, int end, F const& f, int grain = 0, thread_pool& pool = thread_pool_default())
+	{
+		pool.parallel_for(begin, end, [&f](int b, int e) { for (int k = b; k < e; ++k) f(k); }, grain);
+	}
+
+
+	/** Set of tasks with dependencies, run on a thread_pool
+	 * A task starts once all the tasks it depends on are finished. Dependencies refer to tasks added before: the graph cannot have cycles. */
+	struct task_graph
+	{
+		/** Add a task running after the given ones, return its index */
+		int add(std::function<void()> task, std::vector<int> const& dependencies = {});
+		/** Run all the tasks and return when they are finished (the graph can be run again) */
+		void run(thread_pool& pool = thread_pool_default());
+
+		int size() const;
+		void clear();
+
+	private:
+		struct node {
+			std::function<void()> task;
+			std::vector<int> successors;
+			int dependency_count = 0;
+		};
+		std::vector<node> nodes;
+	};
+}
@@ -2,10 +2,23 @@
 
 #include "cgp/01_base/base.hpp"
 
+#include <cstdio>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sys/stat.h>
 
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#include <direct.h>
+#elif !defined(__EMSCRIPTEN__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
 #if defined(__linux__) || defined(__EMSCRIPTEN__)
 #pragma GCC diagnostic ignored "-Wunused-variable"
 #endif
@@ -74,7 +87,52 @@ namespace cgp
         return stat_buf.st_size;
     }
 
-    
+    int64_t file_get_modification_time(std::string const& filename)
+    {
+        struct stat stat_buf;
+        if (stat(filename.c_str(), &stat_buf) != 0)
+            return -1;
+        return int64_t(stat_buf.st_mtime);
+    }
+
+    bool create_directory(std::string const& pathname)
+    {
+        if (check_path_exist(pathname))
+            return true;
+#if defined(_WIN32)
+        _mkdir(pathname.c_str());
+#else
+        mkdir(pathname.c_str(), 0755);
+#endif
+        return check_path_exist(pathname);
+    }
+
+    uint64_t hash_bytes(char const* data, size_t size)
+    {
+        // Four independent lanes mixing 8 octets each per step, then the remaining octets one by one
+        uint64_t const prime_1 = 0x9E3779B185EBCA87ull;
+        uint64_t const prime_2 = 0xC2B2AE3D27D4EB4Full;
+        uint64_t lane[4] = { prime_1, prime_2, ~prime_1, ~prime_2 };
+        size_t k = 0;
+        for (; k + 32 <= size; k += 32) {
+            for (int i = 0; i < 4; ++i) {
+                uint64_t word;
+                std::memcpy(&word, data + k + 8 * i, 8);
+                lane[i] ^= word * prime_2;
+                lane[i] = ((lane[i] << 31) | (lane[i] >> 33)) * prime_1;
+            }
+        }
+        uint64_t h = uint64_t(size) * prime_1;
+        for (int i = 0; i < 4; ++i)
+            h = ((h ^ lane[i]) * prime_2) + (h >> 29);
+        for (; k < size; ++k)
+            h = (h ^ uint64_t(static_cast<unsigned char>(data[k]))) * prime_1;
+        h ^= h >> 33;
+        h *= prime_2;
+        h ^= h >> 29;
+        return h;
+    }
+
     std::vector <char> read_from_file_binary(std::string const& filename)
     {
         assert_file_exist(filename);
@@ -91,4 +149,95 @@ namespace cgp
 
         return buffer;
     }
-}
\ No newline at end of file
+
+    file_mapping::file_mapping(std::string const& filename)
+    {
+        open(filename);
+    }
+
+    file_mapping::~file_mapping()
+    {
+        close();
+    }
+
+    void file_mapping::open(std::string const& filename)
+    {
+        close();
+        assert_file_exist(filename);
+        size = file_get_size(filename);
+        if (size == 0)
+            return;
+
+#if defined(_WIN32)
+        HANDLE const file = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        assert_cgp(file != INVALID_HANDLE_VALUE, "Cannot open file " + filename);
+        handle = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        CloseHandle(file);
+        assert_cgp(handle != NULL, "Cannot map file " + filename);
+        data = static_cast<char const*>(MapViewOfFile(handle, FILE_MAP_READ, 0, 0, 0));
+        assert_cgp(data != nullptr, "Cannot map file " + filename);
+#elif !defined(__EMSCRIPTEN__)
+        int const file = ::open(filename.c_str(), O_RDONLY);
+        assert_cgp(file != -1, "Cannot open file " + filename);
+        void* const mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+        ::close(file);
+        assert_cgp(mapped != MAP_FAILED, "Cannot map file " + filename);
+        madvise(mapped, size, MADV_SEQUENTIAL);
+        data = static_cast<char const*>(mapped);
+#else
+        buffer = read_from_file_binary(filename);
+        data = buffer.data();
+#endif
+    }
+
+    void file_mapping::close()
+    {
+#if defined(_WIN32)
+        if (data != nullptr)
+            UnmapViewOfFile(data);
+        if (handle != nullptr)
+            CloseHandle(handle);
+#elif !defined(__EMSCRIPTEN__)
+        if (data != nullptr)
+            munmap(const_cast<char*>(data), size);
+#endif
+        buffer.clear();
+        handle = nullptr;
+        data = nullptr;
+        size = 0;
+    }
+
+    uint64_t file_hash(std::string const& filename)
+    {
+        file_mapping const file(filename);
+        return hash_bytes(file.data, file.size);
+    }
+
+    bool file_replace(std::string const& temporary_filename, std::string const& filename)
+    {
+        if (std::rename(temporary_filename.c_str(), filename.c_str()) == 0)
+            return true;
+        std::remove(filename.c_str()); // The rename does not replace an existing file on Windows
+        if (std::rename(temporary_filename.c_str(), filename.c_str()) == 0)
+            return true;
+        std::remove(temporary_filename.c_str());
+        return false;
+    }
+
+    std::string cache_filename(std::string const& source_filename, std::string const& cache_directory, std::string const& extension)
+    {
+        if (cache_directory.empty())
+            return source_filename + extension;
+
+        // Name of the file, and hash of its path (different files with the same name)
+        size_t const separator = source_filename.find_last_of("/\\");
+        std::string const name = separator == std::string::npos ? source_filename : source_filename.substr(separator + 1);
+        char hash[17];
+        std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(hash_bytes(source_filename.data(), source_filename.size())));
+
+        create_directory(cache_directory);
+        char const last = cache_directory.back();
+        std::string const directory = (last == '/' || last == '\\') ? cache_directory : cache_directory + "/";
+        return directory + name + "." + hash + extension;
+    }
+}
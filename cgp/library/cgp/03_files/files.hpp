@@ -3,6 +3,7 @@
 
 #include "cgp/02_numarray/numarray.hpp"
 
+#include <cstdint>
 #include <string>
 #include <sstream>
 #include <fstream>
@@ -22,9 +23,47 @@ namespace cgp
 	/** Return the size in octets of a file*/
 	size_t file_get_size(std::string const& filename);
 
+	/** Time of the last modification of a file (in seconds since 1970), or -1 if the file cannot be accessed */
+	int64_t file_get_modification_time(std::string const& filename);
+
+	/** Create a directory (its parent directory must exist). Return true if the directory exists afterwards */
+	bool create_directory(std::string const& pathname);
+
+	/** 64-bit hash of an array of octets (not cryptographic: detects a file modified since a previous hash) */
+	uint64_t hash_bytes(char const* data, size_t size);
+	/** hash_bytes of the content of a file (read through a file_mapping) */
+	uint64_t file_hash(std::string const& filename);
+	/** Rename temporary_filename as filename, replacing filename if it exists (a file written under a temporary name is either complete or absent)
+	 * Return false if the rename failed: temporary_filename is removed. */
+	bool file_replace(std::string const& temporary_filename, std::string const& filename);
+	/** File caching data computed from source_filename: source_filename + extension next to it,
+	 * or name_of_the_source.<hash of its path>.extension in cache_directory (created if needed) if it is not empty */
+	std::string cache_filename(std::string const& source_filename, std::string const& cache_directory, std::string const& extension);
+
 	/** Read the entire content of a file as binary vector of octets*/
 	std::vector <char> read_from_file_binary(std::string const& filename);
 
+	/** Read-only view of the content of a file mapped in memory (read in a buffer on the platforms without mapping)
+	 * The view is valid until close() or the destruction of the structure (which cannot be copied). */
+	struct file_mapping
+	{
+		char const* data = nullptr;
+		size_t size = 0;
+
+		file_mapping() = default;
+		explicit file_mapping(std::string const& filename);
+		~file_mapping();
+		file_mapping(file_mapping const&) = delete;
+		file_mapping& operator=(file_mapping const&) = delete;
+
+		void open(std::string const& filename);
+		void close();
+
+	private:
+		void* handle = nullptr;     // Mapping object (Windows)
+		std::vector<char> buffer;   // Content of the file when it is not mapped
+	};
+
 	std::string read_text_file(std::string const& filename);
 	template <typename T> void read_from_file(std::string const& filename, T& data);
 	template <typename T> void read_from_file(std::string const& filename, numarray<numarray<T>>& data);
@@ -57,4 +57,5 @@ namespace cgp
 	//    1 4 7 10
 	//    2 5 8 11
 	std::vector<image_structure> image_split_grid(image_structure const& image_in, int N_horizontal, int N_vertical);
-}
\ No newline at end of file
+}
+#include "image_mipmap/image_mipmap.hpp"
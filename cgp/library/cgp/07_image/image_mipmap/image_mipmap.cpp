@@ -0,0 +1,128 @@
+#include "image_mipmap.hpp"
+
+#include "cgp/01_base/base.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace cgp
+{
+    static int size_of_component(image_color_type const& type)
+    {
+        return type == image_color_type::rgb ? 3 : 4;
+    }
+
+    int image_mipmap_view::level_width(int level) const
+    {
+        return std::max(1, width >> level);
+    }
+
+    int image_mipmap_view::level_height(int level) const
+    {
+        return std::max(1, height >> level);
+    }
+
+    size_t image_mipmap_view::level_size(int level) const
+    {
+        return size_t(level_width(level)) * size_t(level_height(level)) * size_t(size_of_component(color_type));
+    }
+
+    size_t image_mipmap_view::face_size() const
+    {
+        size_t size = 0;
+        for (int k = 0; k < level_count; ++k)
+            size += level_size(k);
+        return size;
+    }
+
+    unsigned char const* image_mipmap_view::level_data(int face, int level) const
+    {
+        assert_cgp(face >= 0 && face < face_count && level >= 0 && level < level_count, "Incorrect face " + str(face) + " or level " + str(level) + " (" + str(face_count) + " faces, " + str(level_count) + " levels)");
+        size_t offset = size_t(face) * face_size();
+        for (int k = 0; k < level; ++k)
+            offset += level_size(k);
+        return data + offset;
+    }
+
+    image_mipmap_view image_mipmap::view() const
+    {
+        image_mipmap_view v;
+        v.width = width;
+        v.height = height;
+        v.level_count = level_count;
+        v.face_count = face_count;
+        v.color_type = color_type;
+        v.data = data.size() > 0 ? data.data.data() : nullptr;
+        return v;
+    }
+
+    int mipmap_level_count(int width, int height)
+    {
+        int count = 1;
+        for (int size = std::max(width, height); size > 1; size /= 2)
+            count++;
+        return count;
+    }
+
+    // Level of size (w, h) from the previous level of size (w_in, h_in): average of the 2x2 pixels (clamped on the last row and column)
+    static void mipmap_reduce(unsigned char const* in, int w_in, int h_in, unsigned char* out, int w, int h, int d)
+    {
+        parallel_for(0, h, [&](int y) {
+            int const y0 = std::min(2 * y, h_in - 1);
+            int const y1 = std::min(2 * y + 1, h_in - 1);
+            for (int x = 0; x < w; ++x) {
+                int const x0 = std::min(2 * x, w_in - 1);
+                int const x1 = std::min(2 * x + 1, w_in - 1);
+                for (int c = 0; c < d; ++c) {
+                    int const sum = in[(x0 + w_in * y0) * d + c] + in[(x1 + w_in * y0) * d + c] + in[(x0 + w_in * y1) * d + c] + in[(x1 + w_in * y1) * d + c];
+                    out[(x + w * y) * d + c] = (unsigned char)((sum + 2) / 4);
+                }
+            }
+        }, std::max(1, (1 << 16) / std::max(1, w * d)));
+    }
+
+    image_mipmap image_mipmap_build(std::vector<image_structure> const& faces, int level_count)
+    {
+        assert_cgp(faces.size() == 1 || faces.size() == 6, "Mip levels are built for an image or the 6 faces of a cubemap (" + str(faces.size()) + " images)");
+        image_structure const& first = faces[0];
+        assert_cgp(first.width > 0 && first.height > 0, "Cannot build the mip levels of an empty image");
+        for (image_structure const& face : faces) {
+            assert_cgp(face.width == first.width && face.height == first.height && face.color_type == first.color_type, "The faces of a cubemap must have the same size and color type");
+            assert_cgp(faces.size() == 1 || face.width == face.height, "The faces of a cubemap must be square");
+            assert_cgp(size_t(face.data.size()) == size_t(face.width) * size_t(face.height) * size_t(size_of_component(face.color_type)), "The size of the image data does not match its dimensions");
+        }
+
+        image_mipmap mipmap;
+        mipmap.width = first.width;
+        mipmap.height = first.height;
+        mipmap.face_count = int(faces.size());
+        mipmap.color_type = first.color_type;
+        int const full_chain = mipmap_level_count(first.width, first.height);
+        mipmap.level_count = level_count <= 0 ? full_chain : std::min(level_count, full_chain);
+
+        image_mipmap_view view = mipmap.view();
+        int const d = size_of_component(mipmap.color_type);
+        mipmap.data.resize(int(size_t(mipmap.face_count) * view.face_size()));
+        view.data = mipmap.data.data.data();
+        for (int f = 0; f < mipmap.face_count; ++f) {
+            std::memcpy(const_cast<unsigned char*>(view.level_data(f, 0)), faces[f].data.data.data(), view.level_size(0));
+            for (int k = 1; k < mipmap.level_count; ++k)
+                mipmap_reduce(view.level_data(f, k - 1), view.level_width(k - 1), view.level_height(k - 1), const_cast<unsigned char*>(view.level_data(f, k)), view.level_width(k), view.level_height(k), d);
+        }
+        return mipmap;
+    }
+
+    image_mipmap image_mipmap_build(image_structure const& im, int level_count)
+    {
+        return image_mipmap_build(std::vector<image_structure>{ im }, level_count);
+    }
+
+    image_structure image_mipmap_level(image_mipmap_view const& mipmap, int face, int level)
+    {
+        unsigned char const* data = mipmap.level_data(face, level);
+        numarray<unsigned char> pixels;
+        pixels.resize(int(mipmap.level_size(level)));
+        std::memcpy(pixels.data.data(), data, mipmap.level_size(level));
+        return image_structure(mipmap.level_width(level), mipmap.level_height(level), mipmap.color_type, pixels);
+    }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "cgp/07_image/image.hpp"
+
+#include <vector>
+
+namespace cgp
+{
+	// Mip levels of an image, or of the 6 faces of a cubemap, computed beforehand (ex. stored in a texture cache) instead of by glGenerateMipmap
+	//  Level k has the size max(1, width>>k) x max(1, height>>k): each of its pixels is the average of the (up to) 2x2 pixels of the level k-1.
+	//  The rows of the levels are not padded. The faces of a cubemap are in the order x_neg, x_pos, y_neg, y_pos, z_neg, z_pos.
+	struct image_mipmap_view
+	{
+		int width = 0;       // Size of the level 0
+		int height = 0;
+		int level_count = 0;
+		int face_count = 0;  // 1 for an image, 6 for a cubemap
+		image_color_type color_type = image_color_type::rgba;
+		unsigned char const* data = nullptr; // All the levels of the face 0, then all the levels of the face 1, etc.
+
+		int level_width(int level) const;
+		int level_height(int level) const;
+		// Size in octets of a level of one face
+		size_t level_size(int level) const;
+		// Size in octets of all the levels of one face
+		size_t face_size() const;
+		unsigned char const* level_data(int face, int level) const;
+	};
+
+	// Mip levels stored in memory
+	struct image_mipmap
+	{
+		int width = 0;
+		int height = 0;
+		int level_count = 0;
+		int face_count = 0;
+		image_color_type color_type = image_color_type::rgba;
+		numarray<unsigned char> data;
+
+		image_mipmap_view view() const;
+	};
+
+	// Number of levels of the full chain of an image, down to 1x1
+	int mipmap_level_count(int width, int height);
+
+	// Mip levels of an image (level_count = 0: full chain)
+	image_mipmap image_mipmap_build(image_structure const& im, int level_count = 0);
+	// Mip levels of the faces of a cubemap (6 square images of the same size and color type)
+	image_mipmap image_mipmap_build(std::vector<image_structure> const& faces, int level_count = 0);
+
+	// Copy of a level of a face
+	image_structure image_mipmap_level(image_mipmap_view const& mipmap, int face, int level);
+}
@@ -1,4 +1,5 @@
 #pragma once
 
 #include "rand/rand.hpp"
+#include "random_stream/random_stream.hpp"
 #include "noise/noise.hpp"
@@ -0,0 +1,100 @@
+#include "random_stream.hpp"
+#include "cgp/01_base/base.hpp"
+
+#include <atomic>
+#include <cmath>
+
+namespace cgp
+{
+	static uint64_t const random_gamma = 0x9E3779B97F4A7C15ull; // Increment of SplitMix64 (golden ratio)
+
+	uint64_t random_hash(uint64_t x)
+	{
+		x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ull;
+		x = (x ^ (x >> 27)) * 0x94D049BB133111EBull;
+		return x ^ (x >> 31);
+	}
+
+	// Uniform float in [0,1[ from the 24 high bits
+	static float unit_float(uint64_t x)
+	{
+		return float(x >> 40) * (1.0f / 16777216.0f);
+	}
+
+	float random_uniform_value(uint64_t x, float value_min, float value_max)
+	{
+		float const value = value_min + (value_max - value_min) * unit_float(x);
+		return value != value_max ? value : std::nextafter(value_max, value_min); // value_min + (value_max - value_min) * (1 - 2^-24) can be rounded to value_max
+	}
+
+	random_stream::random_stream(uint64_t seed, uint64_t stream, uint64_t substream)
+	{
+		key = random_hash(random_hash(random_hash(seed) + stream * random_gamma) + substream * random_gamma);
+	}
+
+	uint64_t random_stream::at(uint64_t n) const
+	{
+		return random_hash(key + (n + 1) * random_gamma);
+	}
+
+	uint64_t random_stream::next()
+	{
+		return at(counter++);
+	}
+
+	float random_stream::uniform(float value_min, float value_max)
+	{
+		return random_uniform_value(next(), value_min, value_max);
+	}
+
+	int random_stream::uniform_int(int value_min, int value_max)
+	{
+		assert_cgp(value_min <= value_max, "Empty interval [" + str(value_min) + "," + str(value_max) + "]");
+		uint64_t const range = uint64_t(int64_t(value_max) - int64_t(value_min)) + 1;
+		return int(int64_t(value_min) + int64_t(((next() >> 32) * range) >> 32)); // Multiply-shift reduction of 32 bits
+	}
+
+	float random_stream::normal(float average, float stddev)
+	{
+		float const u1 = 1.0f - unit_float(next()); // in ]0,1] to avoid log(0)
+		float const u2 = unit_float(next());
+		return average + stddev * std::sqrt(-2.0f * std::log(u1)) * std::cos(2.0f * 3.14159265358979f * u2);
+	}
+
+	void random_stream::fill_uniform(float* data, size_t N, float value_min, float value_max)
+	{
+		uint64_t const k0 = key + (counter + 1) * random_gamma;
+		for (size_t k = 0; k < N; ++k)
+			data[k] = random_uniform_value(random_hash(k0 + k * random_gamma), value_min, value_max);
+		counter += N;
+	}
+
+
+	static std::atomic<uint64_t> global_seed(0);
+	static std::atomic<unsigned int> global_seed_generation(0); // Incremented at each change of seed
+	static std::atomic<uint64_t> thread_counter(0);
+
+	void random_stream_set_seed(uint64_t seed)
+	{
+		global_seed = seed;
+		global_seed_generation++;
+	}
+	uint64_t random_stream_seed()
+	{
+		return global_seed;
+	}
+
+	random_stream& random_stream_thread()
+	{
+		thread_local uint64_t const thread_index = thread_counter++;
+		thread_local unsigned int generation = unsigned(-1);
+		thread_local random_stream stream;
+
+		unsigned int const current_generation = global_seed_generation;
+		if (generation != current_generation) {
+			stream = random_stream(global_seed, thread_index);
+			generation = current_generation;
+		}
+		return stream;
+	}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+
+namespace cgp
+{
+	/** Counter-based random generator: the n-th number of a stream is a hash (SplitMix64) of its key and of n.
+	 * - A stream is identified by a seed and up to two stream indices (ex. thread index, entity index + step number).
+	 * - Streams have no shared state: they can be created on the fly and used concurrently in parallel loops.
+	 * - The same (seed, stream) always generates the same sequence, independently of the number of threads. */
+	struct random_stream
+	{
+		uint64_t key = 0;     // Hash of the seed and the stream indices
+		uint64_t counter = 0; // Index of the next generated number
+
+		random_stream(uint64_t seed = 0, uint64_t stream = 0, uint64_t substream = 0);
+
+		/** Number of index n in the stream (does not modify the counter) */
+		uint64_t at(uint64_t n) const;
+		/** Next 64 bits number of the stream */
+		uint64_t next();
+
+		/** Uniform random distribution on [value_min, value_max[ */
+		float uniform(float value_min = 0.0f, float value_max = 1.0f);
+		/** Uniform random integer in [value_min, value_max] */
+		int uniform_int(int value_min, int value_max);
+		/** Normal random distribution (Box-Muller) */
+		float normal(float average = 0.0f, float stddev = 1.0f);
+
+		/** Fill data[0..N-1] with uniform values in [value_min, value_max[
+		 * Gives the same values as N calls to uniform(), but the loop has no dependency between iterations */
+		void fill_uniform(float* data, size_t N, float value_min = 0.0f, float value_max = 1.0f);
+	};
+
+	/** Uniform value in [value_min, value_max[ given by the 24 high bits of x (used by random_stream::uniform and fill_uniform) */
+	float random_uniform_value(uint64_t x, float value_min, float value_max);
+
+	/** Mixing function of SplitMix64 (bijective hash of 64 bits integers) */
+	uint64_t random_hash(uint64_t x);
+
+	/** Global seed from which the per-thread streams are derived (default 0)
+	 * Changing the seed resets the streams of all the threads */
+	void random_stream_set_seed(uint64_t seed);
+	uint64_t random_stream_seed();
+
+	/** Stream of the calling thread: random_stream(seed, k) for the k-th thread using it
+	 * Threads are numbered by order of first call: a single-threaded program is fully reproducible from the seed.
+	 * In parallel loops, prefer a per-entity stream random_stream(seed, entity) to be independent of the scheduling. */
+	random_stream& random_stream_thread();
+}
@@ -0,0 +1,92 @@
+#include "cgp/01_base/base.hpp"
+#include "cgp/08_random_noise/random_stream/random_stream.hpp"
+
+#include <vector>
+#include <cmath>
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test 
+{
+
+	void test_random_stream()
+	{
+		using namespace cgp;
+
+		// same seed and stream give the same sequence
+		{
+			random_stream a(7, 3), b(7, 3);
+			for (int k = 0; k < 100; ++k)
+				assert_cgp_no_msg(a.next() == b.next());
+		}
+
+		// different streams give different sequences
+		{
+			random_stream a(7, 3), b(7, 4), c(8, 3), d(7, 3, 1);
+			assert_cgp_no_msg(a.at(0) != b.at(0));
+			assert_cgp_no_msg(a.at(0) != c.at(0));
+			assert_cgp_no_msg(a.at(0) != d.at(0));
+		}
+
+		// at(n) is the n-th number of the stream
+		{
+			random_stream a(1, 2);
+			uint64_t const x5 = a.at(5);
+			for (int k = 0; k < 5; ++k)
+				a.next();
+			assert_cgp_no_msg(a.next() == x5);
+		}
+
+		// bulk fill gives the same values as successive calls
+		{
+			random_stream a(5), b(5);
+			a.next(); b.next();
+			std::vector<float> values(37);
+			a.fill_uniform(values.data(), values.size(), -2.0f, 3.0f);
+			for (size_t k = 0; k < values.size(); ++k)
+				assert_cgp_no_msg(values[k] == b.uniform(-2.0f, 3.0f));
+			assert_cgp_no_msg(a.counter == b.counter);
+		}
+
+		// range and average of the distributions
+		{
+			random_stream a(11);
+			int const N = 100000;
+			double sum_uniform = 0, sum_normal = 0, sum_normal2 = 0;
+			for (int k = 0; k < N; ++k) {
+				float const u = a.uniform(1.0f, 3.0f);
+				assert_cgp_no_msg(u >= 1.0f && u < 3.0f);
+				sum_uniform += u;
+
+				int const i = a.uniform_int(-2, 2);
+				assert_cgp_no_msg(i >= -2 && i <= 2);
+
+				float const g = a.normal();
+				sum_normal += g;
+				sum_normal2 += g * g;
+			}
+			assert_cgp_no_msg(std::abs(sum_uniform / N - 2.0) < 0.02);
+			assert_cgp_no_msg(std::abs(sum_normal / N) < 0.02);
+			assert_cgp_no_msg(std::abs(sum_normal2 / N - 1.0) < 0.02);
+		}
+
+		// upper bound excluded, even for the largest 24 bits value rounded up
+		{
+			uint64_t const top = ~uint64_t(0);
+			assert_cgp_no_msg(random_uniform_value(top, 0.5f, 1.5f) < 1.5f);
+			assert_cgp_no_msg(random_uniform_value(top, 0.0f, 1.0f) < 1.0f);
+			assert_cgp_no_msg(random_uniform_value(top, -3.0f, 100.0f) < 100.0f);
+			assert_cgp_no_msg(random_uniform_value(0, 0.5f, 1.5f) == 0.5f);
+		}
+
+		// thread stream follows the global seed
+		{
+			random_stream_set_seed(12);
+			uint64_t const x0 = random_stream_thread().next();
+			random_stream_set_seed(12);
+			assert_cgp_no_msg(random_stream_thread().next() == x0);
+		}
+	}
+}
@@ -0,0 +1,36 @@
+#include "model_matrix_cache.hpp"
+#include "cgp/06_mat/mat.hpp"
+
+#include <cstring>
+#include <type_traits>
+
+namespace cgp
+{
+	// The transforms are arrays of floats: comparing the bytes detects any change
+	//  (+0/-0 or NaN values are seen as different, which only triggers a recomputation)
+	template <typename T>
+	static bool is_same_bytes(T const& a, T const& b)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Transform compared by bytes must be trivially copyable");
+		return std::memcmp(&a, &b, sizeof(T)) == 0;
+	}
+
+	bool is_same_transform(affine_rts const& a, affine_rts const& b) { return is_same_bytes(a, b); }
+	bool is_same_transform(affine const& a, affine const& b) { return is_same_bytes(a, b); }
+	bool is_same_transform(mat4 const& a, mat4 const& b) { return is_same_bytes(a, b); }
+
+	bool model_matrix_cache::update(affine_rts const& hierarchy, mat4 const& supplementary, affine const& model)
+	{
+		if (valid && is_same_transform(hierarchy, hierarchy_used) && is_same_transform(model, model_used) && is_same_transform(supplementary, supplementary_used))
+			return false;
+
+		matrix = hierarchy.matrix() * supplementary * model.matrix();
+		normal_matrix = transpose(inverse(matrix.get_block_linear()));
+
+		hierarchy_used = hierarchy;
+		supplementary_used = supplementary;
+		model_used = model;
+		valid = true;
+		return true;
+	}
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "cgp/09_geometric_transformation/affine/affine_rts/affine_rts.hpp"
+#include "cgp/09_geometric_transformation/affine/affine/affine.hpp"
+
+namespace cgp
+{
+	/** Model matrix M = hierarchy * supplementary * model and its normal matrix, recomputed only when one of the transforms changes
+	* The transforms are compared with the values used for the last computation: they can still be modified directly (ex. drawable.model.translation = ...),
+	* and a transform that is not modified between two frames costs a comparison instead of three matrix builds, two products and an inverse. */
+	struct model_matrix_cache
+	{
+		/** Recompute the matrices if one of the transforms differs from the last call. Return true if they are recomputed. */
+		bool update(affine_rts const& hierarchy, mat4 const& supplementary, affine const& model);
+
+		mat4 matrix;         // hierarchy * supplementary * model
+		mat3 normal_matrix;  // transpose(inverse()) of the linear part of matrix: transform of the normals
+
+	private:
+		affine_rts hierarchy_used;
+		mat4 supplementary_used;
+		affine model_used;
+		bool valid = false;
+	};
+
+	/** Exact comparison of the values of two transforms (no tolerance: any change is detected) */
+	bool is_same_transform(affine_rts const& a, affine_rts const& b);
+	bool is_same_transform(affine const& a, affine const& b);
+	bool is_same_transform(mat4 const& a, mat4 const& b);
+}
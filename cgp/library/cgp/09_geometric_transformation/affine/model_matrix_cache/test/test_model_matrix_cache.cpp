@@ -0,0 +1,61 @@
+#include "test_model_matrix_cache.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/06_mat/mat.hpp"
+#include "../model_matrix_cache.hpp"
+
+using namespace cgp;
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	void test_model_matrix_cache()
+	{
+		// Same matrices as the direct computation, including a non-uniform scaling
+		{
+			affine_rts const hierarchy(rotation_transform::from_axis_angle({ 0,0,1 }, 0.3f), { 1,2,3 }, 2.0f);
+			mat4 const supplementary = mat4::build_identity();
+			affine const model(rotation_transform::from_axis_angle({ 1,0,0 }, 0.7f), { -1,0,4 }, 0.5f, { 1,2,3 });
+
+			model_matrix_cache cache;
+			bool const recomputed = cache.update(hierarchy, supplementary, model);
+			assert_cgp_no_msg(recomputed);
+
+			mat4 const M = hierarchy.matrix() * supplementary * model.matrix();
+			assert_cgp_no_msg(is_equal(cache.matrix, M));
+			assert_cgp_no_msg(is_equal(cache.normal_matrix, transpose(inverse(M.get_block_linear()))));
+
+			// A normal stays orthogonal to the transformed tangent
+			vec3 const t = { 1,1,0 }, n = { 1,-1,2 };
+			assert_cgp_no_msg(is_equal(dot(M.get_block_linear() * t, cache.normal_matrix * n), 0.0f));
+		}
+
+		// Recomputed only when one of the transforms changes
+		{
+			affine_rts hierarchy;
+			mat4 supplementary = mat4::build_identity();
+			affine model;
+
+			model_matrix_cache cache;
+			assert_cgp_no_msg(cache.update(hierarchy, supplementary, model));
+			assert_cgp_no_msg(!cache.update(hierarchy, supplementary, model));
+
+			model.translation = { 1,0,0 };
+			assert_cgp_no_msg(cache.update(hierarchy, supplementary, model));
+			assert_cgp_no_msg(is_equal(cache.matrix.col_w_vec3(), vec3{ 1,0,0 }));
+			assert_cgp_no_msg(!cache.update(hierarchy, supplementary, model));
+
+			hierarchy.scaling = 2.0f;
+			assert_cgp_no_msg(cache.update(hierarchy, supplementary, model));
+			assert_cgp_no_msg(is_equal(cache.matrix.col_w_vec3(), vec3{ 2,0,0 }));
+
+			supplementary(0, 3) = 1.0f;
+			assert_cgp_no_msg(cache.update(hierarchy, supplementary, model));
+			assert_cgp_no_msg(is_equal(cache.matrix.col_w_vec3(), vec3{ 4,0,0 }));
+			assert_cgp_no_msg(!cache.update(hierarchy, supplementary, model));
+		}
+	}
+}
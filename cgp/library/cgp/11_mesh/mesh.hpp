@@ -1,4 +1,6 @@
 #pragma once
 
 #include "mesh/mesh.hpp"
+#include "mesh_view/mesh_view.hpp"
 #include "primitive/primitive.hpp"
+#include "simplification/simplification.hpp"
@@ -0,0 +1,46 @@
+#include "mesh_view.hpp"
+
+#include <algorithm>
+
+namespace cgp
+{
+	template <typename T>
+	static T const* view_array(numarray<T> const& data, size_t count)
+	{
+		return size_t(data.size()) == count && count > 0 ? &data[0] : nullptr;
+	}
+
+	template <typename T>
+	static void copy_array(T const* data, int count, numarray<T>& target)
+	{
+		if (data != nullptr)
+			target.data.assign(data, data + count);
+	}
+
+	mesh_view mesh_view_of(mesh const& m)
+	{
+		size_t const N = m.position.size();
+		mesh_view view;
+		view.position = view_array(m.position, N);
+		view.normal = view_array(m.normal, N);
+		view.color = view_array(m.color, N);
+		view.uv = view_array(m.uv, N);
+		view.connectivity = view_array(m.connectivity, m.connectivity.size());
+		view.vertex_count = int(N);
+		view.triangle_count = int(m.connectivity.size());
+		if (N > 0)
+			m.get_bounding_box_position(view.p_min, view.p_max);
+		return view;
+	}
+
+	mesh to_mesh(mesh_view const& view)
+	{
+		mesh m;
+		copy_array(view.position, view.vertex_count, m.position);
+		copy_array(view.normal, view.vertex_count, m.normal);
+		copy_array(view.color, view.vertex_count, m.color);
+		copy_array(view.uv, view.vertex_count, m.uv);
+		copy_array(view.connectivity, view.triangle_count, m.connectivity);
+		return m;
+	}
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "cgp/11_mesh/mesh/mesh.hpp"
+
+namespace cgp
+{
+	/** Read-only view of the arrays of a mesh stored elsewhere (ex. a mesh structure, or a binary file mapped in memory)
+	* The per-vertex arrays have vertex_count elements, or are nullptr if absent. The view is valid as long as the viewed memory. */
+	struct mesh_view
+	{
+		vec3 const* position = nullptr;
+		vec3 const* normal = nullptr;
+		vec3 const* color = nullptr;
+		vec2 const* uv = nullptr;
+		uint3 const* connectivity = nullptr;
+		int vertex_count = 0;
+		int triangle_count = 0;
+
+		// Bounding box of the positions
+		vec3 p_min;
+		vec3 p_max;
+	};
+
+	/** View of the arrays of a mesh (its empty per-vertex arrays are absent from the view), with the bounding box of its positions */
+	mesh_view mesh_view_of(mesh const& m);
+
+	/** Copy of the viewed arrays in a mesh */
+	mesh to_mesh(mesh_view const& view);
+}
@@ -0,0 +1,391 @@
+#include "simplification.hpp"
+
+#include "cgp/01_base/base.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <queue>
+#include <tuple>
+
+namespace cgp
+{
+	namespace
+	{
+		// Symmetric 4x4 matrix Q such that error(p) = (p,1)^T Q (p,1) (10 coefficients)
+		struct quadric
+		{
+			double q[10] = {};
+
+			void add_plane(vec3 const& n, float d, float weight)
+			{
+				double const a = n.x, b = n.y, c = n.z, e = d;
+				double const v[10] = { a * a, a * b, a * c, a * e, b * b, b * c, b * e, c * c, c * e, e * e };
+				for (int k = 0; k < 10; ++k)
+					q[k] += weight * v[k];
+			}
+			quadric& operator+=(quadric const& other)
+			{
+				for (int k = 0; k < 10; ++k)
+					q[k] += other.q[k];
+				return *this;
+			}
+			double error(vec3 const& p) const
+			{
+				double const x = p.x, y = p.y, z = p.z;
+				return q[0] * x * x + 2 * q[1] * x * y + 2 * q[2] * x * z + 2 * q[3] * x
+					+ q[4] * y * y + 2 * q[5] * y * z + 2 * q[6] * y
+					+ q[7] * z * z + 2 * q[8] * z
+					+ q[9];
+			}
+		};
+
+		struct collapse_candidate
+		{
+			double cost;
+			int a, b;               // a moves onto b
+			unsigned int version_a, version_b;
+			bool operator>(collapse_candidate const& other) const { return cost > other.cost; }
+		};
+
+		// Half-edge collapses on the welded vertices (indices v), the triangles referring to the attributes (wedges w)
+		struct simplifier
+		{
+			std::vector<int> vertex_of;              // Welded vertex of each wedge
+			std::vector<uint3> face;                 // Wedges of each triangle
+			std::vector<bool> face_removed;
+			std::vector<std::vector<int> > faces_of; // Triangles around each vertex (removed ones are filtered lazily)
+			std::vector<vec3> position;
+			std::vector<quadric> Q;
+			std::vector<unsigned int> version;
+			std::vector<bool> vertex_removed;
+			int face_count = 0;
+			std::priority_queue<collapse_candidate, std::vector<collapse_candidate>, std::greater<collapse_candidate> > queue;
+
+			int vertex(int f, int i) const { return vertex_of[face[f][i]]; }
+
+			void live_faces(int v, std::vector<int>& faces)
+			{
+				std::vector<int>& list = faces_of[v];
+				list.erase(std::remove_if(list.begin(), list.end(), [this](int f) { return face_removed[f]; }), list.end());
+				faces = list;
+			}
+
+			void push(int a, int b)
+			{
+				quadric q = Q[a];
+				q += Q[b];
+				queue.push({ q.error(position[b]), a, b, version[a], version[b] });
+			}
+
+			bool collapse(int a, int b)
+			{
+				std::vector<int> faces_a, faces_b;
+				live_faces(a, faces_a);
+				live_faces(b, faces_b);
+
+				// Triangles removed by the collapse, and wedge of b replacing each wedge of a
+				std::vector<int> shared;
+				std::vector<std::pair<unsigned int, unsigned int> > wedge_map;
+				for (int f : faces_a) {
+					int ia = -1, ib = -1;
+					for (int i = 0; i < 3; ++i) {
+						if (vertex(f, i) == a) ia = i;
+						if (vertex(f, i) == b) ib = i;
+					}
+					if (ib < 0)
+						continue;
+					shared.push_back(f);
+					unsigned int const wa = face[f][ia], wb = face[f][ib];
+					bool found = false;
+					for (auto const& m : wedge_map) {
+						if (m.first == wa) {
+							if (m.second != wb)
+								return false; // One side of a seam would be merged with the other side
+							found = true;
+						}
+					}
+					if (!found)
+						wedge_map.push_back({ wa, wb });
+				}
+				if (shared.empty())
+					return false;
+
+				// Every wedge of a must have a replacement: a seam vertex only moves along its seam
+				for (int f : faces_a) {
+					for (int i = 0; i < 3; ++i) {
+						if (vertex(f, i) != a)
+							continue;
+						unsigned int const wa = face[f][i];
+						if (std::find_if(wedge_map.begin(), wedge_map.end(), [wa](std::pair<unsigned int, unsigned int> const& m) { return m.first == wa; }) == wedge_map.end())
+							return false;
+					}
+				}
+
+				// Edges around a: a border vertex only moves along the border, non-manifold edges are kept
+				std::vector<std::pair<int, int> > edge_count; // (neighbor, number of triangles)
+				for (int f : faces_a) {
+					for (int i = 0; i < 3; ++i) {
+						int const x = vertex(f, i);
+						if (x == a)
+							continue;
+						auto it = std::find_if(edge_count.begin(), edge_count.end(), [x](std::pair<int, int> const& e) { return e.first == x; });
+						if (it == edge_count.end())
+							edge_count.push_back({ x, 1 });
+						else
+							it->second++;
+					}
+				}
+				bool border = false;
+				int count_ab = 0;
+				for (auto const& e : edge_count) {
+					if (e.second > 2)
+						return false;
+					border = border || e.second == 1;
+					if (e.first == b)
+						count_ab = e.second;
+				}
+				if (border && count_ab != 1)
+					return false;
+
+				// Link condition: the common neighbors of a and b are the opposite vertices of the removed triangles
+				int common = 0;
+				for (auto const& e : edge_count) {
+					if (e.first == b)
+						continue;
+					for (int f : faces_b) {
+						if (vertex(f, 0) == e.first || vertex(f, 1) == e.first || vertex(f, 2) == e.first) {
+							common++;
+							break;
+						}
+					}
+				}
+				if (common > int(shared.size()))
+					return false;
+
+				// No triangle flip
+				for (int f : faces_a) {
+					if (std::find(shared.begin(), shared.end(), f) != shared.end())
+						continue;
+					vec3 p[3], q[3];
+					for (int i = 0; i < 3; ++i) {
+						p[i] = position[vertex(f, i)];
+						q[i] = vertex(f, i) == a ? position[b] : p[i];
+					}
+					vec3 const n_before = cross(p[1] - p[0], p[2] - p[0]);
+					vec3 const n_after = cross(q[1] - q[0], q[2] - q[0]);
+					if (dot(n_before, n_after) <= 0)
+						return false;
+				}
+
+				// Apply the collapse
+				for (int f : shared) {
+					face_removed[f] = true;
+					face_count--;
+				}
+				for (int f : faces_a) {
+					if (face_removed[f])
+						continue;
+					for (int i = 0; i < 3; ++i) {
+						if (vertex(f, i) != a)
+							continue;
+						unsigned int const wa = face[f][i];
+						for (auto const& m : wedge_map)
+							if (m.first == wa)
+								face[f][i] = m.second;
+					}
+					faces_of[b].push_back(f);
+				}
+				vertex_removed[a] = true;
+				faces_of[a].clear();
+				Q[b] += Q[a];
+				version[a]++;
+				version[b]++;
+
+				std::vector<int> faces;
+				live_faces(b, faces);
+				for (int f : faces) {
+					for (int i = 0; i < 3; ++i) {
+						int const x = vertex(f, i);
+						if (x != b) {
+							push(b, x);
+							push(x, b);
+						}
+					}
+				}
+				return true;
+			}
+		};
+
+		// Index of the first element of each group of equal elements, for every element
+		template <typename KEY>
+		std::vector<int> group_equal(int N, KEY const& key)
+		{
+			std::vector<int> order(N);
+			for (int k = 0; k < N; ++k)
+				order[k] = k;
+			std::sort(order.begin(), order.end(), [&key](int i, int j) { return key(i) < key(j); });
+			std::vector<int> group(N);
+			for (int k = 0; k < N; ++k)
+				group[order[k]] = (k > 0 && key(order[k]) == key(order[k - 1])) ? group[order[k - 1]] : order[k];
+			return group;
+		}
+	}
+
+	mesh mesh_simplify(mesh const& m, int target_triangle_count, float max_error)
+	{
+		int const N_wedge = int(m.position.size());
+		int const N_face = int(m.connectivity.size());
+		if (N_face <= target_triangle_count)
+			return m;
+
+		bool const has_normal = int(m.normal.size()) == N_wedge;
+		bool const has_color = int(m.color.size()) == N_wedge;
+		bool const has_uv = int(m.uv.size()) == N_wedge;
+
+		// Merge the identical vertices (same position and attributes), then weld the vertices at the same position
+		auto const attributes = [&](int k) {
+			vec3 const n = has_normal ? m.normal[k] : vec3();
+			vec3 const c = has_color ? m.color[k] : vec3();
+			vec2 const t = has_uv ? m.uv[k] : vec2();
+			return std::make_tuple(m.position[k].x, m.position[k].y, m.position[k].z, t.x, t.y, n.x, n.y, n.z, c.x, c.y, c.z);
+		};
+		std::vector<int> const wedge = group_equal(N_wedge, attributes);
+		std::vector<int> const weld = group_equal(N_wedge, [&m](int k) { return std::make_tuple(m.position[k].x, m.position[k].y, m.position[k].z); });
+
+		simplifier s;
+		std::vector<int> vertex_index(N_wedge, -1);
+		s.vertex_of.resize(N_wedge);
+		for (int k = 0; k < N_wedge; ++k) {
+			int const w = weld[k];
+			if (vertex_index[w] < 0) {
+				vertex_index[w] = int(s.position.size());
+				s.position.push_back(m.position[w]);
+			}
+			s.vertex_of[k] = vertex_index[w];
+		}
+		int const N_vertex = int(s.position.size());
+		s.faces_of.resize(N_vertex);
+		s.Q.resize(N_vertex);
+		s.version.assign(N_vertex, 0);
+		s.vertex_removed.assign(N_vertex, false);
+
+		for (int f = 0; f < N_face; ++f) {
+			uint3 const& tri = m.connectivity[f];
+			uint3 const w = { unsigned(wedge[tri[0]]), unsigned(wedge[tri[1]]), unsigned(wedge[tri[2]]) };
+			int const v0 = s.vertex_of[w[0]], v1 = s.vertex_of[w[1]], v2 = s.vertex_of[w[2]];
+			if (v0 == v1 || v1 == v2 || v2 == v0)
+				continue; // Degenerate triangle
+			int const index = int(s.face.size());
+			s.face.push_back(w);
+			s.face_removed.push_back(false);
+			s.faces_of[v0].push_back(index);
+			s.faces_of[v1].push_back(index);
+			s.faces_of[v2].push_back(index);
+
+			vec3 const n = cross(s.position[v1] - s.position[v0], s.position[v2] - s.position[v0]);
+			float const area2 = norm(n);
+			if (area2 > 0) {
+				vec3 const u = n / area2;
+				float const d = -dot(u, s.position[v0]);
+				s.Q[v0].add_plane(u, d, area2 / 2);
+				s.Q[v1].add_plane(u, d, area2 / 2);
+				s.Q[v2].add_plane(u, d, area2 / 2);
+			}
+		}
+		s.face_count = int(s.face.size());
+
+		// Borders and seams: planes orthogonal to the triangles along their edges, so that moving a vertex out of the line of the border/seam has a cost
+		struct edge_record { int v0, v1, f; unsigned int w0, w1; };
+		std::vector<edge_record> edges;
+		for (int f = 0; f < int(s.face.size()); ++f) {
+			for (int i = 0; i < 3; ++i) {
+				int const j = (i + 1) % 3;
+				edge_record e = { s.vertex(f, i), s.vertex(f, j), f, s.face[f][i], s.face[f][j] };
+				if (e.v0 > e.v1) {
+					std::swap(e.v0, e.v1);
+					std::swap(e.w0, e.w1);
+				}
+				edges.push_back(e);
+			}
+		}
+		std::sort(edges.begin(), edges.end(), [](edge_record const& e0, edge_record const& e1) { return std::make_pair(e0.v0, e0.v1) < std::make_pair(e1.v0, e1.v1); });
+		float const constraint_weight = 1000.0f;
+		for (size_t k = 0; k < edges.size();) {
+			size_t end = k + 1;
+			while (end < edges.size() && edges[end].v0 == edges[k].v0 && edges[end].v1 == edges[k].v1)
+				end++;
+			bool const border = end - k == 1;
+			bool const seam = end - k == 2 && (edges[k].w0 != edges[k + 1].w0 || edges[k].w1 != edges[k + 1].w1);
+			if (border || seam) {
+				edge_record const& e = edges[k];
+				vec3 const& p0 = s.position[e.v0];
+				vec3 const edge = s.position[e.v1] - p0;
+				vec3 const n_face = cross(s.position[s.vertex(e.f, 1)] - s.position[s.vertex(e.f, 0)], s.position[s.vertex(e.f, 2)] - s.position[s.vertex(e.f, 0)]);
+				vec3 const n = cross(edge, n_face);
+				float const n_norm = norm(n);
+				if (n_norm > 0) {
+					vec3 const u = n / n_norm;
+					float const d = -dot(u, p0);
+					float const weight = constraint_weight * dot(edge, edge);
+					s.Q[e.v0].add_plane(u, d, weight);
+					s.Q[e.v1].add_plane(u, d, weight);
+				}
+			}
+			k = end;
+		}
+
+		for (int f = 0; f < int(s.face.size()); ++f) {
+			for (int i = 0; i < 3; ++i) {
+				s.push(s.vertex(f, i), s.vertex(f, (i + 1) % 3));
+				s.push(s.vertex(f, (i + 1) % 3), s.vertex(f, i));
+			}
+		}
+
+		while (s.face_count > target_triangle_count && !s.queue.empty()) {
+			collapse_candidate const c = s.queue.top();
+			s.queue.pop();
+			if (s.vertex_removed[c.a] || s.vertex_removed[c.b] || c.version_a != s.version[c.a] || c.version_b != s.version[c.b])
+				continue; // Outdated candidate
+			if (c.cost > max_error)
+				break;
+			s.collapse(c.a, c.b);
+		}
+
+		// Result with the wedges still used
+		mesh result;
+		std::vector<int> new_index(N_wedge, -1);
+		for (int f = 0; f < int(s.face.size()); ++f) {
+			if (s.face_removed[f])
+				continue;
+			uint3 tri;
+			for (int i = 0; i < 3; ++i) {
+				int const w = s.face[f][i];
+				if (new_index[w] < 0) {
+					new_index[w] = int(result.position.size());
+					result.position.push_back(m.position[w]);
+					if (has_normal) result.normal.push_back(m.normal[w]);
+					if (has_color) result.color.push_back(m.color[w]);
+					if (has_uv) result.uv.push_back(m.uv[w]);
+				}
+				tri[i] = new_index[w];
+			}
+			result.connectivity.push_back(tri);
+		}
+		return result;
+	}
+
+	std::vector<mesh> mesh_lod_chain(mesh const& m, int level_count, float reduction)
+	{
+		assert_cgp(reduction > 0 && reduction < 1, "The reduction between two levels of detail must be in ]0,1[ (reduction=" + str(reduction) + ")");
+		std::vector<mesh> chain = { m };
+		for (int k = 1; k < level_count; ++k) {
+			mesh const& previous = chain.back();
+			int const target = std::max(int(previous.connectivity.size() * reduction), 4);
+			mesh level = mesh_simplify(previous, target);
+			if (level.connectivity.size() >= previous.connectivity.size())
+				break;
+			chain.push_back(level);
+		}
+		return chain;
+	}
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "cgp/11_mesh/mesh/mesh.hpp"
+
+#include <limits>
+#include <vector>
+
+namespace cgp
+{
+	/** Simplify a mesh down to target_triangle_count triangles by edge collapses ordered by the quadric error metric (Garland-Heckbert)
+	* - Identical vertices are merged, and vertices at the same position are welded to get the connectivity (meshes loaded from OBJ files are split where the uv or the normals are discontinuous).
+	* - A collapse moves a vertex onto one of its neighbors (half-edge collapse): the remaining vertices keep their position, normal, color and uv.
+	* - A vertex on a seam (several uv or normals at the same position) only moves along the seam, each side keeping its own uv. A vertex on a border only moves along the border.
+	* - Collapses flipping a triangle or making the surface non-manifold are refused: the result can have more triangles than the target.
+	* - max_error: largest quadric error (sum of squared distances to the planes of the initial triangles, weighted by their area) of a collapse
+	* The unused vertices are removed from the result. */
+	mesh mesh_simplify(mesh const& m, int target_triangle_count, float max_error = std::numeric_limits<float>::max());
+
+	/** Levels of detail of a mesh: chain[0] is the mesh itself, chain[k] is chain[k-1] simplified to reduction times its number of triangles
+	* The chain stops before level_count if a level cannot be simplified anymore. */
+	std::vector<mesh> mesh_lod_chain(mesh const& m, int level_count = 4, float reduction = 0.25f);
+}
@@ -0,0 +1,60 @@
+#include "test_simplification.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/11_mesh/primitive/primitive.hpp"
+#include "../simplification.hpp"
+
+#include <cmath>
+
+using namespace cgp;
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	void test_simplification()
+	{
+		// Flat grid: the border is kept, the inside collapses at no cost
+		{
+			mesh const grid = mesh_primitive_grid({ 0,0,0 }, { 1,0,0 }, { 1,1,0 }, { 0,1,0 }, 20, 20);
+			mesh const simplified = mesh_simplify(grid, 100);
+			assert_cgp_no_msg(simplified.connectivity.size() <= 100);
+			assert_cgp_no_msg(simplified.position.size() == simplified.uv.size() && simplified.position.size() == simplified.normal.size());
+
+			vec3 p_min, p_max;
+			simplified.get_bounding_box_position(p_min, p_max);
+			assert_cgp_no_msg(norm(p_min - vec3(0, 0, 0)) < 1e-5f && norm(p_max - vec3(1, 1, 0)) < 1e-5f);
+
+			float area = 0;
+			for (uint3 const& f : simplified.connectivity) {
+				vec3 const n = cross(simplified.position[f[1]] - simplified.position[f[0]], simplified.position[f[2]] - simplified.position[f[0]]);
+				area += norm(n) / 2;
+				assert_cgp_no_msg(n.z > 0); // No flipped triangle
+			}
+			assert_cgp_no_msg(std::abs(area - 1.0f) < 1e-4f);
+		}
+
+		// Sphere with a uv seam (duplicated vertices at u=0 and u=1): no triangle joins the two sides of the seam
+		{
+			mesh const sphere = mesh_primitive_sphere(1.0f, { 0,0,0 }, 40, 20);
+			mesh const simplified = mesh_simplify(sphere, 200);
+			assert_cgp_no_msg(simplified.connectivity.size() < sphere.connectivity.size() / 2);
+			for (uint3 const& f : simplified.connectivity) {
+				float const u0 = simplified.uv[f[0]].x, u1 = simplified.uv[f[1]].x, u2 = simplified.uv[f[2]].x;
+				assert_cgp_no_msg(std::abs(u0 - u1) < 0.5f && std::abs(u1 - u2) < 0.5f && std::abs(u2 - u0) < 0.5f);
+			}
+		}
+
+		// Chain of levels of detail
+		{
+			mesh const sphere = mesh_primitive_sphere(1.0f, { 0,0,0 }, 40, 20);
+			std::vector<mesh> const chain = mesh_lod_chain(sphere, 3, 0.25f);
+			assert_cgp_no_msg(chain.size() == 3);
+			assert_cgp_no_msg(chain[0].connectivity.size() == sphere.connectivity.size());
+			assert_cgp_no_msg(chain[1].connectivity.size() < chain[0].connectivity.size());
+			assert_cgp_no_msg(chain[2].connectivity.size() < chain[1].connectivity.size());
+		}
+	}
+}
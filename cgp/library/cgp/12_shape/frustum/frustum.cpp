@@ -0,0 +1,105 @@
+#include "frustum.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cgp
+{
+	frustum frustum::from_matrix(mat4 const& M)
+	{
+		// Gribb-Hartmann extraction: the plane equations are sums and differences of the rows of the clip matrix
+		vec4 const& r0 = M.row_x();
+		vec4 const& r1 = M.row_y();
+		vec4 const& r2 = M.row_z();
+		vec4 const& r3 = M.row_w();
+
+		frustum f;
+		f.plane[0] = r3 + r0; // left
+		f.plane[1] = r3 - r0; // right
+		f.plane[2] = r3 + r1; // bottom
+		f.plane[3] = r3 - r1; // top
+		f.plane[4] = r3 + r2; // near
+		f.plane[5] = r3 - r2; // far
+		for (int k = 0; k < 6; ++k) {
+			float const n = std::sqrt(f.plane[k].x * f.plane[k].x + f.plane[k].y * f.plane[k].y + f.plane[k].z * f.plane[k].z);
+			if (n > 0)
+				f.plane[k] /= n;
+		}
+		return f;
+	}
+
+	frustum frustum::from_matrix(mat4 const& projection, mat4 const& view)
+	{
+		return from_matrix(projection * view);
+	}
+
+	bool frustum::is_visible(vec3 const& center, float radius) const
+	{
+		for (int k = 0; k < 6; ++k) {
+			vec4 const& P = plane[k];
+			if (P.x * center.x + P.y * center.y + P.z * center.z + P.w < -radius)
+				return false;
+		}
+		return true;
+	}
+
+	bool frustum::is_visible(bounding_box const& box) const
+	{
+		for (int k = 0; k < 6; ++k) {
+			vec4 const& P = plane[k];
+			// Corner of the box the farthest along the normal: if it is outside, the whole box is outside
+			float const x = P.x >= 0 ? box.p_max.x : box.p_min.x;
+			float const y = P.y >= 0 ? box.p_max.y : box.p_min.y;
+			float const z = P.z >= 0 ? box.p_max.z : box.p_min.z;
+			if (P.x * x + P.y * y + P.z * z + P.w < 0)
+				return false;
+		}
+		return true;
+	}
+
+	int frustum::cull_spheres(vec4 const* spheres, int count, unsigned char* visible) const
+	{
+		// Plane coefficients copied in local variables: the compiler keeps them in registers
+		float a[6], b[6], c[6], d[6];
+		for (int k = 0; k < 6; ++k) {
+			a[k] = plane[k].x; b[k] = plane[k].y; c[k] = plane[k].z; d[k] = plane[k].w;
+		}
+
+		int visible_count = 0;
+		for (int i = 0; i < count; ++i) {
+			vec4 const& s = spheres[i];
+			float distance = a[0] * s.x + b[0] * s.y + c[0] * s.z + d[0];
+			for (int k = 1; k < 6; ++k)
+				distance = std::min(distance, a[k] * s.x + b[k] * s.y + c[k] * s.z + d[k]);
+			unsigned char const v = distance >= -s.w;
+			visible[i] = v;
+			visible_count += v;
+		}
+		return visible_count;
+	}
+
+	bounding_box transform_bounding_box(mat4 const& M, bounding_box const& box)
+	{
+		// Center and half extent of the box: the extent of the result is |L| * extent (L: linear part of M)
+		vec3 const center = (box.p_min + box.p_max) / 2.0f;
+		vec3 const extent = (box.p_max - box.p_min) / 2.0f;
+		vec3 const c = (M * vec4(center, 1.0f)).xyz();
+		vec3 e;
+		for (int i = 0; i < 3; ++i)
+			e[i] = std::abs(M(i, 0)) * extent.x + std::abs(M(i, 1)) * extent.y + std::abs(M(i, 2)) * extent.z;
+
+		bounding_box result;
+		result.p_min = c - e;
+		result.p_max = c + e;
+		return result;
+	}
+
+	vec4 transform_bounding_sphere(mat4 const& M, vec4 const& sphere)
+	{
+		vec3 const c = (M * vec4(sphere.x, sphere.y, sphere.z, 1.0f)).xyz();
+		float scaling2 = 0;
+		for (int j = 0; j < 3; ++j)
+			scaling2 = std::max(scaling2, M(0, j) * M(0, j) + M(1, j) * M(1, j) + M(2, j) * M(2, j));
+		return vec4(c, sphere.w * std::sqrt(scaling2));
+	}
+}
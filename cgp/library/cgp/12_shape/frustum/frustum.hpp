@@ -0,0 +1,32 @@
+#pragma once
+
+#include "cgp/06_mat/mat.hpp"
+#include "cgp/12_shape/bounding_box/bounding_box.hpp"
+
+namespace cgp
+{
+	/** Volume seen by a camera, bounded by 6 planes (left, right, bottom, top, near, far)
+	* Each plane is stored as (nx, ny, nz, d) with a unit normal pointing inside: the signed distance of p to the plane is dot(n,p)+d.
+	* The tests are conservative: an object reported as not visible is entirely outside, an object reported as visible may still be outside (near the corners). */
+	struct frustum
+	{
+		vec4 plane[6];
+
+		/** Planes of the clip space of projection_view = projection * view (OpenGL convention: -w <= x,y,z <= w) */
+		static frustum from_matrix(mat4 const& projection_view);
+		static frustum from_matrix(mat4 const& projection, mat4 const& view);
+
+		bool is_visible(vec3 const& center, float radius) const;
+		bool is_visible(bounding_box const& box) const;
+
+		/** Batch test of count spheres (center xyz, radius w): visible[k] = 1 if the sphere k intersects the frustum, 0 otherwise. Return the number of visible spheres.
+		* The loop has no branch (min of the 6 distances): it is vectorized by the compiler. */
+		int cull_spheres(vec4 const* spheres, int count, unsigned char* visible) const;
+	};
+
+	/** Box containing the box transformed by the affine matrix M (used to express the bounding box of a shape in world coordinates) */
+	bounding_box transform_bounding_box(mat4 const& M, bounding_box const& box);
+
+	/** Sphere (center xyz, radius w) containing the sphere transformed by the affine matrix M (the radius is scaled by the largest scaling of M) */
+	vec4 transform_bounding_sphere(mat4 const& M, vec4 const& sphere);
+}
@@ -0,0 +1,88 @@
+#include "test_frustum.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/10_camera_model/camera_projection/camera_projection.hpp"
+#include "../frustum.hpp"
+
+using namespace cgp;
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	void test_frustum()
+	{
+		// Camera at the origin looking toward -z, field of view of 90 degrees, depth in [0.1, 100]
+		camera_projection_perspective projection;
+		projection.field_of_view = Pi / 2;
+		projection.aspect_ratio = 1.0f;
+		projection.depth_min = 0.1f;
+		projection.depth_max = 100.0f;
+		frustum const f = frustum::from_matrix(projection.matrix(), mat4::build_identity());
+
+		// Spheres
+		{
+			assert_cgp_no_msg(f.is_visible(vec3{ 0,0,-10 }, 1.0f));
+			assert_cgp_no_msg(!f.is_visible(vec3{ 0,0,10 }, 1.0f));     // behind the camera
+			assert_cgp_no_msg(!f.is_visible(vec3{ 0,0,-200 }, 1.0f));   // beyond the far plane
+			assert_cgp_no_msg(!f.is_visible(vec3{ 20,0,-10 }, 1.0f));   // on the right (|x| > |z| with a fov of 90 degrees)
+			assert_cgp_no_msg(f.is_visible(vec3{ 20,0,-10 }, 8.0f));    // ... but large enough to reach the frustum
+			assert_cgp_no_msg(f.is_visible(vec3{ 0,9,-10 }, 0.1f));
+			assert_cgp_no_msg(!f.is_visible(vec3{ 0,-12,-10 }, 0.1f));
+		}
+
+		// Boxes
+		{
+			bounding_box box;
+			box.p_min = { -1,-1,-11 }; box.p_max = { 1,1,-9 };
+			assert_cgp_no_msg(f.is_visible(box));
+			box.p_min = { -1,-1,5 }; box.p_max = { 1,1,6 };
+			assert_cgp_no_msg(!f.is_visible(box));
+			box.p_min = { -1,-1,-1 }; box.p_max = { 1,1,1 }; // contains the camera
+			assert_cgp_no_msg(f.is_visible(box));
+
+			// Box moved in front of the camera by a transform
+			box.p_min = { -1,-1,-1 }; box.p_max = { 1,1,1 };
+			mat4 M = mat4::build_identity();
+			M(2, 3) = 20.0f;
+			assert_cgp_no_msg(!f.is_visible(transform_bounding_box(M, box)));
+			M(2, 3) = -20.0f;
+			assert_cgp_no_msg(f.is_visible(transform_bounding_box(M, box)));
+
+			// Rotation of 45 degrees around z: the extent along x and y grows to sqrt(2)
+			M = mat4::build_identity();
+			float const c = std::cos(Pi / 4);
+			M(0, 0) = c; M(0, 1) = -c; M(1, 0) = c; M(1, 1) = c;
+			bounding_box const rotated = transform_bounding_box(M, box);
+			assert_cgp_no_msg(is_equal(rotated.p_max, vec3{ std::sqrt(2.0f), std::sqrt(2.0f), 1.0f }));
+		}
+
+		// Batch test gives the same result as the individual tests
+		{
+			numarray<vec4> spheres;
+			for (int k = 0; k < 101; ++k)
+				spheres.push_back(vec4(float(k % 21 - 10) * 3.0f, float(k % 7 - 3), float(k % 13 - 9) * 4.0f, 0.5f * float(k % 3)));
+			std::vector<unsigned char> visible(spheres.size());
+			int const count = f.cull_spheres(spheres.data.data(), int(spheres.size()), visible.data());
+
+			int expected_count = 0;
+			for (int k = 0; k < int(spheres.size()); ++k) {
+				bool const v = f.is_visible(spheres[k].xyz(), spheres[k].w);
+				assert_cgp_no_msg(v == (visible[k] == 1));
+				expected_count += v;
+			}
+			assert_cgp_no_msg(count == expected_count);
+			assert_cgp_no_msg(count > 0 && count < int(spheres.size()));
+		}
+
+		// Bounding sphere under scaling: radius scaled by the largest axis
+		{
+			mat4 M = mat4::build_identity();
+			M(0, 0) = 2.0f; M(1, 1) = 3.0f; M(0, 3) = 1.0f;
+			vec4 const s = transform_bounding_sphere(M, vec4(1, 0, 0, 1));
+			assert_cgp_no_msg(is_equal(s, vec4(3, 0, 0, 3)));
+		}
+	}
+}
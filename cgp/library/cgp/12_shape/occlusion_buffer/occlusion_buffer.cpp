@@ -0,0 +1,243 @@
+#include "occlusion_buffer.hpp"
+
+#include "cgp/01_base/base.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cgp
+{
+	void occlusion_buffer::initialize(int width_arg, int height_arg)
+	{
+		assert_cgp(width_arg > 0 && height_arg > 0, "Incorrect size of occlusion buffer (" + str(width_arg) + "x" + str(height_arg) + ")");
+		tile_count_x = (width_arg + tile_size - 1) / tile_size;
+		tile_count_y = (height_arg + tile_size - 1) / tile_size;
+		width = tile_count_x * tile_size;
+		height = tile_count_y * tile_size;
+		depth.assign(width * height, 1.0f);
+		tile_max.assign(tile_count_x * tile_count_y, 1.0f);
+		projection_view = mat4::build_identity();
+	}
+
+	void occlusion_buffer::clear(mat4 const& projection_view_arg)
+	{
+		assert_cgp(width > 0, "Call initialize before using the occlusion buffer");
+		projection_view = projection_view_arg;
+		std::fill(depth.begin(), depth.end(), 1.0f);
+		std::fill(tile_max.begin(), tile_max.end(), 1.0f);
+		clip_vertices.clear();
+		triangles.clear();
+	}
+
+	void occlusion_buffer::add_occluder(numarray<vec3> const& position, numarray<uint3> const& connectivity, mat4 const& model)
+	{
+		mat4 const M = projection_view * model;
+		std::vector<vec4> clip(position.size());
+		for (size_t k = 0; k < position.size(); ++k)
+			clip[k] = M * vec4(position[k], 1.0f);
+
+		for (uint3 const& f : connectivity) {
+			clip_vertices.push_back(clip[f[0]]);
+			clip_vertices.push_back(clip[f[1]]);
+			clip_vertices.push_back(clip[f[2]]);
+		}
+	}
+
+	void occlusion_buffer::add_occluder(mesh const& m, mat4 const& model)
+	{
+		add_occluder(m.position, m.connectivity, model);
+	}
+
+	void occlusion_buffer::setup_triangle(vec4 const& c0, vec4 const& c1, vec4 const& c2)
+	{
+		// Window coordinates (x,y in pixels, depth in [0,1])
+		vec3 p[3];
+		vec4 const* c[3] = { &c0, &c1, &c2 };
+		for (int k = 0; k < 3; ++k) {
+			float const inv_w = 1.0f / c[k]->w;
+			p[k] = { (c[k]->x * inv_w * 0.5f + 0.5f) * width, (c[k]->y * inv_w * 0.5f + 0.5f) * height, c[k]->z * inv_w * 0.5f + 0.5f };
+		}
+
+		float area = (p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[2].x - p[0].x) * (p[1].y - p[0].y);
+		if (std::abs(area) < 1e-8f)
+			return;
+		if (area < 0) { // Both faces are drawn: counter-clockwise order for the edge functions
+			std::swap(p[1], p[2]);
+			area = -area;
+		}
+
+		triangle_setup t;
+		t.x_min = std::max(int(std::floor(std::min({ p[0].x, p[1].x, p[2].x }))), 0);
+		t.x_max = std::min(int(std::floor(std::max({ p[0].x, p[1].x, p[2].x }))), width - 1);
+		t.y_min = std::max(int(std::floor(std::min({ p[0].y, p[1].y, p[2].y }))), 0);
+		t.y_max = std::min(int(std::floor(std::max({ p[0].y, p[1].y, p[2].y }))), height - 1);
+		if (t.x_min > t.x_max || t.y_min > t.y_max || std::min({ p[0].z, p[1].z, p[2].z }) > 1.0f)
+			return;
+
+		// edge[k] is the edge opposite to the vertex k: edge[k](x,y)/area is the barycentric coordinate of the vertex k
+		for (int k = 0; k < 3; ++k) {
+			vec3 const& pi = p[(k + 1) % 3];
+			vec3 const& pj = p[(k + 2) % 3];
+			float const a = pi.y - pj.y;
+			float const b = pj.x - pi.x;
+			t.edge[k] = { a, b, -(a * pi.x + b * pi.y) };
+		}
+		vec3 const z = { p[0].z / area, p[1].z / area, p[2].z / area };
+		t.depth_plane = { dot(z, vec3(t.edge[0].x, t.edge[1].x, t.edge[2].x)), dot(z, vec3(t.edge[0].y, t.edge[1].y, t.edge[2].y)), dot(z, vec3(t.edge[0].z, t.edge[1].z, t.edge[2].z)) };
+		triangles.push_back(t);
+	}
+
+	void occlusion_buffer::rasterize(thread_pool& pool)
+	{
+		// Clip against the near plane (z >= -w): a triangle gives a polygon of up to 4 vertices, split in a fan
+		triangles.clear();
+		int const N = int(clip_vertices.size()) / 3;
+		for (int k = 0; k < N; ++k) {
+			vec4 const* v = &clip_vertices[3 * k];
+			float d[3];
+			int inside = 0;
+			for (int i = 0; i < 3; ++i) {
+				d[i] = v[i].z + v[i].w;
+				inside += d[i] >= 0 ? 1 : 0;
+			}
+			if (inside == 3) {
+				setup_triangle(v[0], v[1], v[2]);
+				continue;
+			}
+			if (inside == 0)
+				continue;
+
+			vec4 polygon[4];
+			int n = 0;
+			for (int i = 0; i < 3; ++i) {
+				int const j = (i + 1) % 3;
+				if (d[i] >= 0)
+					polygon[n++] = v[i];
+				if ((d[i] >= 0) != (d[j] >= 0))
+					polygon[n++] = v[i] + (d[i] / (d[i] - d[j])) * (v[j] - v[i]);
+			}
+			for (int i = 1; i + 1 < n; ++i)
+				setup_triangle(polygon[0], polygon[i], polygon[i + 1]);
+		}
+		clip_vertices.clear();
+
+		// Each band of tile_size rows is written by a single task
+		pool.parallel_for(0, tile_count_y, [this](int begin, int end) {
+			for (int ty = begin; ty < end; ++ty)
+				rasterize_band(ty);
+		}, 1);
+	}
+
+	void occlusion_buffer::rasterize_band(int ty)
+	{
+		int const band_min = ty * tile_size;
+		int const band_max = band_min + tile_size - 1;
+		for (triangle_setup const& t : triangles) {
+			int const y_min = std::max(t.y_min, band_min);
+			int const y_max = std::min(t.y_max, band_max);
+			int const count = t.x_max - t.x_min + 1;
+			for (int y = y_min; y <= y_max; ++y) {
+				// Values at the center of the first pixel of the row, incremented along x
+				float const px = t.x_min + 0.5f, py = y + 0.5f;
+				float const e0 = t.edge[0].x * px + t.edge[0].y * py + t.edge[0].z;
+				float const e1 = t.edge[1].x * px + t.edge[1].y * py + t.edge[1].z;
+				float const e2 = t.edge[2].x * px + t.edge[2].y * py + t.edge[2].z;
+				float const z = t.depth_plane.x * px + t.depth_plane.y * py + t.depth_plane.z;
+				float const a0 = t.edge[0].x, a1 = t.edge[1].x, a2 = t.edge[2].x, dz = t.depth_plane.x;
+
+				// No branch in the loop: it is vectorized by the compiler (comparisons and blend)
+				float* row = &depth[y * width + t.x_min];
+				for (int i = 0; i < count; ++i) {
+					float const fi = float(i);
+					bool const inside = (e0 + a0 * fi >= 0) & (e1 + a1 * fi >= 0) & (e2 + a2 * fi >= 0);
+					float const nearest = std::min(row[i], z + dz * fi);
+					row[i] = inside ? nearest : row[i];
+				}
+			}
+		}
+
+		for (int tx = 0; tx < tile_count_x; ++tx) {
+			float m = 0.0f;
+			for (int y = band_min; y <= band_max; ++y) {
+				float const* row = &depth[y * width + tx * tile_size];
+				for (int i = 0; i < tile_size; ++i)
+					m = std::max(m, row[i]);
+			}
+			tile_max[tx + tile_count_x * ty] = m;
+		}
+	}
+
+	bool occlusion_buffer::is_visible(bounding_box const& box) const
+	{
+		// Screen rectangle and nearest depth of the 8 corners
+		float x_min = float(width), x_max = 0, y_min = float(height), y_max = 0, z_min = 1.0f;
+		for (int k = 0; k < 8; ++k) {
+			vec3 const p = { (k & 1) ? box.p_max.x : box.p_min.x, (k & 2) ? box.p_max.y : box.p_min.y, (k & 4) ? box.p_max.z : box.p_min.z };
+			vec4 const c = projection_view * vec4(p, 1.0f);
+			if (c.z < -c.w) // In front of the near plane
+				return true;
+			float const inv_w = 1.0f / c.w;
+			float const x = (c.x * inv_w * 0.5f + 0.5f) * width;
+			float const y = (c.y * inv_w * 0.5f + 0.5f) * height;
+			x_min = std::min(x_min, x); x_max = std::max(x_max, x);
+			y_min = std::min(y_min, y); y_max = std::max(y_max, y);
+			z_min = std::min(z_min, c.z * inv_w * 0.5f + 0.5f);
+		}
+		if (x_max < 0 || y_max < 0 || x_min >= width || y_min >= height)
+			return true; // Outside of the screen: left to the frustum test
+
+		int const px_min = std::max(int(std::floor(x_min)), 0), px_max = std::min(int(std::floor(x_max)), width - 1);
+		int const py_min = std::max(int(std::floor(y_min)), 0), py_max = std::min(int(std::floor(y_max)), height - 1);
+		for (int ty = py_min / tile_size; ty <= py_max / tile_size; ++ty) {
+			for (int tx = px_min / tile_size; tx <= px_max / tile_size; ++tx) {
+				if (z_min > tile_max[tx + tile_count_x * ty])
+					continue; // The whole tile is in front of the box
+				int const x0 = std::max(px_min, tx * tile_size), x1 = std::min(px_max, tx * tile_size + tile_size - 1);
+				int const y0 = std::max(py_min, ty * tile_size), y1 = std::min(py_max, ty * tile_size + tile_size - 1);
+				for (int y = y0; y <= y1; ++y)
+					for (int x = x0; x <= x1; ++x)
+						if (z_min <= depth[y * width + x])
+							return true;
+			}
+		}
+		return false;
+	}
+
+	int occlusion_buffer::cull_boxes(bounding_box const* boxes, int count, unsigned char* visible) const
+	{
+		int visible_count = 0;
+		for (int k = 0; k < count; ++k) {
+			if (visible[k] && !is_visible(boxes[k]))
+				visible[k] = 0;
+			visible_count += visible[k] ? 1 : 0;
+		}
+		return visible_count;
+	}
+
+	int occlusion_buffer::triangle_count() const
+	{
+		return int(triangles.size());
+	}
+
+	grid_2D<vec3> occlusion_buffer::depth_image() const
+	{
+		float d_min = 1.0f, d_max = 0.0f;
+		for (float d : depth) {
+			if (d < 1.0f) {
+				d_min = std::min(d_min, d);
+				d_max = std::max(d_max, d);
+			}
+		}
+		float const range = d_max > d_min ? d_max - d_min : 1.0f;
+
+		grid_2D<vec3> im(width, height);
+		for (int y = 0; y < height; ++y) {
+			for (int x = 0; x < width; ++x) {
+				float const d = depth[y * width + x];
+				float const g = d < 1.0f ? 1.0f - 0.8f * (d - d_min) / range : 0.0f;
+				im(x, y) = { g, g, g };
+			}
+		}
+		return im;
+	}
+}
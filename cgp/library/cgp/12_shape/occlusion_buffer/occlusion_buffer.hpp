@@ -0,0 +1,72 @@
+#pragma once
+
+#include "cgp/01_base/thread_pool/thread_pool.hpp"
+#include "cgp/04_grid_container/grid_container.hpp"
+#include "cgp/06_mat/mat.hpp"
+#include "cgp/11_mesh/mesh.hpp"
+#include "cgp/12_shape/bounding_box/bounding_box.hpp"
+
+#include <vector>
+
+namespace cgp
+{
+	/** Low resolution depth buffer filled on the CPU by a few occluder meshes, used to skip the objects hidden behind them
+	* Usage at each frame: clear(projection*view), add_occluder(...) for each occluder, rasterize(), then is_visible / cull_boxes.
+	* - The depth is the window depth in [0,1] (1 = far plane, value after clear). Pixel (x,y) covers [x,x+1[ x [y,y+1[, y=0 at the bottom (OpenGL convention).
+	* - The triangles are rasterized in bands of tile_size rows on the threads of the pool, each band storing the largest depth of its tiles (hierarchical level).
+	* - The occluders should be inside the drawn meshes (ex. simplified meshes, or a surface below the terrain): an object is reported as hidden when it is behind them.
+	*   The test is exact at the pixel scale only: an object seen through a gap smaller than a pixel of the buffer can be reported as hidden.
+	* No OpenGL call: the buffer can be filled and tested without a window. */
+	struct occlusion_buffer
+	{
+		static int const tile_size = 8;
+
+		int width = 0;
+		int height = 0;
+		std::vector<float> depth;    // Depth of each pixel (x + width*y)
+		std::vector<float> tile_max; // Largest depth of each tile of tile_size x tile_size pixels (tx + tile_count_x*ty)
+		int tile_count_x = 0;
+		int tile_count_y = 0;
+
+		/** Buffer of width x height pixels (rounded up to a multiple of tile_size) */
+		void initialize(int width, int height);
+
+		/** Reset the depth to the far plane and set the matrix of the camera used by the next occluders and tests */
+		void clear(mat4 const& projection_view);
+
+		/** Transform and queue the triangles of an occluder (positions in local coordinates, placed by model) */
+		void add_occluder(numarray<vec3> const& position, numarray<uint3> const& connectivity, mat4 const& model = mat4::build_identity());
+		void add_occluder(mesh const& m, mat4 const& model = mat4::build_identity());
+
+		/** Rasterize the queued triangles and update tile_max */
+		void rasterize(thread_pool& pool = thread_pool_default());
+
+		/** False if the box (world coordinates) is entirely behind the occluders. A box crossing the near plane or outside of the screen is visible. */
+		bool is_visible(bounding_box const& box) const;
+
+		/** Batch test: visible[k] is set to 0 for the boxes hidden behind the occluders (the boxes with visible[k]=0 are not tested). Return the number of visible boxes. */
+		int cull_boxes(bounding_box const* boxes, int count, unsigned char* visible) const;
+
+		/** Number of triangles rasterized by the last call to rasterize() (after clipping) */
+		int triangle_count() const;
+
+		/** Gray level image of the depth for debug display: white for the nearest depth, dark for the farthest written depth, black where no occluder is drawn */
+		grid_2D<vec3> depth_image() const;
+
+	private:
+		// Triangle after projection: edge functions (a*x + b*y + c >= 0 inside), depth plane, and pixel bounds
+		struct triangle_setup
+		{
+			vec3 edge[3];
+			vec3 depth_plane; // depth = x*px + y*py + z
+			int x_min, x_max, y_min, y_max;
+		};
+
+		mat4 projection_view;
+		std::vector<vec4> clip_vertices; // Clip coordinates of the queued triangles (3 consecutive vertices per triangle)
+		std::vector<triangle_setup> triangles;
+
+		void setup_triangle(vec4 const& p0, vec4 const& p1, vec4 const& p2);
+		void rasterize_band(int ty);
+	};
+}
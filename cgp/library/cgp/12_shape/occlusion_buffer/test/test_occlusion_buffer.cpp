@@ -0,0 +1,82 @@
+#include "test_occlusion_buffer.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/10_camera_model/camera_projection/camera_projection.hpp"
+#include "cgp/11_mesh/primitive/primitive.hpp"
+#include "../occlusion_buffer.hpp"
+
+using namespace cgp;
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	static bounding_box box(vec3 const& p_min, vec3 const& p_max)
+	{
+		bounding_box b;
+		b.p_min = p_min;
+		b.p_max = p_max;
+		return b;
+	}
+
+	void test_occlusion_buffer()
+	{
+		// Camera at the origin looking toward -z, field of view of 90 degrees, depth in [0.1, 100]
+		camera_projection_perspective projection;
+		projection.field_of_view = Pi / 2;
+		projection.aspect_ratio = 1.0f;
+		projection.depth_min = 0.1f;
+		projection.depth_max = 100.0f;
+
+		// Wall in front of the camera at z=-5
+		mesh const wall = mesh_primitive_quadrangle({ -2,-2,-5 }, { 2,-2,-5 }, { 2,2,-5 }, { -2,2,-5 });
+
+		occlusion_buffer occlusion;
+		occlusion.initialize(60, 60);
+		assert_cgp_no_msg(occlusion.width == 64 && occlusion.height == 64); // Multiple of the tile size
+		occlusion.clear(projection.matrix());
+		assert_cgp_no_msg(occlusion.is_visible(box({ -1,-1,-11 }, { 1,1,-9 }))); // Nothing drawn yet
+
+		occlusion.add_occluder(wall);
+		occlusion.rasterize();
+		assert_cgp_no_msg(occlusion.triangle_count() == 2);
+
+		{
+			assert_cgp_no_msg(!occlusion.is_visible(box({ -1,-1,-11 }, { 1,1,-9 })));   // behind the wall
+			assert_cgp_no_msg(occlusion.is_visible(box({ -1,-1,-4 }, { 1,1,-3 })));     // in front of the wall
+			assert_cgp_no_msg(occlusion.is_visible(box({ 6,-1,-11 }, { 8,1,-9 })));     // beside the wall
+			assert_cgp_no_msg(occlusion.is_visible(box({ -20,-1,-11 }, { 20,1,-9 })));  // larger than the wall
+			assert_cgp_no_msg(occlusion.is_visible(box({ -1,-1,-11 }, { 1,1,1 })));     // crossing the near plane
+			assert_cgp_no_msg(occlusion.is_visible(box({ -1,-1,9 }, { 1,1,11 })));      // behind the camera (left to the frustum test)
+		}
+
+		// Batch test
+		{
+			bounding_box const boxes[3] = { box({ -1,-1,-11 }, { 1,1,-9 }), box({ 6,-1,-11 }, { 8,1,-9 }), box({ -1,-1,-11 }, { 1,1,-9 }) };
+			unsigned char visible[3] = { 1, 1, 0 };
+			int const count = occlusion.cull_boxes(boxes, 3, visible);
+			assert_cgp_no_msg(count == 1);
+			assert_cgp_no_msg(visible[0] == 0 && visible[1] == 1 && visible[2] == 0);
+		}
+
+		// Ground crossing the near plane (clipped triangles)
+		{
+			mesh const ground = mesh_primitive_quadrangle({ -50,-1,5 }, { 50,-1,5 }, { 50,-1,-50 }, { -50,-1,-50 });
+			occlusion.clear(projection.matrix());
+			occlusion.add_occluder(ground);
+			occlusion.rasterize();
+			assert_cgp_no_msg(!occlusion.is_visible(box({ -1,-3,-11 }, { 1,-2,-9 })));  // below the ground
+			assert_cgp_no_msg(occlusion.is_visible(box({ -1,0,-11 }, { 1,1,-9 })));     // above the ground
+
+			// Same depth on a single thread
+			std::vector<float> const depth = occlusion.depth;
+			thread_pool pool(1);
+			occlusion.clear(projection.matrix());
+			occlusion.add_occluder(ground);
+			occlusion.rasterize(pool);
+			assert_cgp_no_msg(occlusion.depth == depth);
+		}
+	}
+}
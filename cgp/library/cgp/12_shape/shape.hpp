@@ -2,6 +2,8 @@
 
 #include "curve/curve.hpp"
 #include "bounding_box/bounding_box.hpp"
+#include "frustum/frustum.hpp"
 #include "implicit/implicit.hpp"
 #include "intersection/intersection.hpp"
+#include "occlusion_buffer/occlusion_buffer.hpp"
 #include "spatial_domain/spatial_domain.hpp"
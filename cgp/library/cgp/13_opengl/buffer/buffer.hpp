@@ -2,4 +2,6 @@
 
 #include "opengl_buffer/opengl_buffer.hpp"
 #include "vbo/vbo.hpp"
-#include "ebo/ebo.hpp"
\ No newline at end of file
+#include "ebo/ebo.hpp"
+#include "ubo/ubo.hpp"
+#include "streaming_buffer/streaming_buffer.hpp"
\ No newline at end of file
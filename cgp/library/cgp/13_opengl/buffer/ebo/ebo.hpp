@@ -10,6 +10,8 @@ namespace cgp
 	struct opengl_ebo_structure : opengl_gpu_buffer
 	{
 		void initialize_data_on_gpu(numarray<uint3> const& data);
+		/** Same with count triangles read from data (ex. an array of a file mapped in memory) */
+		void initialize_data_on_gpu(uint3 const* data, int count);
 	};
 
 
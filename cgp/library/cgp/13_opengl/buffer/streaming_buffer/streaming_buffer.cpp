@@ -0,0 +1,159 @@
+#include "streaming_buffer.hpp"
+#include "../../debug/debug.hpp"
+#include "cgp/01_base/base.hpp"
+
+#include <cstring>
+
+namespace cgp
+{
+	void opengl_streaming_buffer::initialize_data_on_gpu(GLsizeiptr region_size_byte, GLenum type_arg, int region_count_arg)
+	{
+		assert_cgp(region_size_byte > 0 && region_count_arg > 0, "Streaming buffer needs a positive size and number of regions");
+		if (id != 0) {
+			warning_cgp("Initialize streaming buffer that is not empty", "The previous buffer is cleared.");
+			clear();
+		}
+
+		type = type_arg;
+		region_size = region_size_byte;
+		region_count = region_count_arg;
+
+		glGenBuffers(1, &id);                                                              opengl_check;
+		glBindBuffer(type, id);                                                            opengl_check;
+		glBufferData(type, region_size * region_count, nullptr, GL_STREAM_DRAW);           opengl_check;
+		glBindBuffer(type, 0);                                                             opengl_check;
+
+		fences.assign(region_count, nullptr);
+		region = region_count - 1; // The first begin_frame() starts with the region 0
+		region_used = 0;
+		frame_started = false;
+		mapped = opengl_stream_range();
+		wait_count = 0;
+	}
+
+	void opengl_streaming_buffer::clear()
+	{
+		for (GLsync& fence : fences) {
+			if (fence != nullptr)
+				glDeleteSync(fence);
+			fence = nullptr;
+		}
+		fences.clear();
+		if (id != 0) {
+			glDeleteBuffers(1, &id); opengl_check;
+		}
+		id = 0;
+		type = 0;
+		region_size = 0;
+		region_count = 0;
+		region = 0;
+		region_used = 0;
+		frame_started = false;
+		mapped = opengl_stream_range();
+	}
+
+	void opengl_streaming_buffer::begin_frame()
+	{
+		assert_cgp(id != 0, "Streaming buffer used before initialize_data_on_gpu()");
+		assert_cgp(!frame_started, "opengl_streaming_buffer::begin_frame() called twice without end_frame()");
+
+		region = (region + 1) % region_count;
+		GLsync& fence = fences[region];
+		if (fence != nullptr) {
+			// Most of the time, the GPU is done with the region and the fence is already signaled (no wait)
+			GLenum status = glClientWaitSync(fence, 0, 0);
+			if (status == GL_TIMEOUT_EXPIRED) {
+				wait_count++;
+				while (status == GL_TIMEOUT_EXPIRED)
+					status = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, GLuint64(1000000000)); // 1s
+			}
+			if (status == GL_WAIT_FAILED)
+				warning_cgp("Streaming buffer", "glClientWaitSync failed: the region is written without synchronization");
+			glDeleteSync(fence);
+			fence = nullptr;
+		}
+
+		region_used = 0;
+		frame_started = true;
+	}
+
+	void opengl_streaming_buffer::end_frame()
+	{
+		assert_cgp(frame_started, "opengl_streaming_buffer::end_frame() called without begin_frame()");
+		assert_cgp(mapped.size == 0, "opengl_streaming_buffer::end_frame() called while a range is mapped");
+		fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0); opengl_check;
+		frame_started = false;
+	}
+
+	opengl_stream_range opengl_streaming_buffer::allocate(GLsizeiptr size_byte, GLsizeiptr alignment)
+	{
+		assert_cgp(frame_started, "Allocation in a streaming buffer outside of begin_frame()/end_frame()");
+		GLsizeiptr const start = alignment > 1 ? (region_used + alignment - 1) / alignment * alignment : region_used;
+		assert_cgp(start + size_byte <= region_size, "Streaming buffer region too small for this frame: " + str(start + size_byte) + " bytes needed, " + str(region_size) + " available (increase the region size given to initialize_data_on_gpu)");
+
+		opengl_stream_range range;
+		range.offset = GLintptr(region * region_size + start);
+		range.size = size_byte;
+		region_used = start + size_byte;
+		return range;
+	}
+
+	void* opengl_streaming_buffer::map(opengl_stream_range const& range)
+	{
+		assert_cgp(mapped.size == 0, "Streaming buffer: a range is already mapped");
+		if (range.size == 0)
+			return nullptr;
+		mapped = range;
+
+#ifndef __EMSCRIPTEN__
+		glBindBuffer(type, id); opengl_check;
+		void* data = glMapBufferRange(type, range.offset, range.size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT); opengl_check;
+		assert_cgp(data != nullptr, "Streaming buffer: glMapBufferRange failed");
+		return data;
+#else
+		staging.resize(size_t(range.size));
+		return staging.data();
+#endif
+	}
+
+	void opengl_streaming_buffer::unmap()
+	{
+		if (mapped.size == 0)
+			return;
+
+		glBindBuffer(type, id); opengl_check;
+#ifndef __EMSCRIPTEN__
+		glUnmapBuffer(type); opengl_check;
+#else
+		glBufferSubData(type, mapped.offset, mapped.size, staging.data()); opengl_check;
+#endif
+		glBindBuffer(type, 0); opengl_check;
+		mapped = opengl_stream_range();
+	}
+
+	opengl_stream_range opengl_streaming_buffer::push(void const* data, GLsizeiptr size_byte)
+	{
+		opengl_stream_range const range = allocate(size_byte);
+		if (size_byte > 0) {
+			std::memcpy(map(range), data, size_t(size_byte));
+			unmap();
+		}
+		return range;
+	}
+
+	GLsizeiptr opengl_streaming_buffer::size_used() const
+	{
+		return region_used;
+	}
+
+	void opengl_set_vao_location(GLuint vao, opengl_streaming_buffer const& buffer, opengl_stream_range const& range, GLuint location_index, GLint size_element, GLuint divisor)
+	{
+		glBindVertexArray(vao); opengl_check;
+		glBindBuffer(GL_ARRAY_BUFFER, buffer.id); opengl_check;
+		glEnableVertexAttribArray(location_index); opengl_check;
+		glVertexAttribPointer(location_index, size_element, GL_FLOAT, GL_FALSE, 0, reinterpret_cast<void const*>(range.offset)); opengl_check;
+		glVertexAttribDivisor(location_index, divisor); opengl_check;
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+		glBindVertexArray(0);
+	}
+}
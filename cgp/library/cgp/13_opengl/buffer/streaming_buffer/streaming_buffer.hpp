@@ -0,0 +1,69 @@
+#pragma once
+
+#include "cgp/opengl_include.hpp"
+#include "cgp/02_numarray/numarray.hpp"
+
+#include <vector>
+
+namespace cgp
+{
+	/** Range of an opengl_streaming_buffer allocated for the current frame */
+	struct opengl_stream_range
+	{
+		GLintptr offset = 0;   // Offset in bytes from the start of the buffer (ex. pointer argument of glVertexAttribPointer)
+		GLsizeiptr size = 0;   // Size in bytes
+	};
+
+	/** Buffer streaming dynamic data (instances, particles, trajectories, debug lines) to the GPU without waiting for the draw calls still reading it
+	* The buffer is split in region_count regions used in turn by the frames (3 by default: the frame written by the CPU, and up to two frames still read by the GPU).
+	*  - begin_frame() moves to the next region. It only waits if the GPU has not finished the frame that used this region region_count frames ago (fence sync).
+	*  - allocate(), map() and push() hand out sub-ranges of this region. They are written through glMapBufferRange with GL_MAP_UNSYNCHRONIZED_BIT | GL_MAP_INVALIDATE_RANGE_BIT:
+	*    the driver does not synchronize with the previous draw calls, the fences do it once per frame.
+	*  - end_frame(), called after the draw calls reading the data of the frame, places the fence of the region.
+	* A frame cannot allocate more than region_size bytes. */
+	struct opengl_streaming_buffer
+	{
+		GLuint id = 0;
+		GLenum type = 0;            // ex. GL_ARRAY_BUFFER
+		GLsizeiptr region_size = 0; // Size in bytes available for each frame
+		int region_count = 0;
+
+		// Number of calls of begin_frame() that had to wait for the GPU (the GPU is late by more than region_count-1 frames)
+		int wait_count = 0;
+
+		void initialize_data_on_gpu(GLsizeiptr region_size_byte, GLenum type = GL_ARRAY_BUFFER, int region_count = 3);
+		void clear();
+
+		void begin_frame();
+		void end_frame();
+
+		/** Reserve size_byte bytes in the region of the current frame (the offset is a multiple of alignment) */
+		opengl_stream_range allocate(GLsizeiptr size_byte, GLsizeiptr alignment = 16);
+
+		/** Map a range of the current frame to write it from the CPU (write only: its previous content is undefined)
+		* The range must be unmapped before the draw calls reading it. */
+		void* map(opengl_stream_range const& range);
+		void unmap();
+
+		/** Allocate a range and copy the data in it */
+		opengl_stream_range push(void const* data, GLsizeiptr size_byte);
+		template <typename T> opengl_stream_range push(numarray<T> const& data) { return push(ptr(data), GLsizeiptr(size_in_memory(data))); }
+
+		/** Bytes allocated in the current frame */
+		GLsizeiptr size_used() const;
+
+	private:
+		int region = 0;               // Region of the current frame
+		GLsizeiptr region_used = 0;
+		bool frame_started = false;
+		std::vector<GLsync> fences;   // Fence placed after the last frame written in each region (0: none)
+		opengl_stream_range mapped;   // Range mapped by map() (size 0: none)
+#ifdef __EMSCRIPTEN__
+		std::vector<char> staging;    // WebGL has no glMapBufferRange: map() writes here, and unmap() sends it with glBufferSubData
+#endif
+	};
+
+	/** Set the attribute location_index of the VAO to read vec(size_element) of floats from a range of the streaming buffer
+	* The VAO keeps reading this range until the next call: to be called each frame after the range is allocated. */
+	void opengl_set_vao_location(GLuint vao, opengl_streaming_buffer const& buffer, opengl_stream_range const& range, GLuint location_index, GLint size_element, GLuint divisor = 0);
+}
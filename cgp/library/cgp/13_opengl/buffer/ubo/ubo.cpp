@@ -0,0 +1,51 @@
+#include "ubo.hpp"
+#include "../../debug/debug.hpp"
+#include "cgp/01_base/base.hpp"
+
+namespace cgp
+{
+	void opengl_ubo_structure::initialize_data_on_gpu(GLuint size_byte, GLuint binding_point_arg)
+	{
+		if (id != 0) {
+			warning_cgp("Initialize UBO that is not empty", "The previous buffer is not cleared: this may lead to memory leak.");
+		}
+
+		glGenBuffers(1, &id);                                                        opengl_check;
+		glBindBuffer(GL_UNIFORM_BUFFER, id);                                         opengl_check;
+		glBufferData(GL_UNIFORM_BUFFER, GLsizeiptr(size_byte), NULL, GL_DYNAMIC_DRAW); opengl_check;
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);                                          opengl_check;
+
+		size = 1;
+		type = GL_UNIFORM_BUFFER;
+		binding_point = binding_point_arg;
+
+		details.size_byte = size_byte;
+		details.size_element = size_byte;
+		details.type_element = GL_UNSIGNED_BYTE;
+
+		bind_base();
+	}
+
+	void opengl_ubo_structure::update(void const* data, GLuint size_byte, GLuint offset)
+	{
+		assert_cgp(offset + size_byte <= details.size_byte, "Cannot update UBO with more bytes than allocated (" + str(offset + size_byte) + " > " + str(details.size_byte) + ")");
+		glBindBuffer(GL_UNIFORM_BUFFER, id);                          opengl_check;
+		glBufferSubData(GL_UNIFORM_BUFFER, offset, size_byte, data);  opengl_check;
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);                           opengl_check;
+	}
+
+	void opengl_ubo_structure::bind_base() const
+	{
+		glBindBufferBase(GL_UNIFORM_BUFFER, binding_point, id); opengl_check;
+	}
+
+	bool opengl_uniform_block_binding(GLuint shader_id, std::string const& block_name, GLuint binding_point)
+	{
+		GLuint const block_index = glGetUniformBlockIndex(shader_id, block_name.c_str()); opengl_check;
+		if (block_index == GL_INVALID_INDEX)
+			return false;
+		glUniformBlockBinding(shader_id, block_index, binding_point); opengl_check;
+		return true;
+	}
+
+}
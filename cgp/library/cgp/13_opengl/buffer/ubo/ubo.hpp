@@ -0,0 +1,31 @@
+#pragma once
+
+#include "../opengl_buffer/opengl_buffer.hpp"
+#include <string>
+
+
+namespace cgp
+{
+	/** Uniform buffer object: block of uniform variables stored once on the GPU and read by several shaders
+	* The buffer is attached to a binding point, and each shader connects its uniform block to the same binding point (opengl_uniform_block_binding). */
+	struct opengl_ubo_structure : opengl_gpu_buffer
+	{
+		/** Allocate size_byte bytes on the GPU and attach the buffer to the binding point */
+		void initialize_data_on_gpu(GLuint size_byte, GLuint binding_point);
+
+		/** Re-write the bytes [offset, offset+size_byte[ of the buffer (without re-allocation) in calling glBufferSubData */
+		void update(void const* data, GLuint size_byte, GLuint offset = 0);
+		/** Re-write the whole buffer with a structure matching the std140 layout of the block */
+		template <typename T> void update(T const& block) { update(&block, GLuint(sizeof(T))); }
+
+		/** Attach the buffer to its binding point again (if another buffer was attached in the meantime) */
+		void bind_base() const;
+
+		GLuint binding_point = 0;
+	};
+
+	/** Connect the uniform block block_name of the shader to the binding point
+	* Return false if the shader has no such block (or if none of its variables is used). */
+	bool opengl_uniform_block_binding(GLuint shader_id, std::string const& block_name, GLuint binding_point);
+
+}
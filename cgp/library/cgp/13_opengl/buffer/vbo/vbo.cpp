@@ -7,61 +7,50 @@ namespace cgp
 	static void warning_initialize_non_empty();
 
 	template <int N>
-	static GLuint opengl_buffer_data_initialize_generic(numarray<numarray_stack<float,N> > const& data, GLuint buffer_type, GLenum draw_type)
+	static void opengl_vbo_initialize_generic(opengl_vbo_structure& vbo, numarray_stack<float, N> const* data, int count, GLuint divisor)
 	{
-		GLuint vbo_index;
-		glGenBuffers(1, &vbo_index);                                                       opengl_check;
-		glBindBuffer(buffer_type, vbo_index);                                              opengl_check;
-		glBufferData(buffer_type, GLsizeiptr(size_in_memory(data)), ptr(data), draw_type); opengl_check;
-		glBindBuffer(buffer_type, 0);                                                      opengl_check;
+		if(vbo.id!=0){
+			warning_initialize_non_empty();
+		}
+
+		GLsizeiptr const size_byte = GLsizeiptr(N * sizeof(float) * count);
+		glGenBuffers(1, &vbo.id);                                                opengl_check;
+		glBindBuffer(GL_ARRAY_BUFFER, vbo.id);                                   opengl_check;
+		glBufferData(GL_ARRAY_BUFFER, size_byte, data, GL_DYNAMIC_DRAW);         opengl_check;
+		glBindBuffer(GL_ARRAY_BUFFER, 0);                                        opengl_check;
 
-		return vbo_index;
+		vbo.divisor = divisor;
+		vbo.size = count;
+		vbo.type = GL_ARRAY_BUFFER;
+
+		vbo.details.size_byte = GLuint(size_byte);
+		vbo.details.size_element = N;
+		vbo.details.type_element = GL_FLOAT;
 	}
 
 	void opengl_vbo_structure::initialize_data_on_gpu(numarray<vec3> const& data, GLuint div)
 	{
-		if(id!=0){
-			warning_initialize_non_empty();
-		}
-
-		divisor = div;
-		id = opengl_buffer_data_initialize_generic(data, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
-		size = data.size();
-		type = GL_ARRAY_BUFFER;
-
-		details.size_byte = size_in_memory(data);
-		details.size_element = 3;
-		details.type_element = GL_FLOAT;
+		initialize_data_on_gpu(data.data.data(), int(data.size()), div);
 	}
 	void opengl_vbo_structure::initialize_data_on_gpu(numarray<vec2> const& data, GLuint div)
 	{
-		if(id!=0){
-			warning_initialize_non_empty();
-		}
-
-		divisor = div;
-		id = opengl_buffer_data_initialize_generic(data, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
-		size = data.size();
-		type = GL_ARRAY_BUFFER;
-
-		details.size_byte = size_in_memory(data);
-		details.size_element = 2;
-		details.type_element = GL_FLOAT;
+		initialize_data_on_gpu(data.data.data(), int(data.size()), div);
 	}
 	void opengl_vbo_structure::initialize_data_on_gpu(numarray<vec4> const& data, GLuint div)
 	{
-		if(id!=0){
-			warning_initialize_non_empty();
-		}
-
-		divisor = div;
-		id = opengl_buffer_data_initialize_generic(data, GL_ARRAY_BUFFER, GL_DYNAMIC_DRAW);
-		size = data.size();
-		type = GL_ARRAY_BUFFER;
-
-		details.size_byte = size_in_memory(data);
-		details.size_element = 4;
-		details.type_element = GL_FLOAT;
+		initialize_data_on_gpu(data.data.data(), int(data.size()), div);
+	}
+	void opengl_vbo_structure::initialize_data_on_gpu(vec3 const* data, int count, GLuint div)
+	{
+		opengl_vbo_initialize_generic(*this, data, count, div);
+	}
+	void opengl_vbo_structure::initialize_data_on_gpu(vec2 const* data, int count, GLuint div)
+	{
+		opengl_vbo_initialize_generic(*this, data, count, div);
+	}
+	void opengl_vbo_structure::initialize_data_on_gpu(vec4 const* data, int count, GLuint div)
+	{
+		opengl_vbo_initialize_generic(*this, data, count, div);
 	}
 	void opengl_vbo_structure::update(numarray<vec2> const& data, int size_elements_update)
 	{
@@ -98,6 +87,32 @@ namespace cgp
 	}
 
 
+	template <int N>
+	static void opengl_buffer_update_range_generic(GLuint id, numarray<numarray_stack<float, N> > const& data, int first, int count)
+	{
+		assert_cgp(first >= 0 && count >= 0 && first + count <= int(data.size()), "Cannot update VBO range [" + str(first) + "," + str(first + count) + "[ with data of size " + str(data.size()));
+		if (count == 0)
+			return;
+		GLintptr const offset = GLintptr(N * sizeof(float) * first);
+		glBindBuffer(GL_ARRAY_BUFFER, id); opengl_check;
+		glBufferSubData(GL_ARRAY_BUFFER, offset, GLsizeiptr(N * sizeof(float) * count), &data[first]);  opengl_check;
+	}
+	void opengl_vbo_structure::update_range(numarray<vec2> const& data, int first, int count)
+	{
+		assert_cgp(first + count <= int(size), "Cannot update VBO range beyond its size");
+		opengl_buffer_update_range_generic(id, data, first, count);
+	}
+	void opengl_vbo_structure::update_range(numarray<vec3> const& data, int first, int count)
+	{
+		assert_cgp(first + count <= int(size), "Cannot update VBO range beyond its size");
+		opengl_buffer_update_range_generic(id, data, first, count);
+	}
+	void opengl_vbo_structure::update_range(numarray<vec4> const& data, int first, int count)
+	{
+		assert_cgp(first + count <= int(size), "Cannot update VBO range beyond its size");
+		opengl_buffer_update_range_generic(id, data, first, count);
+	}
+
 	void opengl_set_vao_location(opengl_vbo_structure const& vbo, GLuint location_index)
 	{
 		vbo.bind();
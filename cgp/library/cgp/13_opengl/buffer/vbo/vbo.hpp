@@ -14,6 +14,10 @@ namespace cgp
 		void initialize_data_on_gpu(numarray<vec3> const& data, GLuint divisor = 0);
 		void initialize_data_on_gpu(numarray<vec2> const& data, GLuint divisor = 0);
 		void initialize_data_on_gpu(numarray<vec4> const& data, GLuint divisor = 0);
+		/** Same with count elements read from data (ex. an array of a file mapped in memory). data can be nullptr to allocate the buffer without filling it */
+		void initialize_data_on_gpu(vec3 const* data, int count, GLuint divisor = 0);
+		void initialize_data_on_gpu(vec2 const* data, int count, GLuint divisor = 0);
+		void initialize_data_on_gpu(vec4 const* data, int count, GLuint divisor = 0);
 
 		/** Re-write data on the VBO. (without re-allocation) in calling glBufferSubData
 		* - size_elements_update: 
@@ -23,6 +27,12 @@ namespace cgp
 		void update(numarray<vec3> const& data, int size_elements_update = -1);
 		void update(numarray<vec4> const& data, int size_elements_update = -1);
 
+		/** Re-write only the elements [first, first+count[ of the VBO with the same elements of data (without re-allocation)
+		* Ex. a single new element in a ring buffer: the rest of the buffer is not transferred again. */
+		void update_range(numarray<vec2> const& data, int first, int count);
+		void update_range(numarray<vec3> const& data, int first, int count);
+		void update_range(numarray<vec4> const& data, int first, int count);
+
 		GLuint divisor;
 	};
 
@@ -30,6 +30,25 @@ namespace cgp{
 		glBindFramebuffer(GL_FRAMEBUFFER, 0);
 	}
 
+	void opengl_fbo_structure::initialize(int width_arg, int height_arg, GLint format) {
+
+		width = width_arg;
+		height = height_arg;
+
+		texture.initialize_texture_2d_on_gpu(width, height, format, GL_TEXTURE_2D);
+
+		glGenRenderbuffers(1, &depth_buffer_id);
+		glBindRenderbuffer(GL_RENDERBUFFER, depth_buffer_id);
+		glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT, width, height);
+		glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+		glGenFramebuffers(1, &id);
+		glBindFramebuffer(GL_FRAMEBUFFER, id);
+		glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture.id, 0);
+		glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth_buffer_id);
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+
 	void opengl_fbo_structure::bind() const {
 		glBindFramebuffer(GL_FRAMEBUFFER, id);
 		texture.bind();
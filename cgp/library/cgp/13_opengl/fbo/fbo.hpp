@@ -30,21 +30,23 @@ namespace cgp {
 	struct opengl_fbo_structure {
 		
 		// ID of the FBO
-		GLuint id; 
+		GLuint id = 0;
 
 		// Depth buffer
-		GLuint depth_buffer_id; 
+		GLuint depth_buffer_id = 0;
 
 		// Texture storing the rendering in this FBO
 		opengl_texture_image_structure texture;
 
 		// Size of the texture
-		int width;
-		int height;
+		int width = 0;
+		int height = 0;
 
 		// Initialize the ids and the texture
 		//  This function must be called before any rendering pass
 		void initialize();
+		// Fixed size target (ex. texture atlas): the texture has the given format, and the depth buffer the size of the texture
+		void initialize(int width_arg, int height_arg, GLint format = GL_RGB8);
 
 		// Start the rendering pass where the output will be stored on the FBO
 		void bind() const;
@@ -39,6 +39,34 @@ namespace cgp
         return location;
     }
 
+    GLint cache_uniform_location_structure::query(GLuint shaderID, uniform_id const& uniform)
+    {
+        GLint const not_queried = -2;
+        if (shaderID < cache_id.size() && uniform.index >= 0 && uniform.index < int(cache_id[shaderID].size())) {
+            GLint const location = cache_id[shaderID][uniform.index];
+            if (location != not_queried)
+                return location;
+        }
+
+        // First query of this uniform in this shader
+        assert_cgp(uniform.index >= 0, "Try to query an uniform_id created without name on shader " + str(shaderID));
+        if (shaderID >= cache_id.size())
+            cache_id.resize(shaderID + 1);
+        std::vector<GLint>& locations = cache_id[shaderID];
+        if (uniform.index >= int(locations.size()))
+            locations.resize(uniform_id_count(), not_queried);
+
+        GLint const location = query(shaderID, uniform.name());
+        locations[uniform.index] = location;
+        return location;
+    }
+
+    void cache_uniform_location_structure::clear()
+    {
+        cache_data.clear();
+        cache_id.clear();
+    }
+
     std::string str(cache_uniform_location_structure const& cache)
     {
         std::string s;
@@ -1,9 +1,11 @@
 #pragma once
 
 #include "cgp/opengl_include.hpp"
+#include "../uniform_id/uniform_id.hpp"
 
 #include <string>
 #include <map>
+#include <vector>
 
 namespace cgp
 {
@@ -12,6 +14,7 @@ namespace cgp
 	struct cache_uniform_location_structure
 	{
 		std::map<GLuint, std::map<std::string, GLint> > cache_data;
+		std::vector<std::vector<GLint> > cache_id; // cache_id[shaderID][uniform.index] (-2 if not queried yet)
 
 		// Return the location of the uniform in the shader designated by shaderID and update the caching system
 		//  Query glGetUniformLocation the first time the variable is queried and save it.
@@ -19,6 +22,11 @@ namespace cgp
 		//  If uniformName is not found return (and cache) the value -1.
 		GLint query(GLuint shaderID, std::string const& uniformName);
 
+		// Same query from an interned name: two array accesses once the location is known
+		GLint query(GLuint shaderID, uniform_id const& uniform);
+
+		void clear();
+
 	};
 
 	std::string str(cache_uniform_location_structure const& cache);
@@ -32,6 +32,7 @@ namespace cgp
 
 		// Query the location of a uniform variable using the cache system
 		GLint query_uniform_location(std::string const& uniform_name) const;
+		GLint query_uniform_location(uniform_id const& uniform) const;
 
 		// Clear the cache system
 		void clear_cache_uniform_location();
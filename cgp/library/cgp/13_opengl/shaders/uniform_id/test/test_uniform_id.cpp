@@ -0,0 +1,47 @@
+#include "cgp/01_base/base.hpp"
+#include "cgp/13_opengl/shaders/shaders.hpp"
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test 
+{
+
+	void test_uniform_id()
+	{
+		using namespace cgp;
+
+		// same name gives the same identifier
+		{
+			uniform_id const a("test_uniform_id.a");
+			uniform_id const b("test_uniform_id.b");
+			uniform_id const a2("test_uniform_id.a");
+			assert_cgp_no_msg(a.index == a2.index);
+			assert_cgp_no_msg(a.index != b.index);
+			assert_cgp_no_msg(a.name() == "test_uniform_id.a");
+			assert_cgp_no_msg(b.name() == "test_uniform_id.b");
+			assert_cgp_no_msg(uniform_id_count() > b.index);
+		}
+
+		// query from the identifier gives the location cached for the name (no OpenGL call when the name is already cached)
+		{
+			cache_uniform_location_structure cache;
+			cache.cache_data[3]["test_uniform_id.a"] = 5;
+			cache.cache_data[3]["test_uniform_id.b"] = -1;
+			cache.cache_data[7]["test_uniform_id.a"] = 2;
+
+			uniform_id const a("test_uniform_id.a");
+			uniform_id const b("test_uniform_id.b");
+			assert_cgp_no_msg(cache.query(3, a) == 5);
+			assert_cgp_no_msg(cache.query(3, b) == -1);
+			assert_cgp_no_msg(cache.query(7, a) == 2);
+			assert_cgp_no_msg(cache.query(3, a) == 5); // second query read from cache_id
+
+			// new identifier created after the first query of the shader
+			uniform_id const c("test_uniform_id.c");
+			cache.cache_data[3]["test_uniform_id.c"] = 9;
+			assert_cgp_no_msg(cache.query(3, c) == 9);
+		}
+	}
+}
@@ -0,0 +1,52 @@
+#include "uniform_id.hpp"
+
+#include "cgp/01_base/base.hpp"
+
+#include <deque>
+#include <mutex>
+#include <unordered_map>
+
+namespace cgp
+{
+	// Table of the interned names (a deque keeps the references to the names valid when it grows)
+	struct uniform_id_table
+	{
+		std::mutex mutex;
+		std::deque<std::string> names;
+		std::unordered_map<std::string, int> index;
+	};
+	static uniform_id_table& table()
+	{
+		static uniform_id_table t; // Created at the first use: identifiers can be static variables of other files
+		return t;
+	}
+
+	uniform_id::uniform_id(std::string const& name)
+	{
+		uniform_id_table& t = table();
+		std::lock_guard<std::mutex> lock(t.mutex);
+		auto const it = t.index.find(name);
+		if (it != t.index.end()) {
+			index = it->second;
+			return;
+		}
+		index = int(t.names.size());
+		t.names.push_back(name);
+		t.index[name] = index;
+	}
+
+	std::string const& uniform_id::name() const
+	{
+		assert_cgp(index >= 0, "Use of an uniform_id created without name");
+		uniform_id_table& t = table();
+		std::lock_guard<std::mutex> lock(t.mutex);
+		return t.names[index];
+	}
+
+	int uniform_id_count()
+	{
+		uniform_id_table& t = table();
+		std::lock_guard<std::mutex> lock(t.mutex);
+		return int(t.names.size());
+	}
+}
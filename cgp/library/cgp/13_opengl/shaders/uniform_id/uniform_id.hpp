@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+
+namespace cgp
+{
+	// Interned name of a uniform variable
+	//  The name is looked up in a global table once, when the identifier is created. Identifiers are small consecutive integers:
+	//  the location of the uniform in a shader is then read by indexing a table (no string comparison, see cache_uniform_location_structure).
+	//  Usage: create the identifiers of frequently sent uniforms once
+	//    static uniform_id const uniform_model("model");
+	//    opengl_uniform(shader, uniform_model, M);
+	struct uniform_id
+	{
+		uniform_id() = default;
+		explicit uniform_id(std::string const& name);
+
+		// The name of the uniform variable in the shaders
+		std::string const& name() const;
+
+		int index = -1;
+	};
+
+	// Number of uniform names interned so far
+	int uniform_id_count();
+}
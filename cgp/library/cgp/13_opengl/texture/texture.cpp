@@ -63,6 +63,19 @@ namespace cgp
         return id;
     }
 
+    // Send the levels of a face of the mipmap to the bound texture (target: GL_TEXTURE_2D or a face of a cubemap)
+    static void opengl_send_mipmap_levels(GLenum target, image_mipmap_view const& im, int face, GLint format)
+    {
+        // The rows of the levels are not padded to 4 octets
+        GLint alignment = 4;
+        glGetIntegerv(GL_UNPACK_ALIGNMENT, &alignment); opengl_check;
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1); opengl_check;
+        for (int k = 0; k < im.level_count; ++k) {
+            glTexImage2D(target, k, format, im.level_width(k), im.level_height(k), 0, format_to_data_type(format), format_to_component(format), im.level_data(face, k)); opengl_check;
+        }
+        glPixelStorei(GL_UNPACK_ALIGNMENT, alignment); opengl_check;
+    }
+
     void opengl_texture_image_structure::bind() const
     {
         glBindTexture(texture_type, id); opengl_check;
@@ -99,6 +112,30 @@ namespace cgp
         id = opengl_initialize_texture_2d_on_gpu(width, height, ptr(im.data), wrap_s, wrap_t, texture_type, format, format_to_data_type(format), format_to_component(format), is_mipmap, texture_mag_filter, texture_min_filter);
     }
 
+    void opengl_texture_image_structure::initialize_texture_2d_on_gpu(image_mipmap_view const& im, GLint wrap_s, GLint wrap_t, GLint texture_mag_filter, GLint texture_min_filter)
+    {
+        assert_cgp(im.face_count == 1 && im.level_count > 0 && im.data != nullptr, "Incorrect mip levels for a 2D texture (" + str(im.face_count) + " faces, " + str(im.level_count) + " levels)");
+
+        // Store parameters
+        width = im.width;
+        height = im.height;
+        format = (im.color_type == image_color_type::rgba ? GL_RGBA8 : GL_RGB8);
+        texture_type = GL_TEXTURE_2D;
+
+        // Initialize texture data on GPU: one glTexImage2D per level
+        glGenTextures(1, &id); opengl_check;
+        glBindTexture(texture_type, id); opengl_check;
+        opengl_send_mipmap_levels(texture_type, im, 0, format);
+
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_S, wrap_s); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_T, wrap_t); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_MAX_LEVEL, im.level_count - 1); opengl_check; // The texture is complete without the levels below
+        glTexParameteri(texture_type, GL_TEXTURE_MAG_FILTER, texture_mag_filter); opengl_check;
+        glTexParameteri(texture_type, GL_TEXTURE_MIN_FILTER, texture_min_filter); opengl_check;
+
+        glBindTexture(texture_type, 0); opengl_check;
+    }
+
     void opengl_texture_image_structure::load_and_initialize_texture_2d_on_gpu(std::string const& filename, GLint wrap_s, GLint wrap_t, bool is_mipmap, GLint texture_mag_filter, GLint texture_min_filter)
     {
         image_structure const im = image_load_file(filename);
@@ -182,6 +219,32 @@ namespace cgp
         glBindTexture(texture_type, 0);
     }
 
+    void opengl_texture_image_structure::initialize_cubemap_on_gpu(image_mipmap_view const& faces, GLint texture_min_filter)
+    {
+        assert_cgp(faces.face_count == 6 && faces.level_count > 0 && faces.data != nullptr && faces.width == faces.height, "Incorrect faces for a cubemap (" + str(faces.face_count) + " faces of " + str(faces.width) + "x" + str(faces.height) + ", " + str(faces.level_count) + " levels)");
+
+        width = faces.width;
+        height = faces.height;
+        format = (faces.color_type == image_color_type::rgba ? GL_RGBA8 : GL_RGB8);
+        texture_type = GL_TEXTURE_CUBE_MAP;
+
+        glGenTextures(1, &id);
+        glBindTexture(texture_type, id);
+        GLenum const targets[6] = { GL_TEXTURE_CUBE_MAP_NEGATIVE_X, GL_TEXTURE_CUBE_MAP_POSITIVE_X, GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, GL_TEXTURE_CUBE_MAP_POSITIVE_Y, GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, GL_TEXTURE_CUBE_MAP_POSITIVE_Z };
+        for (int f = 0; f < 6; ++f)
+            opengl_send_mipmap_levels(targets[f], faces, f, format);
+
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+        glTexParameteri(texture_type, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+        glTexParameteri(texture_type, GL_TEXTURE_MAX_LEVEL, faces.level_count - 1);
+
+        glTexParameteri(texture_type, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glTexParameteri(texture_type, GL_TEXTURE_MIN_FILTER, texture_min_filter);
+
+        glBindTexture(texture_type, 0);
+    }
+
 
     void opengl_texture_image_structure::update(grid_2D<vec3> const& im)
     {
@@ -46,6 +46,13 @@ namespace cgp
 		// Initialize a CUBEMAP on GPU from 6 squared images
 		void initialize_cubemap_on_gpu(image_structure const& x_neg, image_structure const& x_pos, image_structure const& y_neg, image_structure const& y_pos, image_structure const& z_neg, image_structure const& z_pos);
 
+		// Initialize a GL_TEXTURE_2D from mip levels computed beforehand (ex. read from a texture_cache_file): the levels are sent as they are, without glGenerateMipmap
+		//  GL_TEXTURE_MAX_LEVEL is set to the last level of the view: a view with a single level gives a texture without mipmap
+		void initialize_texture_2d_on_gpu(image_mipmap_view const& im, GLint wrap_s = GL_CLAMP_TO_EDGE, GLint wrap_t = GL_CLAMP_TO_EDGE, GLint texture_mag_filter = GL_LINEAR, GLint texture_min_filter = GL_LINEAR_MIPMAP_LINEAR);
+
+		// Initialize a CUBEMAP on GPU from the 6 faces of the view (and their mip levels if there are several)
+		void initialize_cubemap_on_gpu(image_mipmap_view const& faces, GLint texture_min_filter = GL_LINEAR);
+
 		// Initialize a generic GL_TEXTURE from empty data
 		void initialize_texture_2d_on_gpu(int width_arg, int height_arg, GLint format_arg=GL_RGB8, GLenum texture_type_arg= GL_TEXTURE_2D, GLint wrap_s= GL_CLAMP_TO_EDGE, GLint wrap_t= GL_CLAMP_TO_EDGE, GLint texture_mag_filter= GL_LINEAR, GLint texture_min_filter= GL_LINEAR);
 
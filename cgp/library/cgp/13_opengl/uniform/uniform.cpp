@@ -26,94 +26,61 @@ namespace cgp
 	}
 
 
-	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, int value, bool expected)
-	{
-		GLint const location = shader.query_uniform_location(name);
-		if (check_location(location, name, shader.id, expected)) {
-			glUniform1i(location, value); opengl_check;
-		}
-	}
+	// Send the value to the location of the current shader
+	static void set_uniform(GLint location, int value) { glUniform1i(location, value); }
+	static void set_uniform(GLint location, GLuint value) { glUniform1i(location, value); }
+	static void set_uniform(GLint location, float value) { glUniform1f(location, value); }
+	static void set_uniform(GLint location, vec2 const& value) { glUniform2f(location, value.x, value.y); }
+	static void set_uniform(GLint location, vec3 const& value) { glUniform3f(location, value.x, value.y, value.z); }
+	static void set_uniform(GLint location, vec4 const& value) { glUniform4f(location, value.x, value.y, value.z, value.w); }
+	static void set_uniform(GLint location, mat4 const& m) { glUniformMatrix4fv(location, 1, GL_TRUE, ptr(m)); }
+	static void set_uniform(GLint location, mat3 const& m) { glUniformMatrix3fv(location, 1, GL_TRUE, ptr(m)); }
+	static void set_uniform(GLint location, mat2 const& m) { glUniformMatrix2fv(location, 1, GL_TRUE, ptr(m)); }
 
-	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, GLuint value, bool expected)
+	template <typename T>
+	static void send_uniform(opengl_shader_structure const& shader, std::string const& name, T const& value, bool expected)
 	{
 		GLint const location = shader.query_uniform_location(name);
 		if (check_location(location, name, shader.id, expected)) {
-			glUniform1i(location, value); opengl_check;
+			set_uniform(location, value); opengl_check;
 		}
-
 	}
-	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, float value, bool expected)
+	template <typename T>
+	static void send_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, T const& value, bool expected)
 	{
-		GLint const location = shader.query_uniform_location(name);
-		if (check_location(location, name, shader.id, expected)) {
-			glUniform1f(location, value); opengl_check;
-		}
-	}
-	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, vec2 const& value, bool expected)
-	{
-		GLint const location = shader.query_uniform_location(name);
-		if (check_location(location, name, shader.id, expected)) {
-			glUniform2f(location, value.x, value.y); opengl_check;
-		}
-	}
-	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, vec3 const& value, bool expected)
-	{
-		GLint const location = shader.query_uniform_location(name);
-		if (check_location(location, name, shader.id, expected)) {
-			glUniform3f(location, value.x, value.y, value.z); opengl_check;
-		}
-	}
-	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, vec4 const& value, bool expected)
-	{
-		GLint const location = shader.query_uniform_location(name);
-		if (check_location(location, name, shader.id, expected)) {
-			glUniform4f(location, value.x, value.y, value.z, value.w); opengl_check;
-		}
-	}
-	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, float x, float y, bool expected)
-	{
-		GLint const location = shader.query_uniform_location(name);
-		if (check_location(location, name, shader.id, expected)) {
-			glUniform2f(location, x, y);  opengl_check;
-		}
-	}
-	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, float x, float y, float z, bool expected)
-	{
-		GLint const location = shader.query_uniform_location(name);
-		if (check_location(location, name, shader.id, expected)) {
-			glUniform3f(location, x, y, z);  opengl_check;
-		}
-	}
-	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, float x, float y, float z, float w, bool expected)
-	{
-		GLint const location = shader.query_uniform_location(name);
-		if (check_location(location, name, shader.id, expected)) {
-			glUniform4f(location, x, y, z, w);  opengl_check;
-		}
-	}
-	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, mat4 const& m, bool expected)
-	{
-		GLint const location = shader.query_uniform_location(name);
-		if (check_location(location, name, shader.id, expected)) {
-			glUniformMatrix4fv(location, 1, GL_TRUE, ptr(m));  opengl_check;
-		}
-	}
-	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, mat3 const& m, bool expected)
-	{
-		GLint const location = shader.query_uniform_location(name);
-		if (check_location(location, name, shader.id, expected)) {
-			glUniformMatrix3fv(location, 1, GL_TRUE, ptr(m)); opengl_check;
-		}
-	}
-	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, mat2 const& m, bool expected)
-	{
-		GLint const location = shader.query_uniform_location(name);
-		if (check_location(location, name, shader.id, expected)) {
-			glUniformMatrix2fv(location, 1, GL_TRUE, ptr(m)); opengl_check;
+		GLint const location = shader.query_uniform_location(uniform);
+		if (location == -1 && expected) // The name is only read to display the warning
+			check_location(location, uniform.name(), shader.id, expected);
+		if (location != -1) {
+			set_uniform(location, value); opengl_check;
 		}
 	}
 
 
+	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, int value, bool expected) { send_uniform(shader, name, value, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, GLuint value, bool expected) { send_uniform(shader, name, value, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, float value, bool expected) { send_uniform(shader, name, value, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, vec2 const& value, bool expected) { send_uniform(shader, name, value, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, vec3 const& value, bool expected) { send_uniform(shader, name, value, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, vec4 const& value, bool expected) { send_uniform(shader, name, value, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, float x, float y, bool expected) { send_uniform(shader, name, vec2{ x, y }, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, float x, float y, float z, bool expected) { send_uniform(shader, name, vec3{ x, y, z }, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, float x, float y, float z, float w, bool expected) { send_uniform(shader, name, vec4{ x, y, z, w }, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, mat4 const& m, bool expected) { send_uniform(shader, name, m, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, mat3 const& m, bool expected) { send_uniform(shader, name, m, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, mat2 const& m, bool expected) { send_uniform(shader, name, m, expected); }
+
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, int value, bool expected) { send_uniform(shader, uniform, value, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, GLuint value, bool expected) { send_uniform(shader, uniform, value, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, float value, bool expected) { send_uniform(shader, uniform, value, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, vec2 const& value, bool expected) { send_uniform(shader, uniform, value, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, vec3 const& value, bool expected) { send_uniform(shader, uniform, value, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, vec4 const& value, bool expected) { send_uniform(shader, uniform, value, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, mat4 const& m, bool expected) { send_uniform(shader, uniform, m, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, mat3 const& m, bool expected) { send_uniform(shader, uniform, m, expected); }
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, mat2 const& m, bool expected) { send_uniform(shader, uniform, m, expected); }
+
+
 
 	void uniform_generic_structure::send_opengl_uniform(opengl_shader_structure const& shader, bool expected) const
 	{
@@ -133,7 +100,7 @@ namespace cgp
 			opengl_uniform(shader, data.first, data.second, expected);
 		for (auto const& data : uniform_mat3)
 			opengl_uniform(shader, data.first, data.second, expected);
-		for (auto const& data : uniform_mat3)
+		for (auto const& data : uniform_mat4)
 			opengl_uniform(shader, data.first, data.second, expected);
 	}
 
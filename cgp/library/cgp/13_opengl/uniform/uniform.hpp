@@ -45,5 +45,18 @@ namespace cgp
 	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, mat3 const& m, bool expected = true);
 	void opengl_uniform(opengl_shader_structure const& shader, std::string const& name, mat2 const& m, bool expected = true);
 
+	// Same functions from an interned name (see uniform_id): no string lookup once the location is known
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, int value, bool expected = true);
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, GLuint value, bool expected = true);
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, float value, bool expected = true);
+
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, vec2 const& value, bool expected = true);
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, vec3 const& value, bool expected = true);
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, vec4 const& value, bool expected = true);
+
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, mat4 const& m, bool expected = true);
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, mat3 const& m, bool expected = true);
+	void opengl_uniform(opengl_shader_structure const& shader, uniform_id const& uniform, mat2 const& m, bool expected = true);
+
 }
 
@@ -2,6 +2,10 @@
 
 #include "material/material.hpp"
 #include "mesh_drawable/mesh_drawable.hpp"
+#include "lod_mesh_drawable/lod_mesh_drawable.hpp"
+#include "instanced_mesh_drawable/instanced_mesh_drawable.hpp"
+#include "impostor_atlas/impostor_atlas.hpp"
+#include "render_queue/render_queue.hpp"
 #include "triangles_drawable/triangles_drawable.hpp"
 #include "curve_drawable/curve_drawable.hpp"
 #include "curve_drawable_dynamic_extend/curve_drawable_dynamic_extend.hpp"
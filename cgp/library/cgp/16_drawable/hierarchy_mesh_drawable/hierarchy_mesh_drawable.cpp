@@ -11,6 +11,11 @@ namespace cgp
         name_map[node.name] = static_cast<int>(elements.size());
         elements.push_back(node);
         assert_valid_hierarchy(*this);
+
+        // The root parent is not an element of the hierarchy (checked above)
+        auto const it = name_map.find(node.name_parent);
+        parent_index.push_back(it == name_map.end() ? -1 : it->second);
+        transform_local_updated.clear(); // The next update recomputes all the nodes
     }
     void hierarchy_mesh_drawable::add(mesh_drawable const& element, std::string const& name, std::string const& name_parent, vec3 const& translation, rotation_transform const& rotation)
     {
@@ -64,30 +69,39 @@ namespace cgp
         if(elements.size()==0)
             return ;
 
-        assert_valid_hierarchy(*this);
+        int const N = static_cast<int>(elements.size());
+        assert_cgp(int(parent_index.size())==N && int(name_map.size())==N, "Hierarchy not valid - elements must be added with hierarchy_mesh_drawable::add()");
 
-        std::string const& name_root_parent = elements[0].name_parent;
+        // Nodes recomputed by this update: their children are recomputed as well (parents are stored before their children)
+        bool const update_all = int(transform_local_updated.size())!=N;
+        if(update_all)
+            transform_local_updated.resize(N);
+        std::vector<char> changed(N, 0);
 
-        int const N = static_cast<int>(elements.size());
         for(int k=0; k<N; ++k)
         {
             hierarchy_mesh_drawable_node& element = elements[k];
+            int const parent = parent_index[k];
 
-            std::string const& parent_name = element.name_parent;
+            bool const local_changed = update_all || !is_same_transform(element.transform_local, transform_local_updated[k]);
+            bool const parent_changed = parent>=0 && changed[parent];
+            if(!local_changed && !parent_changed)
+                continue;
 
             // Case of root element (or same parent) - local = global
-            if( parent_name == name_root_parent ) {
+            if( parent<0 ) {
                 element.drawable.hierarchy_transform_model = element.transform_local;
             }
             // Else apply hierarchical transformation
             else
             {
-                int const parent_id = name_map[parent_name];
                 affine_rts const& local = element.transform_local;
-                affine_rts const& global_parent = elements[parent_id].drawable.hierarchy_transform_model;
+                affine_rts const& global_parent = elements[parent].drawable.hierarchy_transform_model;
 
                 element.drawable.hierarchy_transform_model = global_parent * local;
             }
+            transform_local_updated[k] = element.transform_local;
+            changed[k] = 1;
         }
     }
 
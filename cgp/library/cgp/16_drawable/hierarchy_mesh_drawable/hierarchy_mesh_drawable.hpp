@@ -43,10 +43,18 @@ namespace cgp
 
 		// Update the global coordinates of the nodes along the hierarchy
 		//  This function must be called before draw, and called again if any hierarchical transform is modified
+		//  Only the nodes whose local transform, or the transform of one of their ancestors, changed since the last call are recomputed:
+		//  a static part of the hierarchy keeps its global transforms and the cached model matrices of its drawables.
 		void update_local_to_global_coordinates();
 
 		// Helper function to display all the hierarchy
 		std::string hierarchy_display() const;
+
+	private:
+		// Index of the parent of each node (-1 for the root parent), updated when a node is added
+		std::vector<int> parent_index;
+		// Local transform of each node used by the last update_local_to_global_coordinates() (empty: not updated yet)
+		std::vector<affine_rts> transform_local_updated;
 	};
 
 	void draw(hierarchy_mesh_drawable const& drawable, environment_generic_structure const& environment = environment_generic_structure(), int instance_count=1, bool expected_uniforms=true, uniform_generic_structure const& additional_uniforms = uniform_generic_structure());
@@ -0,0 +1,126 @@
+#include "impostor_atlas.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/09_geometric_transformation/projection/projection.hpp"
+#include "cgp/12_shape/frustum/frustum.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cgp
+{
+	static float sign_not_zero(float x)
+	{
+		return x >= 0.0f ? 1.0f : -1.0f;
+	}
+
+	vec2 octahedral_encode(vec3 const& d)
+	{
+		float const l1 = std::abs(d.x) + std::abs(d.y) + std::abs(d.z);
+		vec2 p = { d.x / l1, d.y / l1 };
+		if (d.z < 0.0f)
+			p = { (1.0f - std::abs(p.y)) * sign_not_zero(p.x), (1.0f - std::abs(p.x)) * sign_not_zero(p.y) };
+		return 0.5f * p + vec2(0.5f, 0.5f);
+	}
+
+	vec3 octahedral_decode(vec2 const& uv)
+	{
+		vec2 const p = 2.0f * uv - vec2(1.0f, 1.0f);
+		vec3 d = { p.x, p.y, 1.0f - std::abs(p.x) - std::abs(p.y) };
+		if (d.z < 0.0f) {
+			float const x = d.x;
+			d.x = (1.0f - std::abs(d.y)) * sign_not_zero(x);
+			d.y = (1.0f - std::abs(x)) * sign_not_zero(d.y);
+		}
+		return normalize(d);
+	}
+
+	void impostor_view_frame(vec3 const& direction, vec3& right, vec3& up)
+	{
+		vec3 const reference = std::abs(direction.z) < 0.999f ? vec3(0, 0, 1) : vec3(1, 0, 0);
+		right = normalize(cross(reference, direction));
+		up = cross(direction, right);
+	}
+
+
+	void impostor_atlas::bake(mesh_drawable const& drawable, opengl_shader_structure const& bake_shader)
+	{
+		assert_cgp(grid_size > 0 && cell_size > 0, "Incorrect size of impostor atlas (" + str(grid_size) + " views of " + str(cell_size) + " pixels)");
+		assert_cgp(bake_shader.id != 0, "The impostor atlas needs a bake shader");
+
+		vec3 const c = (drawable.bounds.p_min + drawable.bounds.p_max) / 2.0f;
+		vec4 const sphere = transform_bounding_sphere(drawable.model_matrix(), vec4(c, norm(drawable.bounds.p_max - drawable.bounds.p_min) / 2.0f));
+		center = sphere.xyz();
+		radius = sphere.w;
+
+		int const size = grid_size * cell_size;
+		if (color.id == 0 || color.width != size) {
+			clear();
+			color.initialize(size, size, GL_RGBA8);
+			normal.initialize(size, size, GL_RGBA8);
+		}
+
+		mesh_drawable baked = drawable; // Shares the buffers of drawable
+		baked.shader = bake_shader;
+		uniform_generic_structure uniforms;
+		uniforms.uniform_mat4["projection"] = projection_orthographic(-radius, radius, -radius, radius, radius, 3 * radius);
+
+		GLint viewport[4];
+		glGetIntegerv(GL_VIEWPORT, viewport);
+		GLboolean const depth_test = glIsEnabled(GL_DEPTH_TEST);
+		glEnable(GL_DEPTH_TEST);
+		for (int pass = 0; pass < 2; ++pass) {
+			opengl_fbo_structure const& target = pass == 0 ? color : normal;
+			uniforms.uniform_int["bake_normal"] = pass;
+
+			glBindFramebuffer(GL_FRAMEBUFFER, target.id);
+			glViewport(0, 0, size, size);
+			glClearColor(0, 0, 0, 0);
+			glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+			for (int j = 0; j < grid_size; ++j) {
+				for (int i = 0; i < grid_size; ++i) {
+					// Camera at 2*radius from the center along the direction of the cell, looking at the center
+					vec3 const d = cell_direction(i, j);
+					vec3 right, up;
+					impostor_view_frame(d, right, up);
+					mat3 const R = mat3(right, up, d);
+					uniforms.uniform_mat4["view"] = mat4::build_affine(R, -(R * (center + 2 * radius * d)));
+
+					glViewport(i * cell_size, j * cell_size, cell_size, cell_size);
+					draw(baked, environment_generic_structure(), 1, false, uniforms);
+				}
+			}
+		}
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+		if (!depth_test)
+			glDisable(GL_DEPTH_TEST);
+		opengl_check;
+	}
+
+	int impostor_atlas::cell(vec3 const& direction) const
+	{
+		vec2 const uv = octahedral_encode(normalize(direction));
+		int const i = std::min(std::max(int(uv.x * grid_size), 0), grid_size - 1);
+		int const j = std::min(std::max(int(uv.y * grid_size), 0), grid_size - 1);
+		return i + grid_size * j;
+	}
+
+	vec3 impostor_atlas::cell_direction(int i, int j) const
+	{
+		return octahedral_decode(vec2((i + 0.5f) / grid_size, (j + 0.5f) / grid_size));
+	}
+
+	void impostor_atlas::clear()
+	{
+		for (opengl_fbo_structure* fbo : { &color, &normal }) {
+			if (fbo->id == 0)
+				continue;
+			fbo->texture.clear();
+			glDeleteRenderbuffers(1, &fbo->depth_buffer_id);
+			glDeleteFramebuffers(1, &fbo->id);
+			fbo->id = 0;
+			fbo->depth_buffer_id = 0;
+		}
+	}
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "cgp/16_drawable/mesh_drawable/mesh_drawable.hpp"
+#include "cgp/13_opengl/fbo/fbo.hpp"
+
+namespace cgp
+{
+	// Octahedral mapping between the unit directions and [0,1]^2 (upper hemisphere in the central diamond, lower hemisphere folded on the corners)
+	vec2 octahedral_encode(vec3 const& direction);
+	vec3 octahedral_decode(vec2 const& uv);
+
+	// Axes of the image of a view along direction (the camera looks toward -direction): (right, up, direction) is a direct orthonormal frame
+	//  up is the projection of the z axis, or of the x axis for a direction close to z
+	void impostor_view_frame(vec3 const& direction, vec3& right, vec3& up);
+
+
+	// Views of a mesh from grid_size x grid_size directions (octahedral layout) baked in a texture atlas
+	//  Used to draw a distant mesh as a camera-facing quad textured with the view closest to the camera direction.
+	//  Two atlases are baked: the albedo (coverage in alpha), and the normals in the frame of the mesh (encoded as 0.5*n+0.5) to light the quads in the shader.
+	//  The cell (i,j) of an atlas stores the view along octahedral_decode((i+0.5, j+0.5)/grid_size), with the image axes of impostor_view_frame
+	//  and an orthographic projection of the bounding sphere (center, radius).
+	struct impostor_atlas
+	{
+		int grid_size = 8;  // Number of views along each side of the atlas
+		int cell_size = 64; // Size in pixels of each view
+
+		vec3 center;        // Bounding sphere of the mesh placed by the model of the baked drawable
+		float radius = 0.0f;
+
+		opengl_fbo_structure color;
+		opengl_fbo_structure normal;
+
+		// Render the views of the drawable (placed by its model) with bake_shader
+		//  bake_shader reads the uniforms projection and view (not the environment), and outputs the albedo or the normal depending on the uniform int bake_normal.
+		void bake(mesh_drawable const& drawable, opengl_shader_structure const& bake_shader);
+
+		// Cell (i + grid_size * j) of the view closest to a direction in the frame of the mesh (same choice as the shaders)
+		int cell(vec3 const& direction) const;
+		vec3 cell_direction(int i, int j) const;
+
+		void clear();
+	};
+}
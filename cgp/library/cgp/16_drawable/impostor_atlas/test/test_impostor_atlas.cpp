@@ -0,0 +1,57 @@
+#include "test_impostor_atlas.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "../impostor_atlas.hpp"
+
+using namespace cgp;
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	void test_impostor_atlas()
+	{
+		// Octahedral mapping: round trip, and poles/equator at their expected place
+		{
+			vec3 const directions[] = { {0,0,1}, {0,0,-1}, {1,0,0}, {0,-1,0}, normalize(vec3{1,2,3}), normalize(vec3{-2,1,-0.5f}), normalize(vec3{0.3f,-0.7f,-2}) };
+			for (vec3 const& d : directions) {
+				vec2 const uv = octahedral_encode(d);
+				assert_cgp_no_msg(uv.x >= 0 && uv.x <= 1 && uv.y >= 0 && uv.y <= 1);
+				assert_cgp_no_msg(is_equal(octahedral_decode(uv), d));
+			}
+			assert_cgp_no_msg(is_equal(octahedral_encode(vec3{ 0,0,1 }), vec2{ 0.5f,0.5f }));
+			assert_cgp_no_msg(is_equal(octahedral_encode(vec3{ 1,0,0 }), vec2{ 1.0f,0.5f }));
+		}
+
+		// View frames are direct and orthonormal, with the image up along z when possible
+		{
+			vec3 const directions[] = { {1,0,0}, {0,0,1}, {0,0,-1}, normalize(vec3{1,-2,0.5f}) };
+			for (vec3 const& d : directions) {
+				vec3 right, up;
+				impostor_view_frame(d, right, up);
+				assert_cgp_no_msg(is_equal(norm(right), 1.0f) && is_equal(norm(up), 1.0f));
+				assert_cgp_no_msg(std::abs(dot(right, up)) < 1e-5f && std::abs(dot(right, d)) < 1e-5f && std::abs(dot(up, d)) < 1e-5f);
+				assert_cgp_no_msg(is_equal(cross(right, up), d));
+			}
+			vec3 right, up;
+			impostor_view_frame(vec3{ 1,0,0 }, right, up);
+			assert_cgp_no_msg(is_equal(up, vec3{ 0,0,1 }));
+		}
+
+		// Each cell is selected by its own direction, and the selected view is the closest one among the neighbor cells
+		{
+			impostor_atlas atlas;
+			atlas.grid_size = 8;
+			for (int j = 0; j < atlas.grid_size; ++j)
+				for (int i = 0; i < atlas.grid_size; ++i)
+					assert_cgp_no_msg(atlas.cell(atlas.cell_direction(i, j)) == i + atlas.grid_size * j);
+
+			vec3 const d = normalize(vec3{ 0.4f,-0.2f,0.6f });
+			int const k = atlas.cell(d);
+			vec3 const selected = atlas.cell_direction(k % atlas.grid_size, k / atlas.grid_size);
+			assert_cgp_no_msg(dot(selected, d) > 0.9f);
+		}
+	}
+}
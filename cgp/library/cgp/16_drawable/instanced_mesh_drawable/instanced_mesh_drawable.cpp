@@ -0,0 +1,244 @@
+#include "instanced_mesh_drawable.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/11_mesh/simplification/simplification.hpp"
+
+#include <algorithm>
+
+namespace cgp
+{
+	opengl_shader_structure instanced_mesh_drawable::default_shader;
+
+	// Per-instance VBOs are the supplementary_vbo of the drawable, at index (location - 4)
+	static int const location_color = 4;
+	static int const location_matrix = 5; // 4 consecutive locations (one per column)
+	static int const instance_vbo_count = 5;
+
+	void instanced_mesh_drawable::initialize_data_on_gpu(mesh const& data, opengl_shader_structure const& shader, opengl_texture_image_structure const& texture)
+	{
+		drawable.initialize_data_on_gpu(data, shader, texture);
+		instance_count = 0;
+	}
+
+	void instanced_mesh_drawable::initialize_data_on_gpu(mesh_view const& data, opengl_shader_structure const& shader, opengl_texture_image_structure const& texture)
+	{
+		drawable.initialize_data_on_gpu(data, shader, texture);
+		instance_count = 0;
+	}
+
+	void instanced_mesh_drawable::update_instances(std::vector<affine> const& transforms, numarray<vec3> const& colors)
+	{
+		std::vector<mat4> matrices(transforms.size());
+		for (size_t k = 0; k < transforms.size(); ++k)
+			matrices[k] = transforms[k].matrix();
+		update_instances(matrices, colors);
+	}
+
+	void instanced_mesh_drawable::update_instances(std::vector<mat4> const& matrices, numarray<vec3> const& colors)
+	{
+		int const N = int(matrices.size());
+		assert_cgp(colors.size() == 0 || int(colors.size()) == N, "Instance colors must be empty or have one color per instance (" + str(colors.size()) + " colors for " + str(N) + " instances)");
+		assert_cgp(drawable.vao != 0, "Call initialize_data_on_gpu before update_instances");
+
+		instance_matrices = matrices;
+		instance_colors = colors;
+		if (instance_colors.size() == 0)
+			instance_colors.resize(N).fill(vec3{ 1,1,1 });
+		instance_visible.assign(N, 1);
+		margin_spheres = -1.0f;
+
+		send_instances(instance_matrices, instance_colors);
+	}
+
+	int instanced_mesh_drawable::cull(frustum const& view_frustum, float margin, occlusion_buffer const* occlusion, lod_view const* view)
+	{
+		int const N = int(instance_matrices.size());
+		if (N == 0)
+			return 0;
+
+		// Bounding spheres recomputed only when the instances, the model or the margin change
+		if (margin != margin_spheres || !is_same_transform(drawable.model, model_spheres)) {
+			vec3 const center = (drawable.bounds.p_min + drawable.bounds.p_max) / 2.0f;
+			float const radius = norm(drawable.bounds.p_max - drawable.bounds.p_min) / 2.0f;
+			mat4 const M = drawable.model.matrix();
+			instance_spheres.resize(N);
+			instance_boxes.resize(N);
+			for (int k = 0; k < N; ++k) {
+				vec4& sphere = instance_spheres[k];
+				sphere = transform_bounding_sphere(instance_matrices[k] * M, vec4(center, radius));
+				sphere.w += margin;
+				instance_boxes[k].p_min = sphere.xyz() - vec3(sphere.w, sphere.w, sphere.w);
+				instance_boxes[k].p_max = sphere.xyz() + vec3(sphere.w, sphere.w, sphere.w);
+			}
+			model_spheres = drawable.model;
+			margin_spheres = margin;
+		}
+
+		// The lower levels follow the parameters of drawable even when the visible instances do not change (ex. texture set after initialize_lod)
+		for (mesh_drawable& level : lod_level)
+			lod_copy_parameters(drawable, level);
+
+		std::vector<unsigned char> visible(N);
+		view_frustum.cull_spheres(instance_spheres.data.data(), N, visible.data());
+		if (occlusion != nullptr)
+			occlusion->cull_boxes(instance_boxes.data(), N, visible.data());
+		int const levels = view != nullptr ? level_count() : 1;
+		if (levels > 1) {
+			for (int k = 0; k < N; ++k)
+				if (visible[k])
+					visible[k] = (unsigned char)(1 + cgp::lod_level(view->screen_size(instance_spheres[k].xyz(), instance_spheres[k].w), lod_detail_screen_size, levels));
+		}
+		if (visible == instance_visible)
+			return instance_count;
+
+		instance_visible = visible;
+		lod_instance_count.assign(level_count(), 0);
+		instance_count = 0;
+		for (int level = 0; level < levels; ++level) {
+			std::vector<mat4> matrices;
+			numarray<vec3> colors;
+			for (int k = 0; k < N; ++k) {
+				if (visible[k] == level + 1) {
+					matrices.push_back(instance_matrices[k]);
+					colors.push_back(instance_colors[k]);
+				}
+			}
+			if (level == 0) {
+				send_instances(drawable, matrices, colors);
+			}
+			else if (matrices.size() > 0) {
+				send_instances(lod_level[level - 1], matrices, colors);
+			}
+			lod_instance_count[level] = int(matrices.size());
+			instance_count += int(matrices.size());
+		}
+		return instance_count;
+	}
+
+	void instanced_mesh_drawable::uncull()
+	{
+		int const N = int(instance_matrices.size());
+		if (std::count(instance_visible.begin(), instance_visible.end(), 1) == N)
+			return;
+		instance_visible.assign(N, 1);
+		send_instances(instance_matrices, instance_colors);
+	}
+
+	int instanced_mesh_drawable::instance_count_total() const
+	{
+		return int(instance_matrices.size());
+	}
+
+	void instanced_mesh_drawable::initialize_lod(mesh const& data, int level_count, float reduction)
+	{
+		assert_cgp(drawable.vao != 0, "Call initialize_data_on_gpu before initialize_lod");
+		initialize_lod(mesh_lod_chain(data, level_count, reduction));
+	}
+
+	void instanced_mesh_drawable::initialize_lod(std::vector<mesh> const& chain)
+	{
+		assert_cgp(drawable.vao != 0, "Call initialize_data_on_gpu before initialize_lod");
+		assert_cgp(chain.size() > 0, "The chain of levels of detail must contain at least the full resolution mesh");
+		for (mesh_drawable& level : lod_level)
+			level.clear();
+		lod_level.resize(chain.size() - 1);
+		for (size_t k = 1; k < chain.size(); ++k) {
+			mesh m = chain[k];
+			m.fill_empty_field();
+			lod_level[k - 1].initialize_data_on_gpu(m, drawable.shader, drawable.texture);
+		}
+		lod_instance_count.resize(chain.size(), 0);
+		instance_visible.clear(); // Levels sent again by the next cull
+	}
+
+	int instanced_mesh_drawable::level_count() const
+	{
+		return 1 + int(lod_level.size());
+	}
+
+	mesh_drawable const& instanced_mesh_drawable::level_drawable(int k) const
+	{
+		return k == 0 ? drawable : lod_level[k - 1];
+	}
+
+	int instanced_mesh_drawable::triangle_count() const
+	{
+		int count = 0;
+		for (int k = 0; k < int(lod_instance_count.size()); ++k)
+			count += lod_instance_count[k] * int(level_drawable(k).ebo_connectivity.size);
+		return count;
+	}
+
+	void instanced_mesh_drawable::send_instances(std::vector<mat4> const& matrices, numarray<vec3> const& color)
+	{
+		send_instances(drawable, matrices, color);
+		instance_count = int(matrices.size());
+		lod_instance_count.assign(level_count(), 0);
+		lod_instance_count[0] = instance_count;
+	}
+
+	void instanced_mesh_drawable::send_instances(mesh_drawable& target, std::vector<mat4> const& matrices, numarray<vec3> const& color)
+	{
+		int const N = int(matrices.size());
+		if (N == 0)
+			return;
+
+		numarray<vec4> columns[4];
+		for (int c = 0; c < 4; ++c)
+			columns[c].resize(N);
+		for (int k = 0; k < N; ++k) {
+			columns[0][k] = matrices[k].col_x();
+			columns[1][k] = matrices[k].col_y();
+			columns[2][k] = matrices[k].col_z();
+			columns[3][k] = matrices[k].col_w();
+		}
+
+		// Allocate the per-instance VBOs at the first call, or when there are more instances than their size
+		std::vector<opengl_vbo_structure>& vbo = target.supplementary_vbo;
+		bool const allocate = int(vbo.size()) < instance_vbo_count || N > int(vbo[location_color - 4].size);
+		if (allocate) {
+			for (opengl_vbo_structure& buffer : vbo)
+				if (buffer.id != 0)
+					buffer.clear();
+			target.initialize_supplementary_data_on_gpu(color, location_color, 1);
+			for (int c = 0; c < 4; ++c)
+				target.initialize_supplementary_data_on_gpu(columns[c], location_matrix + c, 1);
+		}
+		else {
+			vbo[location_color - 4].update(color, N);
+			for (int c = 0; c < 4; ++c)
+				vbo[location_matrix + c - 4].update(columns[c], N);
+		}
+	}
+
+	void instanced_mesh_drawable::clear()
+	{
+		drawable.clear();
+		drawable.supplementary_vbo.clear();
+		instance_count = 0;
+		instance_matrices.clear();
+		instance_colors.clear();
+		instance_spheres.clear();
+		instance_boxes.clear();
+		instance_visible.clear();
+		margin_spheres = -1.0f;
+		for (mesh_drawable& level : lod_level)
+			level.clear();
+		lod_level.clear();
+		lod_instance_count.clear();
+	}
+
+	void draw(instanced_mesh_drawable const& instances, environment_generic_structure const& environment, bool expected_uniforms, uniform_generic_structure const& additional_uniforms)
+	{
+		for (int k = 0; k < int(instances.lod_instance_count.size()); ++k)
+			if (instances.lod_instance_count[k] > 0)
+				draw(instances.level_drawable(k), environment, instances.lod_instance_count[k], expected_uniforms, additional_uniforms);
+	}
+
+	void draw_wireframe(instanced_mesh_drawable const& instances, environment_generic_structure const& environment, vec3 const& color)
+	{
+		for (int k = 0; k < int(instances.lod_instance_count.size()); ++k)
+			if (instances.lod_instance_count[k] > 0)
+				draw_wireframe(instances.level_drawable(k), environment, color, instances.lod_instance_count[k]);
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "cgp/16_drawable/mesh_drawable/mesh_drawable.hpp"
+#include "cgp/16_drawable/lod_mesh_drawable/lod_mesh_drawable.hpp"
+#include "cgp/12_shape/frustum/frustum.hpp"
+#include "cgp/12_shape/occlusion_buffer/occlusion_buffer.hpp"
+
+#include <vector>
+
+namespace cgp
+{
+	// Copies of a mesh drawn with a single instanced draw call (ex. plants or rocks scattered on a terrain)
+	//  Each instance has its own transform and color, stored in per-instance VBOs of the drawable:
+	//    location 4: color (vec3), locations 5 to 8: columns of the instance matrix (vec4)
+	//  The position computed by the shader is: instance_matrix * model * vertex_position (model is shared by all the instances)
+	//  The instances are only sent to the GPU by update_instances: static instances cost no CPU time at each frame.
+	struct instanced_mesh_drawable
+	{
+		static opengl_shader_structure default_shader; // default instanced mesh shader shared by all instanced_mesh_drawable
+
+		mesh_drawable drawable; // Shared mesh, shader, texture, material and model
+		int instance_count = 0; // Number of instances drawn (the visible ones after cull), at all the levels of detail
+
+		// Optional levels of detail (see initialize_lod): lod_level[k-1] draws the instances at level k with its own per-instance VBOs
+		std::vector<mesh_drawable> lod_level;
+		std::vector<int> lod_instance_count; // Number of instances drawn at each level (level 0: drawable)
+		float lod_detail_screen_size = 0.25f; // Projected size (fraction of the screen height) below which the level 1 is used
+
+		// Fill the VBO and VAO of the mesh (the shader must read the per-instance attributes)
+		void initialize_data_on_gpu(mesh const& data, opengl_shader_structure const& shader = default_shader, opengl_texture_image_structure const& texture = mesh_drawable::default_texture);
+		void initialize_data_on_gpu(mesh_view const& data, opengl_shader_structure const& shader = default_shader, opengl_texture_image_structure const& texture = mesh_drawable::default_texture);
+
+		// Send the instances to the GPU (colors: one per instance, or empty for white instances)
+		//  Call it again when the instances change: the VBOs are only re-allocated if the number of instances grows.
+		void update_instances(std::vector<affine> const& transforms, numarray<vec3> const& colors = numarray<vec3>());
+		void update_instances(std::vector<mat4> const& matrices, numarray<vec3> const& colors = numarray<vec3>());
+
+		// Build the lower levels of detail of the mesh (mesh_lod_chain): a cull with a lod_view draws each instance at the level of its projected size
+		//  The levels use the shader, textures, material and model of drawable at the time of the last cull.
+		void initialize_lod(mesh const& data, int level_count = 4, float reduction = 0.25f);
+		// Same with a chain already computed (ex. on another thread): chain[0] is the mesh of drawable, the next ones are the levels
+		void initialize_lod(std::vector<mesh> const& chain);
+
+		// Only draw the instances whose bounding sphere (bounding box of the mesh transformed by instance_matrix * model) intersects the frustum
+		//  margin: added to the radius of the spheres (ex. vertices moved by the shader)
+		//  occlusion: if given, the instances whose box around the sphere is hidden behind its occluders are not drawn either
+		//  view: if given (and initialize_lod was called), each visible instance is drawn at the level of detail of its projected size
+		//  The visible instances are sent to the GPU only when they (or their levels) differ from the previous call: a static view only costs the batch test of the spheres.
+		//  Return the number of visible instances (= instance_count).
+		int cull(frustum const& view_frustum, float margin = 0.0f, occlusion_buffer const* occlusion = nullptr, lod_view const* view = nullptr);
+		// Draw all the instances again, at full resolution
+		void uncull();
+		// Number of instances given to update_instances (visible or not)
+		int instance_count_total() const;
+
+		int level_count() const;
+		// Drawable of the level k (level 0: drawable)
+		mesh_drawable const& level_drawable(int k) const;
+		// Number of triangles drawn for all the instances
+		int triangle_count() const;
+
+		void clear();
+
+	private:
+		std::vector<mat4> instance_matrices; // Copy of the instances, to send the visible ones after cull
+		numarray<vec3> instance_colors;
+		numarray<vec4> instance_spheres;     // Bounding sphere of each instance (center, radius) for model_spheres and margin_spheres
+		std::vector<bounding_box> instance_boxes; // Box around each sphere (occlusion test)
+		affine model_spheres;
+		float margin_spheres = -1.0f;        // < 0: spheres to compute
+		std::vector<unsigned char> instance_visible; // 0: hidden, otherwise 1 + level of detail
+
+		void send_instances(std::vector<mat4> const& matrices, numarray<vec3> const& colors);
+		static void send_instances(mesh_drawable& target, std::vector<mat4> const& matrices, numarray<vec3> const& colors);
+	};
+
+	void draw(instanced_mesh_drawable const& instances, environment_generic_structure const& environment = environment_generic_structure(), bool expected_uniforms = true, uniform_generic_structure const& additional_uniforms = uniform_generic_structure());
+	void draw_wireframe(instanced_mesh_drawable const& instances, environment_generic_structure const& environment = environment_generic_structure(), vec3 const& color = { 0,0,1 });
+}
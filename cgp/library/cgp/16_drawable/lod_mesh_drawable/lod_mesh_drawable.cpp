@@ -0,0 +1,106 @@
+#include "lod_mesh_drawable.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/11_mesh/simplification/simplification.hpp"
+#include "cgp/12_shape/frustum/frustum.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace cgp
+{
+	lod_view lod_view::from_matrix(mat4 const& projection, mat4 const& view)
+	{
+		// view = [R t; 0 1]: the camera is at -R^T t
+		mat3 const R = view.get_block_linear();
+		vec3 const t = view.col_w_vec3();
+
+		lod_view v;
+		v.camera_position = -(transpose(R) * t);
+		v.projection_scale = projection(1, 1);
+		return v;
+	}
+
+	float lod_view::screen_size(vec3 const& center, float radius) const
+	{
+		float const distance = std::max(norm(center - camera_position), 1e-6f);
+		return radius * projection_scale / distance;
+	}
+
+	int lod_level(float screen_size, float detail_screen_size, int level_count)
+	{
+		if (screen_size >= detail_screen_size || level_count <= 1)
+			return 0;
+		int const k = 1 + int(std::floor(std::log2(detail_screen_size / std::max(screen_size, 1e-12f))));
+		return std::min(k, level_count - 1);
+	}
+
+	void lod_copy_parameters(mesh_drawable const& reference, mesh_drawable& level)
+	{
+		level.shader = reference.shader;
+		level.texture = reference.texture;
+		level.supplementary_texture = reference.supplementary_texture;
+		level.model = reference.model;
+		level.hierarchy_transform_model = reference.hierarchy_transform_model;
+		level.supplementary_model_matrix = reference.supplementary_model_matrix;
+		level.material = reference.material;
+	}
+
+
+	void lod_mesh_drawable::initialize_data_on_gpu(mesh const& data, opengl_shader_structure const& shader, opengl_texture_image_structure const& texture, int level_count, float reduction)
+	{
+		initialize_data_on_gpu(mesh_lod_chain(data, level_count, reduction), shader, texture);
+	}
+
+	void lod_mesh_drawable::initialize_data_on_gpu(std::vector<mesh> const& chain, opengl_shader_structure const& shader, opengl_texture_image_structure const& texture)
+	{
+		assert_cgp(chain.size() > 0, "The chain of levels of detail must contain at least the full resolution mesh");
+		drawable.initialize_data_on_gpu(chain[0], shader, texture);
+		level.resize(chain.size() - 1);
+		for (size_t k = 1; k < chain.size(); ++k) {
+			mesh m = chain[k];
+			m.fill_empty_field();
+			level[k - 1].initialize_data_on_gpu(m, shader, texture);
+		}
+	}
+
+	int lod_mesh_drawable::level_count() const
+	{
+		return 1 + int(level.size());
+	}
+
+	int lod_mesh_drawable::triangle_count(int k) const
+	{
+		mesh_drawable const& d = k == 0 ? drawable : level[k - 1];
+		return int(d.ebo_connectivity.size);
+	}
+
+	int lod_mesh_drawable::select_level(lod_view const& view) const
+	{
+		vec3 const center = (drawable.bounds.p_min + drawable.bounds.p_max) / 2.0f;
+		vec4 const sphere = transform_bounding_sphere(drawable.model_matrix(), vec4(center, norm(drawable.bounds.p_max - drawable.bounds.p_min) / 2.0f));
+		return lod_level(view.screen_size(sphere.xyz(), sphere.w), detail_screen_size, level_count());
+	}
+
+	mesh_drawable const& lod_mesh_drawable::level_drawable(int k)
+	{
+		assert_cgp(k >= 0 && k < level_count(), "Incorrect level of detail " + str(k) + " (" + str(level_count()) + " levels)");
+		if (k == 0)
+			return drawable;
+		lod_copy_parameters(drawable, level[k - 1]);
+		return level[k - 1];
+	}
+
+	void lod_mesh_drawable::clear()
+	{
+		drawable.clear();
+		for (mesh_drawable& d : level)
+			d.clear();
+		level.clear();
+	}
+
+	void draw(lod_mesh_drawable& drawable, lod_view const& view, environment_generic_structure const& environment)
+	{
+		draw(drawable.level_drawable(drawable.select_level(view)), environment);
+	}
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "cgp/16_drawable/mesh_drawable/mesh_drawable.hpp"
+
+#include <vector>
+
+namespace cgp
+{
+	// Camera parameters used to choose the levels of detail
+	struct lod_view
+	{
+		vec3 camera_position;
+		float projection_scale = 1.0f; // 1/tan(field_of_view/2): projected size of a unit length at unit distance, relative to the half height of the screen
+
+		static lod_view from_matrix(mat4 const& projection, mat4 const& view);
+
+		// Projected diameter of a sphere, as a fraction of the screen height
+		float screen_size(vec3 const& center, float radius) const;
+	};
+
+	// Level of detail for a projected size: 0 above detail_screen_size, then one more level each time the size is halved
+	//  (between two levels of mesh_lod_chain with a reduction of 1/4, the triangles keep about the same size on the screen)
+	int lod_level(float screen_size, float detail_screen_size, int level_count);
+
+	// Copy the shader, textures, material and transforms of the full resolution drawable to a level of detail (which keeps its own VAO and buffers)
+	void lod_copy_parameters(mesh_drawable const& reference, mesh_drawable& level);
+
+
+	// Mesh drawn with fewer triangles when it gets small on the screen
+	//  drawable is the full resolution (level 0): its shader, textures, material and model are used by all the levels.
+	//  The lower levels are computed at initialization by mesh_lod_chain (quadric simplification).
+	struct lod_mesh_drawable
+	{
+		mesh_drawable drawable;
+		std::vector<mesh_drawable> level; // level[k-1] is the level of detail k (only its VAO and buffers are used)
+		float detail_screen_size = 0.25f; // Projected size (fraction of the screen height) below which the level 1 is used
+
+		void initialize_data_on_gpu(mesh const& data, opengl_shader_structure const& shader = mesh_drawable::default_shader, opengl_texture_image_structure const& texture = mesh_drawable::default_texture, int level_count = 4, float reduction = 0.25f);
+		// Levels given by the caller (ex. computed offline): chain[0] is the full resolution
+		void initialize_data_on_gpu(std::vector<mesh> const& chain, opengl_shader_structure const& shader = mesh_drawable::default_shader, opengl_texture_image_structure const& texture = mesh_drawable::default_texture);
+
+		int level_count() const;
+		int triangle_count(int k) const;
+
+		// Level for the bounding sphere of the mesh placed by the model of drawable
+		int select_level(lod_view const& view) const;
+
+		// Drawable of the level k, with the parameters of drawable
+		mesh_drawable const& level_drawable(int k);
+
+		void clear();
+	};
+
+	// Draw the level of detail selected for the view
+	void draw(lod_mesh_drawable& drawable, lod_view const& view, environment_generic_structure const& environment = environment_generic_structure());
+}
@@ -7,19 +7,30 @@
 
 namespace cgp
 {
+	// Names of the uniforms interned once (sent at every draw call)
+	static uniform_id const uniform_color("material.color");
+	static uniform_id const uniform_alpha("material.alpha");
+	static uniform_id const uniform_ambient("material.phong.ambient");
+	static uniform_id const uniform_diffuse("material.phong.diffuse");
+	static uniform_id const uniform_specular("material.phong.specular");
+	static uniform_id const uniform_specular_exponent("material.phong.specular_exponent");
+	static uniform_id const uniform_use_texture("material.texture_settings.use_texture");
+	static uniform_id const uniform_texture_inverse_v("material.texture_settings.texture_inverse_v");
+	static uniform_id const uniform_two_sided("material.texture_settings.two_sided");
+
 	void material_mesh_drawable_phong::send_opengl_uniform(opengl_shader_structure const& shader, bool expected) const
 	{
-		opengl_uniform(shader, "material.color", color, expected);
-		opengl_uniform(shader, "material.alpha", alpha, expected);
+		opengl_uniform(shader, uniform_color, color, expected);
+		opengl_uniform(shader, uniform_alpha, alpha, expected);
 
-		opengl_uniform(shader, "material.phong.ambient", phong.ambient, expected);
-		opengl_uniform(shader, "material.phong.diffuse", phong.diffuse, expected);
-		opengl_uniform(shader, "material.phong.specular", phong.specular, expected);
-		opengl_uniform(shader, "material.phong.specular_exponent", phong.specular_exponent, expected);
+		opengl_uniform(shader, uniform_ambient, phong.ambient, expected);
+		opengl_uniform(shader, uniform_diffuse, phong.diffuse, expected);
+		opengl_uniform(shader, uniform_specular, phong.specular, expected);
+		opengl_uniform(shader, uniform_specular_exponent, phong.specular_exponent, expected);
 
-		opengl_uniform(shader, "material.texture_settings.use_texture", texture_settings.active, expected);
-		opengl_uniform(shader, "material.texture_settings.texture_inverse_v", texture_settings.inverse_v, expected);
-		opengl_uniform(shader, "material.texture_settings.two_sided", texture_settings.two_sided, expected);
+		opengl_uniform(shader, uniform_use_texture, int(texture_settings.active), expected);
+		opengl_uniform(shader, uniform_texture_inverse_v, int(texture_settings.inverse_v), expected);
+		opengl_uniform(shader, uniform_two_sided, int(texture_settings.two_sided), expected);
 	}
 
 }
\ No newline at end of file
@@ -11,6 +11,10 @@ namespace cgp
 	opengl_shader_structure mesh_drawable::default_shader;
 	opengl_texture_image_structure mesh_drawable::default_texture;
 
+	static uniform_id const uniform_model("model");
+	static uniform_id const uniform_model_normal("modelNormal");
+	static uniform_id const uniform_image_texture("image_texture");
+
 	static void warning_initialize_non_empty();
 
 	void mesh_drawable::initialize_data_on_gpu(mesh const& data, opengl_shader_structure const& shader_arg, opengl_texture_image_structure const& texture_arg)
@@ -18,19 +22,30 @@ namespace cgp
 		// Error detection before sending the data to avoid unexpected behavior
 		// *********************************************************************** //
 
+		if (data.position.size() == 0) {
+			warning_cgp("Warning try to generate mesh_drawable with 0 vertex", "");
+			return;
+		}
+
+		// Sanity check before sending mesh data to GPU
+		assert_cgp(mesh_check(data), "Cannot send this mesh data to GPU in initializing mesh_drawable");
+
+		initialize_data_on_gpu(mesh_view_of(data), shader_arg, texture_arg);
+	}
+
+	void mesh_drawable::initialize_data_on_gpu(mesh_view const& data, opengl_shader_structure const& shader_arg, opengl_texture_image_structure const& texture_arg)
+	{
 		opengl_check;
 
 		// Check if this mesh_drawable is already initialized
 		if (vao != 0 || vbo_position.size != 0)
 			warning_initialize_non_empty();
 
-		if (data.position.size() == 0) {
+		if (data.vertex_count == 0) {
 			warning_cgp("Warning try to generate mesh_drawable with 0 vertex", "");
 			return;
 		}
-
-		// Sanity check before sending mesh data to GPU
-		assert_cgp(mesh_check(data), "Cannot send this mesh data to GPU in initializing mesh_drawable");
+		assert_cgp(data.position != nullptr && data.connectivity != nullptr, "The mesh_view must have positions and a connectivity");
 
 
 		// Variable initialization
@@ -42,17 +57,20 @@ namespace cgp
 		model = affine();
 		material = material_mesh_drawable_phong();
 		supplementary_model_matrix = mat4::build_identity();
+		bounds.p_min = data.p_min;
+		bounds.p_max = data.p_max;
 
 
-		// Send the data to the GPU
+		// Send the data to the GPU (the absent arrays give empty VBOs)
 		// ******************************************** //
 
-		vbo_position.initialize_data_on_gpu(data.position);
-		vbo_normal.initialize_data_on_gpu(data.normal);
-		vbo_color.initialize_data_on_gpu(data.color);
-		vbo_uv.initialize_data_on_gpu(data.uv);
+		int const N = data.vertex_count;
+		vbo_position.initialize_data_on_gpu(data.position, N);
+		vbo_normal.initialize_data_on_gpu(data.normal, data.normal != nullptr ? N : 0);
+		vbo_color.initialize_data_on_gpu(data.color, data.color != nullptr ? N : 0);
+		vbo_uv.initialize_data_on_gpu(data.uv, data.uv != nullptr ? N : 0);
 
-		ebo_connectivity.initialize_data_on_gpu(data.connectivity);
+		ebo_connectivity.initialize_data_on_gpu(data.connectivity, data.triangle_count);
 
 
 		// Generate VAO 
@@ -158,7 +176,7 @@ namespace cgp
 		// ********************************** //
 		glActiveTexture(GL_TEXTURE0); opengl_check;
 		drawable.texture.bind();
-		opengl_uniform(drawable.shader, "image_texture", 0);  opengl_check;
+		opengl_uniform(drawable.shader, uniform_image_texture, 0);  opengl_check;
 
 		//Set any additional texture
 		int texture_count = 1;
@@ -219,13 +237,25 @@ namespace cgp
 
 	void mesh_drawable::send_opengl_uniform(bool expected) const
 	{
-		// Final model matrix in the shader is: hierarchy_transform_model * model
-		mat4 const model_shader = hierarchy_transform_model.matrix() * supplementary_model_matrix * model.matrix();
+		// Final model matrix in the shader is: hierarchy_transform_model * supplementary_model_matrix * model
+		model_cache.update(hierarchy_transform_model, supplementary_model_matrix, model);
 
-		// set the Model matrix
-		opengl_uniform(shader, "model", model_shader, expected);
+		// set the Model matrix, and the normal matrix for the shaders using it
+		opengl_uniform(shader, uniform_model, model_cache.matrix, expected);
+		opengl_uniform(shader, uniform_model_normal, model_cache.normal_matrix, false);
 
 		// set the material
 		material.send_opengl_uniform(shader, expected);
 	}
-}
+
+	mat4 const& mesh_drawable::model_matrix() const
+	{
+		model_cache.update(hierarchy_transform_model, supplementary_model_matrix, model);
+		return model_cache.matrix;
+	}
+	mat3 const& mesh_drawable::normal_matrix() const
+	{
+		model_cache.update(hierarchy_transform_model, supplementary_model_matrix, model);
+		return model_cache.normal_matrix;
+	}
+}
\ No newline at end of file
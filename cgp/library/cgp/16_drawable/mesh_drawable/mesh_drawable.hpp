@@ -2,6 +2,8 @@
 
 #include "cgp/09_geometric_transformation/affine/affine.hpp"
 #include "cgp/11_mesh/mesh/mesh.hpp"
+#include "cgp/11_mesh/mesh_view/mesh_view.hpp"
+#include "cgp/12_shape/bounding_box/bounding_box.hpp"
 #include "cgp/13_opengl/opengl.hpp"
 #include "cgp/16_drawable/material/material_mesh_drawable_phong/material_mesh_drawable_phong.hpp"
 #include "cgp/16_drawable/environment/environment.hpp"
@@ -57,16 +59,23 @@ namespace cgp
 
 		// The model matrix sent to the shader is computed as
 		//  mat4 M = hierarchy_transform_model.matrix() * supplementary_model_matrix * model.matrix()
+		//  It is sent with its normal matrix (uniform mat3 modelNormal), both cached until one of the three transforms is modified.
 
 		// The material allowing to change the color, and shading parameters
 		material_mesh_drawable_phong material;
 
+		// Bounding box of the mesh in its local coordinates (set by initialize_data_on_gpu, used by the frustum culling of render_queue)
+		//  To be updated if the VBO positions are modified.
+		bounding_box bounds;
+
 		// ************************************************* //
 		//  Functions of the class
 		// ************************************************* //
 
 		// Fill the VBO and VAO of the class using the data provided from the mesh
 		void initialize_data_on_gpu(mesh const& data, opengl_shader_structure const& shader = default_shader, opengl_texture_image_structure const& texture = default_texture);
+		// Same from arrays stored elsewhere (ex. mesh_cache_file mapped in memory): sent to the GPU without copy nor check of the mesh
+		void initialize_data_on_gpu(mesh_view const& data, opengl_shader_structure const& shader = default_shader, opengl_texture_image_structure const& texture = default_texture);
 
 		// Clear the GPU memory from the VBO and VAO data
 		void clear();
@@ -74,9 +83,16 @@ namespace cgp
 		// Send the uniforms to the shader (called automatically during the draw stage)
 		void send_opengl_uniform(bool expected = true) const;
 
+		// Model matrix sent to the shader, and the matrix transforming the normals (recomputed only if model, hierarchy_transform_model or supplementary_model_matrix changed)
+		mat4 const& model_matrix() const;
+		mat3 const& normal_matrix() const;
+
 		// Additional method allowing to fill an additional VBO
 		template<typename T>
 		void initialize_supplementary_data_on_gpu(numarray<T> const& data, GLuint location_index, GLuint divisor = 0);
+
+	private:
+		mutable model_matrix_cache model_cache;
 	};
 
 
@@ -0,0 +1,159 @@
+#include "render_queue.hpp"
+
+#include "cgp/01_base/base.hpp"
+
+#include <algorithm>
+
+namespace cgp
+{
+	static uniform_id const uniform_model("model");
+	static uniform_id const uniform_model_normal("modelNormal");
+	static uniform_id const uniform_image_texture("image_texture");
+
+	int render_queue_statistics::state_changes_saved() const
+	{
+		return 4 * draw_calls - (shader_changes + texture_changes + vao_changes + environment_uploads);
+	}
+
+	void render_queue::push(mesh_drawable const& drawable, environment_generic_structure const& environment, int instance_count, bool expected_uniforms, uniform_generic_structure const& additional_uniforms)
+	{
+		add(drawable, environment, instance_count, expected_uniforms, additional_uniforms, instance_count == 1);
+	}
+
+	void render_queue::push_instanced(mesh_drawable const& drawable, environment_generic_structure const& environment, int instance_count, bool expected_uniforms, uniform_generic_structure const& additional_uniforms)
+	{
+		add(drawable, environment, instance_count, expected_uniforms, additional_uniforms, false);
+	}
+
+	void render_queue::push(instanced_mesh_drawable const& instances, environment_generic_structure const& environment, bool expected_uniforms, uniform_generic_structure const& additional_uniforms)
+	{
+		for (int k = 0; k < int(instances.lod_instance_count.size()); ++k)
+			add(instances.level_drawable(k), environment, instances.lod_instance_count[k], expected_uniforms, additional_uniforms, false);
+	}
+
+	void render_queue::add(mesh_drawable const& drawable, environment_generic_structure const& environment, int instance_count, bool expected_uniforms, uniform_generic_structure const& additional_uniforms, bool cull)
+	{
+		// If there is not vertices or not triangles, nothing is displayed (same as draw)
+		if (drawable.vbo_position.size == 0 || drawable.ebo_connectivity.size == 0 || instance_count <= 0)
+			return;
+		assert_cgp(drawable.shader.id != 0, "Try to push mesh_drawable without shader in render_queue");
+		assert_cgp(drawable.texture.id != 0, "Try to push mesh_drawable without texture in render_queue");
+
+		mat4 const& model = drawable.model_matrix();
+		if (cull && frustum_culling && !view_frustum.is_visible(transform_bounding_box(model, drawable.bounds))) {
+			culled_count++;
+			return;
+		}
+
+		item it;
+		it.drawable = &drawable;
+		it.environment = &environment;
+		it.model = model;
+		it.model_normal = drawable.normal_matrix();
+		it.material = drawable.material;
+		it.additional_uniforms = additional_uniforms;
+		it.instance_count = instance_count;
+		it.expected_uniforms = expected_uniforms;
+		vec3 const d = it.model.col_w_vec3() - camera_position;
+		it.depth = dot(d, d);
+		items.push_back(it);
+	}
+
+	render_queue_statistics const& render_queue::submit()
+	{
+		opengl_check;
+		statistics = render_queue_statistics();
+		statistics.culled = culled_count;
+		culled_count = 0;
+
+		std::sort(items.begin(), items.end(), [](item const& a, item const& b) {
+			if (a.drawable->shader.id != b.drawable->shader.id) return a.drawable->shader.id < b.drawable->shader.id;
+			if (a.drawable->texture.id != b.drawable->texture.id) return a.drawable->texture.id < b.drawable->texture.id;
+			if (a.drawable->vao != b.drawable->vao) return a.drawable->vao < b.drawable->vao;
+			return a.depth < b.depth;
+		});
+
+		GLuint current_shader = 0;
+		opengl_texture_image_structure const* current_texture = nullptr;
+		GLuint current_vao = 0;
+		std::vector<environment_generic_structure const*> environments_sent; // Environments already sent to the current shader
+
+		for (item const& it : items)
+		{
+			mesh_drawable const& drawable = *it.drawable;
+			opengl_shader_structure const& shader = drawable.shader;
+
+			if (shader.id != current_shader) {
+				glUseProgram(shader.id); opengl_check;
+				opengl_uniform(shader, uniform_image_texture, 0); opengl_check;
+				current_shader = shader.id;
+				environments_sent.clear();
+				statistics.shader_changes++;
+			}
+			if (std::find(environments_sent.begin(), environments_sent.end(), it.environment) == environments_sent.end()) {
+				it.environment->send_opengl_uniform(shader, it.expected_uniforms);
+				environments_sent.push_back(it.environment);
+				statistics.environment_uploads++;
+			}
+
+			// Uniforms of the item
+			opengl_uniform(shader, uniform_model, it.model, it.expected_uniforms);
+			opengl_uniform(shader, uniform_model_normal, it.model_normal, false);
+			it.material.send_opengl_uniform(shader, it.expected_uniforms);
+			it.additional_uniforms.send_opengl_uniform(shader, it.expected_uniforms);
+
+			if (current_texture == nullptr || drawable.texture.id != current_texture->id) {
+				glActiveTexture(GL_TEXTURE0); opengl_check;
+				drawable.texture.bind();
+				current_texture = &drawable.texture;
+				statistics.texture_changes++;
+			}
+			if (!drawable.supplementary_texture.empty()) { // Multi-texturing: always bound (rare)
+				int texture_count = 1;
+				for (auto const& element : drawable.supplementary_texture) {
+					glActiveTexture(GL_TEXTURE0 + texture_count); opengl_check;
+					element.second.bind();
+					opengl_uniform(shader, element.first, texture_count, it.expected_uniforms);
+					texture_count++;
+				}
+				glActiveTexture(GL_TEXTURE0); opengl_check;
+			}
+
+			if (drawable.vao != current_vao) {
+				glBindVertexArray(drawable.vao);                                     opengl_check;
+				glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, drawable.ebo_connectivity.id); opengl_check;
+				current_vao = drawable.vao;
+				statistics.vao_changes++;
+			}
+
+			GLsizei const index_count = GLsizei(drawable.ebo_connectivity.size * 3);
+			if (it.instance_count <= 1) {
+				glDrawElements(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, nullptr); opengl_check;
+			}
+			else {
+				glDrawElementsInstanced(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, nullptr, it.instance_count); opengl_check;
+			}
+			statistics.draw_calls++;
+		}
+
+		// Clean state (once for the whole queue)
+		glBindVertexArray(0);
+		if (current_texture != nullptr)
+			current_texture->unbind();
+		glUseProgram(0);
+
+		items.clear();
+		return statistics;
+	}
+
+	int render_queue::size() const
+	{
+		return int(items.size());
+	}
+
+	void render_queue::clear()
+	{
+		items.clear();
+		culled_count = 0;
+	}
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "cgp/16_drawable/mesh_drawable/mesh_drawable.hpp"
+#include "cgp/16_drawable/instanced_mesh_drawable/instanced_mesh_drawable.hpp"
+#include "cgp/12_shape/frustum/frustum.hpp"
+
+#include <vector>
+
+namespace cgp
+{
+	// Number of OpenGL state changes done by the last render_queue::submit()
+	struct render_queue_statistics
+	{
+		int draw_calls = 0;
+		int shader_changes = 0;       // glUseProgram
+		int texture_changes = 0;      // Texture bound on unit 0
+		int vao_changes = 0;          // glBindVertexArray (and its EBO)
+		int environment_uploads = 0;  // environment.send_opengl_uniform()
+		int culled = 0;               // Items pushed outside of the frustum (not drawn)
+
+		// Changes avoided compared to calling draw() for each item (one of each of the 4 changes above per draw call)
+		int state_changes_saved() const;
+	};
+
+	// List of opaque draws collected during a frame, then sorted and submitted at once
+	//  Items are sorted by shader, texture, VAO, and then front to back from camera_position.
+	//  While submitting, the shader, texture and VAO are only changed when they differ from the previous item,
+	//  and the environment uniforms are sent once per shader and environment.
+	//  The model and normal matrices and the material are copied when the item is pushed: a mesh_drawable can be modified and pushed again (ex. copies of a shape).
+	//  The drawables and environments are stored by address: they must still exist when submit() is called (no default environment).
+	//  With frustum_culling, a single mesh_drawable whose bounding box (transformed by its model matrix) is outside of view_frustum is not queued.
+	//  Instanced items are not culled by the queue: their instances are culled by their owner (ex. instanced_mesh_drawable::cull).
+	struct render_queue
+	{
+		vec3 camera_position; // Reference position of the front to back sort
+
+		bool frustum_culling = false;
+		frustum view_frustum; // Frustum of the camera of the frame (used if frustum_culling is true)
+
+		void push(mesh_drawable const& drawable, environment_generic_structure const& environment, int instance_count = 1, bool expected_uniforms = true, uniform_generic_structure const& additional_uniforms = uniform_generic_structure());
+		void push(instanced_mesh_drawable const& instances, environment_generic_structure const& environment, bool expected_uniforms = true, uniform_generic_structure const& additional_uniforms = uniform_generic_structure());
+		// Mesh drawn with instance_count instances placed by its shader (never culled by the queue, even for a single instance)
+		void push_instanced(mesh_drawable const& drawable, environment_generic_structure const& environment, int instance_count, bool expected_uniforms = true, uniform_generic_structure const& additional_uniforms = uniform_generic_structure());
+
+		// Sort and draw all the items pushed since the last call, then empty the queue
+		render_queue_statistics const& submit();
+
+		int size() const;
+		void clear();
+
+		render_queue_statistics statistics; // Statistics of the last submit()
+
+	private:
+		struct item
+		{
+			mesh_drawable const* drawable;
+			environment_generic_structure const* environment;
+			mat4 model;                             // Model matrix at the time of the push
+			mat3 model_normal;                      // Normal matrix at the time of the push
+			material_mesh_drawable_phong material;  // Material at the time of the push
+			uniform_generic_structure additional_uniforms;
+			int instance_count;
+			bool expected_uniforms;
+			float depth;                            // Squared distance from the camera to the origin of the model
+		};
+		std::vector<item> items;
+		int culled_count = 0; // Items culled since the last submit()
+
+		void add(mesh_drawable const& drawable, environment_generic_structure const& environment, int instance_count, bool expected_uniforms, uniform_generic_structure const& additional_uniforms, bool cull);
+	};
+}
@@ -3,7 +3,7 @@
 namespace cgp
 {
 	trajectory_drawable::trajectory_drawable(size_t N_max_sample_arg)
-		:position_record(), visual(), N_max_sample(N_max_sample_arg), current_size(0)
+		:position_record(), visual(), N_max_sample(N_max_sample_arg), current_size(0), next_index(0)
 	{}
 
 	void trajectory_drawable::clear()
@@ -11,6 +11,7 @@ namespace cgp
 		position_record.clear();
 		visual.clear();
 		current_size = 0;
+		next_index = 0;
 	}
 	void trajectory_drawable::add(vec3 const& position)
 	{
@@ -19,28 +20,61 @@ namespace cgp
 		if (position_record.size() == 0) {
 			assert_cgp_no_msg(current_size == 0);
 			assert_cgp_no_msg(visual.vbo_position.id == 0);
+			assert_cgp(N_max_sample > 1, "trajectory_drawable needs at least 2 samples");
 
-			position_record.resize(N_max_sample);
+			position_record.resize(N_max_sample + 1);
 			visual.initialize_data_on_gpu(position_record);
 		}
-		assert_cgp_no_msg(position_record.size() == N_max_sample);
+		assert_cgp_no_msg(position_record.size() == N_max_sample + 1);
 
-		for (size_t k = N_max_sample - 1; k > 0; --k) {
-			position_record[k] = position_record[k - 1];
+		// Write the new sample in place of the oldest one, and only send this element to the GPU
+		int const index = int(next_index);
+		position_record[index] = position;
+		visual.vbo_position.update_range(position_record, index, 1);
+		if (index == 0) { // Copy joining the two parts of the ring
+			position_record[N_max_sample] = position;
+			visual.vbo_position.update_range(position_record, int(N_max_sample), 1);
 		}
-		position_record[0] = position;
 
+		next_index = (next_index + 1) % N_max_sample;
 		if (current_size < N_max_sample)
 			current_size++;
 
-		visual.vbo_position.update(position_record);
+	}
 
+	vec3 const& trajectory_drawable::position(size_t k) const
+	{
+		assert_cgp(k < current_size, "Sample " + str(k) + " is not stored in the trajectory (" + str(current_size) + " samples)");
+		return position_record[(next_index + N_max_sample - 1 - k) % N_max_sample];
 	}
 
 	void draw(trajectory_drawable const& drawable, environment_generic_structure const& environment)
 	{
-		if (drawable.current_size > 0) {
-			draw(drawable.visual, environment);
+		if (drawable.current_size < 2)
+			return;
+
+		curve_drawable const& visual = drawable.visual;
+		assert_cgp(visual.shader.id != 0, "Try to draw trajectory_drawable without shader");
+		glUseProgram(visual.shader.id); opengl_check;
+		visual.send_opengl_uniform();
+		environment.send_opengl_uniform(visual.shader);
+
+		glBindVertexArray(visual.vao); opengl_check;
+		int const next = int(drawable.next_index);
+		if (drawable.current_size < drawable.N_max_sample || next == 0) {
+			// Samples in chronological order: [0, current_size[
+			glDrawArrays(GL_LINE_STRIP, 0, GLsizei(drawable.current_size)); opengl_check;
+		}
+		else {
+			// Oldest samples [next, N_max_sample] (ending with the copy of the element 0), then the most recent ones [0, next[
+			glDrawArrays(GL_LINE_STRIP, next, GLsizei(drawable.N_max_sample + 1 - next)); opengl_check;
+			if (next > 1) {
+				glDrawArrays(GL_LINE_STRIP, 0, next); opengl_check;
+			}
 		}
+
+		glBindVertexArray(0);
+		glUseProgram(0);
+		opengl_check;
 	}
-}
\ No newline at end of file
+}
@@ -2,20 +2,29 @@
 
 namespace cgp
 {
+	/** Trail of the last N_max_sample positions of a moving object
+	* The positions are stored in a ring buffer: adding a sample writes and uploads a single element (no shift of the previous ones),
+	* and the wrapped range is displayed with two line strips. The cost of add() does not depend on N_max_sample. */
 	struct trajectory_drawable
 	{
 		trajectory_drawable(size_t N_max_sample = 100);
 		void clear();
 		void add(vec3 const& position);
 
+		/** Position of the k-th most recent sample (k=0: last added sample, k<current_size) */
+		vec3 const& position(size_t k) const;
 
+
+		// Ring buffer of N_max_sample+1 positions: the element N_max_sample is a copy of the element 0,
+		//  such that the oldest part [next_index, N_max_sample] joins the most recent part [0, next_index[ when drawn.
 		numarray<vec3> position_record;
 		curve_drawable visual;
 		size_t N_max_sample;
 		size_t current_size;
+		size_t next_index; // Index of position_record written by the next add() (the oldest sample once the buffer is full)
 
 	};
 
 
 	void draw(trajectory_drawable const& drawable, environment_generic_structure const& environment);
-}
\ No newline at end of file
+}
@@ -223,13 +223,13 @@ namespace cgp
 		// Final model matrix in the shader is: hierarchy_transform_model * model
 		mat4 const model_shader = hierarchy_transform_model.matrix() * model.matrix();
 
-		// The normal matrix is transpose( (hierarchy_transform_model * model)^{-1} )
-		mat4 const model_normal_shader = transpose(inverse(model).matrix() * inverse(hierarchy_transform_model).matrix());
+		// The normal matrix is transpose( (hierarchy_transform_model * model)^{-1} ) restricted to its linear part (same as mesh_drawable)
+		mat3 const model_normal_shader = transpose(inverse(model_shader.get_block_linear()));
 		
 
 		// set the Model matrix
 		opengl_uniform(shader, "model", model_shader, expected);
-		opengl_uniform(shader, "modelNormal", model_normal_shader, expected);
+		opengl_uniform(shader, "modelNormal", model_normal_shader, false);
 
 		// set the material
 		material.send_opengl_uniform(shader);
@@ -13,4 +13,5 @@
  */
 
 
-#include "mesh_loader/mesh_loader.hpp"
\ No newline at end of file
+#include "mesh_loader/mesh_loader.hpp"
+#include "texture_cache/texture_cache.hpp"
\ No newline at end of file
@@ -0,0 +1,195 @@
+#include "mesh_cache.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/20_format_parser/mesh_loader/obj/obj.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace cgp
+{
+    static char const mesh_cache_magic[8] = {'C','G','P','M','E','S','H','\0'};
+    static uint32_t const mesh_cache_version = 1;
+    static uint64_t const mesh_cache_alignment = 64;
+
+    // Arrays of the file, in this order
+    enum mesh_cache_array { array_position, array_normal, array_color, array_uv, array_connectivity, array_count };
+
+    struct mesh_cache_header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t header_size;    // sizeof(mesh_cache_header) when the file was written
+        uint64_t file_size;      // Size of the whole cache file (detects a truncated file)
+        uint64_t source_size;
+        int64_t source_time;     // Modification time of the source file
+        uint64_t source_hash;    // hash_bytes of the content of the source file
+        uint32_t vertex_count;
+        uint32_t triangle_count;
+        float p_min[3];
+        float p_max[3];
+        uint64_t offset[array_count]; // Offset of each array from the start of the file (0: absent)
+    };
+
+    // Size and modification time of the source file, and its hash (only computed if needed)
+    struct mesh_cache_source
+    {
+        bool exists = false;
+        uint64_t size = 0;
+        int64_t time = -1;
+
+        explicit mesh_cache_source(std::string const& filename)
+        {
+            time = file_get_modification_time(filename);
+            exists = time != -1;
+            if (exists)
+                size = file_get_size(filename);
+        }
+    };
+
+    static uint64_t aligned(uint64_t offset)
+    {
+        return (offset + mesh_cache_alignment - 1) / mesh_cache_alignment * mesh_cache_alignment;
+    }
+
+    static size_t element_size(int array)
+    {
+        return array == array_uv ? sizeof(vec2) : (array == array_connectivity ? sizeof(uint3) : sizeof(vec3));
+    }
+
+    bool mesh_cache_save(std::string const& cache_filename, mesh const& m, std::string const& source_filename)
+    {
+        mesh_cache_source const source(source_filename);
+        mesh_view const view = mesh_view_of(m);
+        void const* arrays[array_count] = { view.position, view.normal, view.color, view.uv, view.connectivity };
+        uint64_t counts[array_count] = { uint64_t(view.vertex_count), uint64_t(view.vertex_count), uint64_t(view.vertex_count), uint64_t(view.vertex_count), uint64_t(view.triangle_count) };
+
+        mesh_cache_header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, mesh_cache_magic, sizeof(header.magic));
+        header.version = mesh_cache_version;
+        header.header_size = uint32_t(sizeof(mesh_cache_header));
+        header.source_size = source.size;
+        header.source_time = source.time;
+        header.source_hash = source.exists ? file_hash(source_filename) : 0;
+        header.vertex_count = uint32_t(view.vertex_count);
+        header.triangle_count = uint32_t(view.triangle_count);
+        for (int c = 0; c < 3; ++c) {
+            header.p_min[c] = view.p_min[c];
+            header.p_max[c] = view.p_max[c];
+        }
+        uint64_t offset = aligned(sizeof(mesh_cache_header));
+        for (int k = 0; k < array_count; ++k) {
+            if (arrays[k] == nullptr)
+                continue;
+            header.offset[k] = offset;
+            offset = aligned(offset + counts[k] * element_size(k));
+        }
+        header.file_size = offset;
+
+        // Written under a temporary name, then renamed
+        std::string const temporary_filename = cache_filename + ".tmp";
+        {
+            std::ofstream stream(temporary_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!stream.is_open())
+                return false;
+            char const padding[mesh_cache_alignment] = {};
+            uint64_t position = sizeof(mesh_cache_header);
+            stream.write(reinterpret_cast<char const*>(&header), sizeof(mesh_cache_header));
+            for (int k = 0; k < array_count; ++k) {
+                if (arrays[k] == nullptr)
+                    continue;
+                stream.write(padding, std::streamsize(header.offset[k] - position));
+                stream.write(static_cast<char const*>(arrays[k]), std::streamsize(counts[k] * element_size(k)));
+                position = header.offset[k] + counts[k] * element_size(k);
+            }
+            stream.write(padding, std::streamsize(header.file_size - position));
+            if (!stream.good())
+                return false;
+        }
+        return file_replace(temporary_filename, cache_filename);
+    }
+
+    bool mesh_cache_file::open(std::string const& cache_filename, std::string const& source_filename)
+    {
+        close();
+        if (!check_file_exist(cache_filename) || file_get_size(cache_filename) < sizeof(mesh_cache_header))
+            return false;
+        file.open(cache_filename);
+
+        // Header and offsets of the arrays
+        mesh_cache_header header;
+        std::memcpy(&header, file.data, sizeof(mesh_cache_header));
+        uint64_t const counts[array_count] = { header.vertex_count, header.vertex_count, header.vertex_count, header.vertex_count, header.triangle_count };
+        bool valid = std::memcmp(header.magic, mesh_cache_magic, sizeof(header.magic)) == 0 && header.version == mesh_cache_version
+            && header.header_size == sizeof(mesh_cache_header) && header.file_size == file.size
+            && header.offset[array_position] != 0 && header.offset[array_connectivity] != 0;
+        for (int k = 0; valid && k < array_count; ++k)
+            valid = header.offset[k] == 0 || (header.offset[k] % mesh_cache_alignment == 0 && header.offset[k] + counts[k] * element_size(k) <= file.size);
+
+        // Signature of the source file: same size, and same time or content
+        if (valid) {
+            mesh_cache_source const source(source_filename);
+            if (source.exists)
+                valid = source.size == header.source_size && (source.time == header.source_time || file_hash(source_filename) == header.source_hash);
+        }
+
+        if (valid) {
+            view.vertex_count = int(header.vertex_count);
+            view.triangle_count = int(header.triangle_count);
+            view.p_min = { header.p_min[0], header.p_min[1], header.p_min[2] };
+            view.p_max = { header.p_max[0], header.p_max[1], header.p_max[2] };
+            char const* const data = file.data;
+            auto array = [&](int k) { return header.offset[k] != 0 ? data + header.offset[k] : nullptr; };
+            view.position = reinterpret_cast<vec3 const*>(array(array_position));
+            view.normal = reinterpret_cast<vec3 const*>(array(array_normal));
+            view.color = reinterpret_cast<vec3 const*>(array(array_color));
+            view.uv = reinterpret_cast<vec2 const*>(array(array_uv));
+            view.connectivity = reinterpret_cast<uint3 const*>(array(array_connectivity));
+
+            // Indices out of the vertices (corrupted file) would read outside of the buffers on the GPU
+            unsigned int const N = header.vertex_count;
+            for (int k = 0; valid && k < view.triangle_count; ++k)
+                valid = view.connectivity[k][0] < N && view.connectivity[k][1] < N && view.connectivity[k][2] < N;
+        }
+
+        if (!valid)
+            close();
+        return valid;
+    }
+
+    void mesh_cache_file::load(std::string const& source_filename, std::string const& cache_directory, std::function<mesh(std::string const&)> const& loader)
+    {
+        std::string const cache_filename = mesh_cache_filename(source_filename, cache_directory);
+        from_cache = open(cache_filename, source_filename);
+        if (from_cache)
+            return;
+
+        mesh m = loader ? loader(source_filename) : mesh_load_file_obj(source_filename);
+        if (mesh_cache_save(cache_filename, m, source_filename) && open(cache_filename, source_filename))
+            return;
+
+        warning_cgp("Cannot write the mesh cache " + cache_filename, "The mesh is loaded from " + source_filename + " at each call.");
+        loaded = std::move(m);
+        view = mesh_view_of(loaded);
+    }
+
+    mesh mesh_cache_file::to_mesh() const
+    {
+        return cgp::to_mesh(view);
+    }
+
+    void mesh_cache_file::close()
+    {
+        file.close();
+        loaded = mesh();
+        view = mesh_view();
+    }
+
+    std::string mesh_cache_filename(std::string const& source_filename, std::string const& cache_directory)
+    {
+        return cache_filename(source_filename, cache_directory, ".cgpmesh");
+    }
+}
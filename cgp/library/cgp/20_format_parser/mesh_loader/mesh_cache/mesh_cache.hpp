@@ -0,0 +1,53 @@
+#pragma once
+
+#include "cgp/03_files/files.hpp"
+#include "cgp/11_mesh/mesh/mesh.hpp"
+#include "cgp/11_mesh/mesh_view/mesh_view.hpp"
+
+#include <functional>
+
+namespace cgp
+{
+    /** Mesh read from a binary cache file (.cgpmesh) instead of its source file (ex. .obj): no parsing, no vertex duplication, no normal computation
+    * File layout: a header (version, size/modification time/hash of the source file, numbers of vertices and triangles, bounding box, offsets of the arrays),
+    *  then the arrays of position, normal, color, uv (vertex_count elements each, absent if empty) and connectivity, each aligned on 64 octets.
+    * The cache file is mapped in memory: view gives the arrays in place, to be sent directly to the GPU with mesh_drawable::initialize_data_on_gpu(mesh_view),
+    *  or copied with to_mesh when the mesh is needed on the CPU (ex. collisions).
+    * Usage:
+    *   mesh_cache_file file;
+    *   file.load(project::path + "assets/skull.obj");  // Creates skull.obj.cgpmesh at the first call, maps it at the next ones
+    *   skull.initialize_data_on_gpu(file.view);
+    */
+    struct mesh_cache_file
+    {
+        mesh_view view;
+        bool from_cache = false; // true if the cache was valid, false if the mesh was loaded from its source file
+
+        /** Load the mesh of source_filename through its cache (see mesh_cache_filename)
+        * The cache is created - or replaced - if it is absent, corrupted, or if source_filename was modified since its creation.
+        * loader: function loading source_filename, nullptr for mesh_load_file_obj (the empty fields are filled). 
+        *  The cache does not know the loader: use a different cache_directory for different loaders of the same file.
+        * If the cache cannot be written, the view is the mesh given by the loader, kept in memory. */
+        void load(std::string const& source_filename, std::string const& cache_directory = "", std::function<mesh(std::string const&)> const& loader = nullptr);
+
+        /** Map cache_filename if it is a valid cache of source_filename, otherwise return false (and nothing is mapped)
+        * The cache is valid if the source file has the same size, and the same modification time or the same content (hash), or if the source file does not exist. */
+        bool open(std::string const& cache_filename, std::string const& source_filename);
+
+        /** Copy of the mesh */
+        mesh to_mesh() const;
+
+        void close();
+
+    private:
+        file_mapping file;
+        mesh loaded; // Mesh of the view when the cache could not be written
+    };
+
+    /** Write a mesh in a cache file, with the signature of its source file. Return false if the file cannot be written
+    * The file is written under a temporary name then renamed: a cache is either complete or absent. */
+    bool mesh_cache_save(std::string const& cache_filename, mesh const& m, std::string const& source_filename);
+
+    /** Cache file of a mesh file: next to it (source_filename.cgpmesh), or in cache_directory (created if needed) if it is not empty */
+    std::string mesh_cache_filename(std::string const& source_filename, std::string const& cache_directory = "");
+}
@@ -0,0 +1,90 @@
+#include "test_mesh_cache.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "../mesh_cache.hpp"
+#include "cgp/20_format_parser/mesh_loader/obj/obj.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+using namespace cgp;
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	template <typename T>
+	static bool same_array(numarray<T> const& a, numarray<T> const& b)
+	{
+		return a.size() == b.size() && (a.size() == 0 || std::memcmp(&a[0], &b[0], a.size() * sizeof(T)) == 0);
+	}
+
+	static bool same_mesh(mesh const& a, mesh const& b)
+	{
+		return same_array(a.position, b.position) && same_array(a.normal, b.normal) && same_array(a.color, b.color) && same_array(a.uv, b.uv) && same_array(a.connectivity, b.connectivity);
+	}
+
+	static void write_text(std::string const& filename, std::string const& text)
+	{
+		std::ofstream stream(filename, std::ios::out | std::ios::binary | std::ios::trunc);
+		stream << text;
+	}
+
+	void test_mesh_cache()
+	{
+		std::string const source = "test_mesh_cache.obj";
+		std::string const cache = mesh_cache_filename(source);
+		std::remove(cache.c_str());
+		write_text(source, "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvt 0 0\nvt 1 0\nvt 1 1\nvt 0 1\nf 1/1 2/2 3/3 4/4\n");
+
+		int loads = 0;
+		auto const loader = [&loads](std::string const& filename) { loads++; return mesh_load_file_obj(filename); };
+		mesh const expected = mesh_load_file_obj(source);
+
+		// First load: from the source file, the cache is created. Second load: from the cache
+		{
+			mesh_cache_file file;
+			file.load(source, "", loader);
+			assert_cgp_no_msg(!file.from_cache && loads == 1 && check_file_exist(cache));
+			assert_cgp_no_msg(same_mesh(file.to_mesh(), expected));
+
+			file.load(source, "", loader);
+			assert_cgp_no_msg(file.from_cache && loads == 1);
+			assert_cgp_no_msg(same_mesh(file.to_mesh(), expected));
+			assert_cgp_no_msg(file.view.vertex_count == 4 && file.view.triangle_count == 2 && file.view.color != nullptr);
+			assert_cgp_no_msg(is_equal(file.view.p_min, vec3(0, 0, 0)) && is_equal(file.view.p_max, vec3(1, 1, 0)));
+		}
+
+		// Modified source: the cache is replaced
+		{
+			write_text(source, "v 0 0 0\nv 2 0 0\nv 0 2 0\nf 1 2 3\n");
+			mesh_cache_file file;
+			file.load(source, "", loader);
+			assert_cgp_no_msg(!file.from_cache && loads == 2 && file.view.vertex_count == 3);
+			assert_cgp_no_msg(same_mesh(file.to_mesh(), mesh_load_file_obj(source)));
+		}
+
+		// Truncated or invalid cache: not opened
+		{
+			std::string content;
+			{
+				file_mapping const mapped(cache);
+				content.assign(mapped.data, mapped.size);
+			}
+			mesh_cache_file file;
+			write_text(cache, content.substr(0, content.size() - 1));
+			assert_cgp_no_msg(!file.open(cache, source) && file.view.vertex_count == 0);
+			write_text(cache, "not a cache");
+			assert_cgp_no_msg(!file.open(cache, source));
+			write_text(cache, content);
+			assert_cgp_no_msg(file.open(cache, source));
+		}
+
+		std::remove(cache.c_str());
+		std::remove(source.c_str());
+	}
+}
@@ -10,6 +10,13 @@
 #include "cgp/01_base/base.hpp"
 #include "cgp/03_files/files.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
 #include <map>
 
 #include <fstream>
@@ -104,6 +111,16 @@ mesh mesh_load_file_obj(const std::string& filename)
      return m;
 }
 mesh mesh_load_file_obj(const std::string& filename, numarray<numarray<int> >& vertex_correspondance)
+{
+    file_mapping const file(filename);
+    loader::obj_data data;
+    loader::obj_parse(file.data, file.data + file.size, data, thread_pool_default());
+    assert_cgp(data.position.size()>0, str("File ")+filename+" has 0 vertices");
+
+    return loader::obj_build_mesh(data, vertex_correspondance);
+}
+
+mesh loader::mesh_load_file_obj_multipass(const std::string& filename, numarray<numarray<int> >& vertex_correspondance)
 {
     assert_file_exist(filename);
 
@@ -419,6 +436,541 @@ numarray<numarray<int3>> obj_read_faces(const std::string& filename, obj_type co
 }
 
 
+
+static bool is_blank(char c)
+{
+    return c==' ' || c=='\t' || c=='\r';
+}
+static bool is_digit(char c)
+{
+    return c>='0' && c<='9';
+}
+static void skip_blank(char const*& it, char const* end)
+{
+    while(it<end && is_blank(*it))
+        ++it;
+}
+
+// Exact powers of ten in double precision
+static double const power_of_ten[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// Parse the number with strtof (rare cases: long exponents, rounding too close to the middle of two floats, nan, inf, etc)
+static bool parse_float_strtof(char const*& it, char const* end, float& value)
+{
+    char const* token_end = it;
+    while(token_end<end && !is_blank(*token_end) && *token_end!='\n' && *token_end!='/')
+        ++token_end;
+    std::string const token(it, token_end);
+    char* parsed_end = nullptr;
+    float const parsed = std::strtof(token.c_str(), &parsed_end);
+    if(parsed_end==token.c_str())
+        return false;
+    value = parsed;
+    it += parsed_end - token.c_str();
+    return true;
+}
+
+bool obj_parse_float(char const*& it, char const* end, float& value)
+{
+    char const* p = it;
+    bool const negative = p<end && *p=='-';
+    if(p<end && (*p=='-' || *p=='+'))
+        ++p;
+
+    // Up to 19 significant digits in the mantissa: value = mantissa * 10^exponent
+    uint64_t mantissa = 0;
+    int significant_digits = 0;
+    int exponent = 0;
+    bool digits = false;
+    for(; p<end && is_digit(*p); ++p) {
+        digits = true;
+        if(significant_digits<19) {
+            mantissa = 10*mantissa + uint64_t(*p-'0');
+            significant_digits += mantissa>0 ? 1 : 0;
+        }
+        else
+            exponent++;
+    }
+    if(p<end && *p=='.') {
+        ++p;
+        for(; p<end && is_digit(*p); ++p) {
+            digits = true;
+            if(significant_digits<19) {
+                mantissa = 10*mantissa + uint64_t(*p-'0');
+                significant_digits += mantissa>0 ? 1 : 0;
+                exponent--;
+            }
+        }
+    }
+    if(!digits)
+        return parse_float_strtof(it, end, value);
+    if(p<end && (*p=='e' || *p=='E')) {
+        char const* q = p+1;
+        bool const negative_exponent = q<end && *q=='-';
+        if(q<end && (*q=='-' || *q=='+'))
+            ++q;
+        if(q==end || !is_digit(*q))
+            return parse_float_strtof(it, end, value);
+        int e = 0;
+        for(; q<end && is_digit(*q); ++q)
+            e = std::min(10*e + (*q-'0'), 100000);
+        exponent += negative_exponent ? -e : e;
+        p = q;
+    }
+
+    if(mantissa==0) {
+        value = negative ? -0.0f : 0.0f;
+        it = p;
+        return true;
+    }
+
+    // Exact operands: a single float operation is correctly rounded (same result as strtof)
+    if(mantissa<=(uint64_t(1)<<24) && exponent>=-10 && exponent<=10) {
+        float const m = float(mantissa);
+        float const v = exponent<0 ? m/float(power_of_ten[-exponent]) : m*float(power_of_ten[exponent]);
+        value = negative ? -v : v;
+        it = p;
+        return true;
+    }
+
+    // Double precision value within about 1 ulp (of a double): its rounding to float is exact, unless it is too close to the middle of two floats
+    if(exponent>=-22 && exponent<=22) {
+        double const m = double(mantissa);
+        double const v = exponent<0 ? m/power_of_ten[-exponent] : m*power_of_ten[exponent];
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(double));
+        int64_t const below_float = int64_t(bits & ((uint64_t(1)<<29)-1)); // bits of the double mantissa discarded by the rounding to float
+        bool const near_middle = std::abs(below_float - (int64_t(1)<<28)) <= 16;
+        if(!near_middle && v>=double(std::numeric_limits<float>::min()) && v<=double(std::numeric_limits<float>::max())) {
+            value = negative ? -float(v) : float(v);
+            it = p;
+            return true;
+        }
+    }
+    return parse_float_strtof(it, end, value);
+}
+
+// Parse an integer, return false if there is no digit
+static bool parse_int(char const*& it, char const* end, int& value)
+{
+    char const* p = it;
+    bool const negative = p<end && *p=='-';
+    if(p<end && (*p=='-' || *p=='+'))
+        ++p;
+    if(p==end || !is_digit(*p))
+        return false;
+    int v = 0;
+    for(; p<end && is_digit(*p); ++p)
+        v = 10*v + (*p-'0');
+    value = negative ? -v : v;
+    it = p;
+    return true;
+}
+
+// Read up to count floats of the line (the missing ones are 0)
+static void parse_floats(char const* it, char const* line_end, float* value, int count)
+{
+    for(int k=0; k<count; ++k)
+        value[k] = 0.0f;
+    for(int k=0; k<count; ++k) {
+        skip_blank(it, line_end);
+        if(!obj_parse_float(it, line_end, value[k]))
+            break;
+    }
+}
+
+// Index of the file (starting at 1, or negative: relative to the end) to offset in the attribute (-1 if absent or invalid)
+static int obj_offset(int index, size_t count)
+{
+    if(index>0)
+        return index-1;
+    if(index<0)
+        return int(count)+index;
+    return -1;
+}
+
+void obj_parse(char const* begin, char const* end, obj_data& data)
+{
+    std::vector<int3> polygon;
+    std::vector<int> polygon_relative; // Bits of the indices of each polygon vertex given relative to the end of the attributes
+    char const* it = begin;
+    while(it<end)
+    {
+        char const* line_end = static_cast<char const*>(std::memchr(it, '\n', size_t(end-it)));
+        if(line_end==nullptr)
+            line_end = end;
+
+        skip_blank(it, line_end);
+        char const c0 = it<line_end ? it[0] : '#';
+        char const c1 = it+1<line_end ? it[1] : ' ';
+        char const c2 = it+2<line_end ? it[2] : ' ';
+
+        float v[3];
+        if(c0=='v' && is_blank(c1)) {
+            parse_floats(it+1, line_end, v, 3);
+            data.position.push_back({v[0], v[1], v[2]});
+        }
+        else if(c0=='v' && c1=='t' && is_blank(c2)) {
+            parse_floats(it+2, line_end, v, 2);
+            data.uv.push_back({v[0], v[1]});
+        }
+        else if(c0=='v' && c1=='n' && is_blank(c2)) {
+            parse_floats(it+2, line_end, v, 3);
+            data.normal.push_back({v[0], v[1], v[2]});
+        }
+        else if(c0=='f' && is_blank(c1)) {
+            // Vertices of the polygon: v, v/vt, v//vn or v/vt/vn
+            polygon.clear();
+            polygon_relative.clear();
+            char const* p = it+1;
+            while(true) {
+                skip_blank(p, line_end);
+                int v = 0;
+                if(!parse_int(p, line_end, v))
+                    break;
+                int t = 0, n = 0;
+                if(p<line_end && *p=='/') {
+                    ++p;
+                    parse_int(p, line_end, t);
+                    if(p<line_end && *p=='/') {
+                        ++p;
+                        parse_int(p, line_end, n);
+                    }
+                }
+                while(p<line_end && !is_blank(*p))
+                    ++p;
+                polygon.push_back({obj_offset(v, data.position.size()), obj_offset(t, data.uv.size()), obj_offset(n, data.normal.size())});
+                polygon_relative.push_back((v<0 ? 1 : 0) | (t<0 ? 2 : 0) | (n<0 ? 4 : 0));
+            }
+
+            // Triangulation as a fan around the first vertex
+            for(int k=0; k+2<int(polygon.size()); ++k) {
+                int const fan[3] = {0, k+1, k+2};
+                for(int vertex : fan) {
+                    for(int c=0; c<3; ++c)
+                        if(polygon_relative[vertex] & (1<<c))
+                            data.relative_index.push_back(3*int(data.corner.size())+c);
+                    data.corner.push_back(polygon[vertex]);
+                }
+            }
+        }
+
+        it = line_end+1;
+    }
+}
+
+// Append the chunks parsed separately to data
+//  The indices relative to the end of the attributes were computed from the start of their chunk: the attributes of the previous chunks are added.
+static void obj_merge(std::vector<obj_data> const& chunk, obj_data& data, thread_pool& pool)
+{
+    int const N_chunk = int(chunk.size());
+    std::vector<size_t> offset_position(N_chunk+1, data.position.size()), offset_uv(N_chunk+1, data.uv.size()), offset_normal(N_chunk+1, data.normal.size()), offset_corner(N_chunk+1, data.corner.size());
+    for(int k=0; k<N_chunk; ++k) {
+        offset_position[k+1] = offset_position[k] + chunk[k].position.size();
+        offset_uv[k+1] = offset_uv[k] + chunk[k].uv.size();
+        offset_normal[k+1] = offset_normal[k] + chunk[k].normal.size();
+        offset_corner[k+1] = offset_corner[k] + chunk[k].corner.size();
+    }
+    data.position.resize(offset_position[N_chunk]);
+    data.uv.resize(offset_uv[N_chunk]);
+    data.normal.resize(offset_normal[N_chunk]);
+    data.corner.resize(offset_corner[N_chunk]);
+
+    pool.parallel_for(0, N_chunk, [&](int b, int e) {
+        for(int k=b; k<e; ++k) {
+            obj_data const& c = chunk[k];
+            std::copy(c.position.begin(), c.position.end(), data.position.begin()+offset_position[k]);
+            std::copy(c.uv.begin(), c.uv.end(), data.uv.begin()+offset_uv[k]);
+            std::copy(c.normal.begin(), c.normal.end(), data.normal.begin()+offset_normal[k]);
+            std::copy(c.corner.begin(), c.corner.end(), data.corner.begin()+offset_corner[k]);
+
+            int const offset[3] = {int(offset_position[k]), int(offset_uv[k]), int(offset_normal[k])};
+            for(int index : c.relative_index)
+                data.corner[offset_corner[k]+index/3][index%3] += offset[index%3];
+        }
+    }, 1);
+}
+
+void obj_parse(char const* begin, char const* end, obj_data& data, thread_pool& pool, size_t chunk_size)
+{
+    size_t const size = size_t(end-begin);
+    size_t const N_chunk = pool.size()>1 ? std::min(size_t(4*pool.size()), size/std::max(chunk_size, size_t(1))) : 1;
+    if(N_chunk<=1) {
+        obj_parse(begin, end, data);
+        return;
+    }
+
+    // Chunks of whole lines, of about the same size
+    std::vector<char const*> bound(N_chunk+1, end);
+    bound[0] = begin;
+    for(size_t k=1; k<N_chunk; ++k) {
+        char const* p = std::max(begin + k*size/N_chunk, bound[k-1]);
+        char const* line_end = static_cast<char const*>(std::memchr(p, '\n', size_t(end-p)));
+        bound[k] = line_end!=nullptr ? line_end+1 : end;
+    }
+
+    std::vector<obj_data> chunk(N_chunk);
+    pool.parallel_for(0, int(N_chunk), [&](int b, int e) {
+        for(int k=b; k<e; ++k)
+            obj_parse(bound[k], bound[k+1], chunk[k]);
+    }, 1);
+    obj_merge(chunk, data, pool);
+}
+
+// Single thread version of obj_build_mesh: the vertices sharing a position are chained instead of sorting the corners
+static mesh obj_build_mesh_serial(obj_data const& data, numarray<numarray<int>>& vertex_correspondance)
+{
+    bool const use_uv = data.uv.size()>0;
+    bool const use_normal = data.normal.size()>0;
+    int const N_position = int(data.position.size());
+    int const N_corner = int(data.corner.size());
+
+    mesh m;
+    m.connectivity.data.reserve(N_corner/3);
+    m.position.data.reserve(N_position);
+    if(use_uv)
+        m.uv.data.reserve(N_position);
+    if(use_normal)
+        m.normal.data.reserve(N_position);
+
+    // A vertex is created for each different (position, uv, normal) triplet, in the order of the triangles
+    //  The vertices sharing a position are chained from first_vertex[position] through next_vertex.
+    std::vector<int> first_vertex(N_position, -1);
+    std::vector<int> next_vertex;
+    std::vector<int3> vertex_index;
+    next_vertex.reserve(N_position);
+    vertex_index.reserve(N_position);
+
+    for(int k_corner=0; k_corner<N_corner; k_corner+=3)
+    {
+        uint3 triangle;
+        for(int k=0; k<3; ++k)
+        {
+            int3 index = data.corner[k_corner+k];
+            if(!use_uv)
+                index[1] = -1;
+            if(!use_normal)
+                index[2] = -1;
+
+            int const idx_position = index[0];
+            assert_cgp(idx_position>=0 && idx_position<N_position, "Incorrect vertex index "+str(idx_position+1)+" in obj file");
+
+            int vertex = first_vertex[idx_position];
+            while(vertex!=-1 && (vertex_index[vertex][1]!=index[1] || vertex_index[vertex][2]!=index[2]))
+                vertex = next_vertex[vertex];
+
+            if(vertex==-1) {
+                vertex = int(m.position.size());
+                next_vertex.push_back(first_vertex[idx_position]);
+                first_vertex[idx_position] = vertex;
+                vertex_index.push_back(index);
+
+                m.position.push_back(data.position[idx_position]);
+                if(use_uv) {
+                    assert_cgp(index[1]>=0 && index[1]<int(data.uv.size()), "Incorrect texture index "+str(index[1]+1)+" in obj file");
+                    m.uv.push_back(data.uv[index[1]]);
+                }
+                if(use_normal) {
+                    assert_cgp(index[2]>=0 && index[2]<int(data.normal.size()), "Incorrect normal index "+str(index[2]+1)+" in obj file");
+                    m.normal.push_back(data.normal[index[2]]);
+                }
+            }
+            triangle[k] = vertex;
+        }
+        m.connectivity.push_back(triangle);
+    }
+
+    // Vertices of each position of the file, in the order of their (uv, normal) indices
+    long int const N = N_position;
+    vertex_correspondance.resize(N_position);
+    for(int vertex=0; vertex<int(vertex_index.size()); ++vertex)
+        vertex_correspondance[vertex_index[vertex][0]].push_back(vertex);
+    for(int k=0; k<N_position; ++k) {
+        std::vector<int>& vertices = vertex_correspondance[k].data;
+        if(vertices.size()>1)
+            std::sort(vertices.begin(), vertices.end(), [&](int a, int b) {
+                return long(vertex_index[a][1]) + N*long(vertex_index[a][2]) < long(vertex_index[b][1]) + N*long(vertex_index[b][2]);
+            });
+    }
+
+    return m;
+}
+
+// Corner of a triangle, sorted by position and (uv, normal) indices to find the corners sharing a vertex
+struct obj_corner_key {
+    int position;
+    int uv;
+    int normal;
+    int corner;
+};
+
+// std::sort of the parts of the vector on the threads of the pool, then merge of the sorted parts two by two
+template <typename T, typename Less>
+static void parallel_sort(std::vector<T>& v, Less const& less, thread_pool& pool)
+{
+    size_t const N = v.size();
+    int parts = 1;
+    while(parts<2*pool.size() && N/size_t(2*parts)>=4096)
+        parts *= 2;
+    if(parts==1) {
+        std::sort(v.begin(), v.end(), less);
+        return;
+    }
+
+    std::vector<size_t> bound(parts+1);
+    for(int k=0; k<=parts; ++k)
+        bound[k] = k*N/parts;
+    pool.parallel_for(0, parts, [&](int b, int e) {
+        for(int k=b; k<e; ++k)
+            std::sort(v.begin()+bound[k], v.begin()+bound[k+1], less);
+    }, 1);
+
+    std::vector<T> buffer(N);
+    std::vector<T>* source = &v;
+    std::vector<T>* target = &buffer;
+    for(int width=1; width<parts; width*=2) {
+        pool.parallel_for(0, parts/(2*width), [&](int b, int e) {
+            for(int k=b; k<e; ++k) {
+                size_t const first = bound[2*k*width], middle = bound[(2*k+1)*width], last = bound[(2*k+2)*width];
+                std::merge(source->begin()+first, source->begin()+middle, source->begin()+middle, source->begin()+last, target->begin()+first, less);
+            }
+        }, 1);
+        std::swap(source, target);
+    }
+    if(source!=&v)
+        v.swap(buffer);
+}
+
+mesh obj_build_mesh(obj_data const& data, numarray<numarray<int>>& vertex_correspondance, thread_pool& pool)
+{
+    bool const use_uv = data.uv.size()>0;
+    bool const use_normal = data.normal.size()>0;
+    int const N_position = int(data.position.size());
+    int const N_uv = int(data.uv.size());
+    int const N_normal = int(data.normal.size());
+    int const N_corner = int(data.corner.size());
+    if(pool.size()==1)
+        return obj_build_mesh_serial(data, vertex_correspondance);
+
+    // Keys of the corners (the uv and normals are only used if the file has some)
+    std::vector<obj_corner_key> key(N_corner);
+    std::atomic<bool> valid(true);
+    pool.parallel_for(0, N_corner, [&](int b, int e) {
+        for(int k=b; k<e; ++k) {
+            int3 const& index = data.corner[k];
+            obj_corner_key& c = key[k];
+            c = {index[0], use_uv ? index[1] : -1, use_normal ? index[2] : -1, k};
+            if(c.position<0 || c.position>=N_position || (use_uv && (c.uv<0 || c.uv>=N_uv)) || (use_normal && (c.normal<0 || c.normal>=N_normal)))
+                valid = false;
+        }
+    });
+    if(!valid) {
+        for(obj_corner_key const& c : key) {
+            assert_cgp(c.position>=0 && c.position<N_position, "Incorrect vertex index "+str(c.position+1)+" in obj file");
+            assert_cgp(!use_uv || (c.uv>=0 && c.uv<N_uv), "Incorrect texture index "+str(c.uv+1)+" in obj file");
+            assert_cgp(!use_normal || (c.normal>=0 && c.normal<N_normal), "Incorrect normal index "+str(c.normal+1)+" in obj file");
+        }
+    }
+
+    // Corners sorted by position, then in the order of vertex_correspondance, then by (uv, normal) and corner:
+    //  the corners of a vertex are consecutive, starting with its first corner in the order of the triangles.
+    long int const N = N_position;
+    auto const less = [N](obj_corner_key const& a, obj_corner_key const& b) {
+        if(a.position!=b.position)
+            return a.position<b.position;
+        long int const order_a = long(a.uv) + N*long(a.normal);
+        long int const order_b = long(b.uv) + N*long(b.normal);
+        if(order_a!=order_b)
+            return order_a<order_b;
+        if(a.uv!=b.uv)
+            return a.uv<b.uv;
+        if(a.normal!=b.normal)
+            return a.normal<b.normal;
+        return a.corner<b.corner;
+    };
+    parallel_sort(key, less, pool);
+    auto const same_vertex = [](obj_corner_key const& a, obj_corner_key const& b) {
+        return a.position==b.position && a.uv==b.uv && a.normal==b.normal;
+    };
+
+    // First corner of the vertex of each corner
+    std::vector<int> first_corner(N_corner);
+    std::vector<unsigned char> is_first(N_corner, 0);
+    pool.parallel_for(0, N_corner, [&](int b, int e) {
+        int first = b;
+        while(first>0 && same_vertex(key[first-1], key[b]))
+            --first;
+        for(int k=b; k<e; ++k) {
+            if(!same_vertex(key[first], key[k]))
+                first = k;
+            first_corner[key[k].corner] = key[first].corner;
+            if(first==k)
+                is_first[key[k].corner] = 1;
+        }
+    });
+
+    // Vertices numbered in the order of their first corner (prefix sum of is_first over blocks of corners)
+    int const N_block = std::max(1, std::min(N_corner/4096, 4*pool.size()));
+    std::vector<int> block_offset(N_block+1, 0);
+    pool.parallel_for(0, N_block, [&](int b, int e) {
+        for(int k=b; k<e; ++k)
+            block_offset[k+1] = int(std::count(is_first.begin()+size_t(k)*N_corner/N_block, is_first.begin()+size_t(k+1)*N_corner/N_block, 1));
+    }, 1);
+    for(int k=0; k<N_block; ++k)
+        block_offset[k+1] += block_offset[k];
+    int const N_vertex = block_offset[N_block];
+
+    mesh m;
+    m.position.resize(N_vertex);
+    if(use_uv)
+        m.uv.resize(N_vertex);
+    if(use_normal)
+        m.normal.resize(N_vertex);
+    std::vector<int> vertex_of_corner(N_corner);
+    pool.parallel_for(0, N_block, [&](int b, int e) {
+        for(int k=b; k<e; ++k) {
+            int vertex = block_offset[k];
+            int const last = int(size_t(k+1)*N_corner/N_block);
+            for(int c=int(size_t(k)*N_corner/N_block); c<last; ++c) {
+                if(!is_first[c])
+                    continue;
+                int3 const& index = data.corner[c];
+                m.position[vertex] = data.position[index[0]];
+                if(use_uv)
+                    m.uv[vertex] = data.uv[index[1]];
+                if(use_normal)
+                    m.normal[vertex] = data.normal[index[2]];
+                vertex_of_corner[c] = vertex++;
+            }
+        }
+    }, 1);
+
+    m.connectivity.resize(N_corner/3);
+    pool.parallel_for(0, N_corner/3, [&](int b, int e) {
+        for(int k=b; k<e; ++k)
+            for(int i=0; i<3; ++i)
+                m.connectivity[k][i] = vertex_of_corner[first_corner[3*k+i]];
+    });
+
+    // Vertices of each position of the file, in the order of their (uv, normal) indices
+    //  Each sub-range only fills the positions starting inside it.
+    vertex_correspondance.resize(N_position);
+    pool.parallel_for(0, N_corner, [&](int b, int e) {
+        int const range_end = e;
+        while(b<range_end && b>0 && key[b].position==key[b-1].position)
+            ++b;
+        if(b==range_end)
+            return;
+        while(e<N_corner && key[e].position==key[e-1].position)
+            ++e;
+        for(int k=b; k<e; ++k)
+            if(k==0 || !same_vertex(key[k-1], key[k]))
+                vertex_correspondance[key[k].position].push_back(vertex_of_corner[key[k].corner]);
+    });
+
+    return m;
+}
+
 }
 
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "cgp/01_base/thread_pool/thread_pool.hpp"
 #include "cgp/11_mesh/mesh.hpp"
 
 namespace cgp
@@ -14,6 +15,7 @@ namespace cgp
 
     /** Load a mesh stored as .obj in the filename.
     * Notes: 
+    *  - The file is mapped in memory and parsed in a single pass (large files: chunks of lines parsed on the threads of thread_pool_default)
     *  - Normals and UV are read, and vertices are duplicated if needed
     *  - .mtl files are not read with this loader (cannot read shading and color)
     *  - Only one mesh is loaded - this parser cannot be used when multiple textures are associated to different objects
@@ -39,6 +41,34 @@ namespace loader{
     /** Simple file reader of the position connectivity assuming triangles (doesn't handle texture and normal connectivity) */
     std::vector<uint3> obj_read_connectivity(const std::string& filename);
 
+    /** Content of an obj file: the polygons are triangulated as fans */
+    struct obj_data {
+        std::vector<vec3> position;
+        std::vector<vec2> uv;
+        std::vector<vec3> normal;
+        std::vector<int3> corner; // Indices of (position, uv, normal) of each corner of the triangles (3 per triangle), starting at 0 (-1 if absent)
+        std::vector<int> relative_index; // Indices of corner (3*corner + 0, 1 or 2 for position, uv or normal) given in the file relative to the end of the attributes
+    };
+
+    /** Parse the lines v, vt, vn and f of an obj file content (other lines are ignored)
+    * Faces can be given as v, v/vt, v//vn or v/vt/vn, with negative indices relative to the end of the attributes already read */
+    void obj_parse(char const* begin, char const* end, obj_data& data);
+    /** Same result as obj_parse: the content is split in chunks of lines parsed on the threads of the pool, then appended to data
+    * The content is parsed as a single chunk below 2 x chunk_size, or if the pool has a single thread. */
+    void obj_parse(char const* begin, char const* end, obj_data& data, thread_pool& pool, size_t chunk_size = size_t(1)<<20);
+
+    /** Mesh with one vertex per different (position, uv, normal) triplet of the corners, created in the order of the triangles
+    * The uv (resp. normals) are only used if the file has some. vertex_correspondance: vertices created for each position of the file
+    * The corners are sorted on the threads of the pool to find the ones sharing a vertex (a pool of a single thread chains the vertices of each position instead). */
+    mesh obj_build_mesh(obj_data const& data, numarray<numarray<int>>& vertex_correspondance, thread_pool& pool = thread_pool_default());
+
+    /** Parse a float at it (without leading spaces), and move it after the number
+    * Same result as strtof: the common cases are computed directly, the others are given to strtof. Return false if there is no number. */
+    bool obj_parse_float(char const*& it, char const* end, float& value);
+
+    /** Former loader of mesh_load_file_obj: one pass over the file per attribute with std::stringstream (reference of the tests and benchmarks) */
+    mesh mesh_load_file_obj_multipass(const std::string& filename, numarray<numarray<int>>& vertex_correspondance);
+
     /** Read only vertices position from obj file */
     std::vector<vec3> obj_read_positions(const std::string& filename);
     /** Real only normals from obj file */
@@ -0,0 +1,146 @@
+#include "test_obj.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/08_random_noise/random_stream/random_stream.hpp"
+#include "../obj.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+using namespace cgp;
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	static bool parse_as_strtof(std::string const& text)
+	{
+		char const* it = text.c_str();
+		float value = 0;
+		bool const parsed = loader::obj_parse_float(it, text.c_str() + text.size(), value);
+		char* end = nullptr;
+		float const expected = std::strtof(text.c_str(), &end);
+		return parsed && it == end && std::memcmp(&value, &expected, sizeof(float)) == 0;
+	}
+
+	void test_obj()
+	{
+		// Float parsing: bitwise identical to strtof
+		{
+			char const* const texts[] = { "0", "-0", "1", "-1.5", "0.5", "3.", ".25", "+2", "1e3", "1.5E-3", "-2.5e+2",
+				"0.13969522714614868", "-0.9227271676063538", "3.3092128525516866", "-2.4015838530989697",
+				"123456789012345678901234", "0.000000000000000000000000000000000000012", "1e-45", "3.4028235e38", "1e39", "inf", "nan" };
+			for (char const* text : texts)
+				assert_cgp(parse_as_strtof(text), std::string("Incorrect float parsing of ") + text);
+
+			random_stream random(7);
+			char buffer[64];
+			for (int k = 0; k < 20000; ++k) {
+				double const v = (double(random.next() >> 11) / double(uint64_t(1) << 53) - 0.5) * std::pow(10.0, random.uniform_int(-8, 8));
+				std::snprintf(buffer, sizeof(buffer), "%.*g", random.uniform_int(1, 19), v);
+				assert_cgp(parse_as_strtof(buffer), std::string("Incorrect float parsing of ") + buffer);
+			}
+
+			char const* const not_numbers[] = { "", "-", "x", "/" };
+			for (char const* text : not_numbers) {
+				char const* it = text;
+				float value = 0;
+				assert_cgp_no_msg(!loader::obj_parse_float(it, text + std::strlen(text), value) && it == text);
+			}
+		}
+
+		// Faces: quads as fans, v//vn and negative indices, comments and missing final end of line
+		{
+			std::string const text =
+				"# square\r\n"
+				"v 0 0 0\r\nv 1 0 0\r\nv 1 1 0\r\nv 0 1 0\r\n"
+				"vn 0 0 1\r\n"
+				"f 1//1 2//1 3//1 4//1\r\n"
+				"v 2 0 0\n"
+				"f -3//-1 -1//1 -4//1";
+			loader::obj_data data;
+			loader::obj_parse(text.c_str(), text.c_str() + text.size(), data);
+			assert_cgp_no_msg(data.position.size() == 5 && data.normal.size() == 1 && data.uv.size() == 0);
+			assert_cgp_no_msg(data.corner.size() == 9);
+			assert_cgp_no_msg(data.corner[3][0] == 0 && data.corner[4][0] == 2 && data.corner[5][0] == 3);
+			assert_cgp_no_msg(data.corner[6][0] == 2 && data.corner[7][0] == 4 && data.corner[8][0] == 1 && data.corner[6][2] == 0 && data.corner[6][1] == -1);
+
+			numarray<numarray<int>> correspondance;
+			mesh const m = loader::obj_build_mesh(data, correspondance);
+			assert_cgp_no_msg(m.position.size() == 5 && m.normal.size() == 5 && m.uv.size() == 0 && m.connectivity.size() == 3);
+			assert_cgp_no_msg(correspondance.size() == 5 && correspondance[4].size() == 1);
+		}
+
+		// A position with two uv gives two vertices
+		{
+			std::string const text = "v 0 0 0\nv 1 0 0\nv 0 1 0\nv 1 1 0\nvt 0 0\nvt 1 0\nvt 0 1\nvt 1 1\nvt 0.5 0.5\nf 1/1 2/2 3/3\nf 2/5 4/4 3/3\n";
+			loader::obj_data data;
+			loader::obj_parse(text.c_str(), text.c_str() + text.size(), data);
+			numarray<numarray<int>> correspondance;
+			mesh const m = loader::obj_build_mesh(data, correspondance);
+			assert_cgp_no_msg(m.position.size() == 5 && m.uv.size() == 5);
+			assert_cgp_no_msg(m.connectivity[1][2] == m.connectivity[0][2]);
+			assert_cgp_no_msg(correspondance[1].size() == 2 && correspondance[0].size() == 1);
+		}
+
+		// Parsing in small chunks and building on several threads: same result as on a single thread
+		{
+			random_stream random(11);
+			std::string text = "v 0 0 0\nvt 0 0\nvn 0 0 1\n";
+			int counts[3] = { 1, 1, 1 };
+			char buffer[64];
+			for (int k = 0; k < 20000; ++k) {
+				int const type = random.uniform_int(0, 5);
+				if (type < 3) {
+					std::snprintf(buffer, sizeof(buffer), "%s %d %d %d\n", type == 0 ? "v" : (type == 1 ? "vt" : "vn"), random.uniform_int(0, 9), random.uniform_int(0, 9), k);
+					text += buffer;
+					counts[type]++;
+					continue;
+				}
+				text += "f";
+				int const degree = random.uniform_int(3, 5);
+				for (int i = 0; i < degree; ++i) {
+					int index[3];
+					for (int c = 0; c < 3; ++c) {
+						int const offset = random.uniform_int(0, std::min(counts[c], 8) - 1); // Mostly recent attributes: the vertices are shared
+						index[c] = random.uniform_int(0, 1) ? counts[c] - offset : -1 - offset;
+					}
+					std::snprintf(buffer, sizeof(buffer), " %d/%d/%d", index[0], index[1], index[2]);
+					text += buffer;
+				}
+				text += "\n";
+			}
+
+			thread_pool pool(4);
+			loader::obj_data data, data_chunks;
+			loader::obj_parse(text.c_str(), text.c_str() + text.size(), data);
+			loader::obj_parse(text.c_str(), text.c_str() + text.size(), data_chunks, pool, 64);
+			assert_cgp_no_msg(data_chunks.position.size() == data.position.size() && data_chunks.uv.size() == data.uv.size() && data_chunks.normal.size() == data.normal.size());
+			assert_cgp_no_msg(data_chunks.corner.size() == data.corner.size() && data.corner.size() > 3 * 8192);
+			for (size_t k = 0; k < data.corner.size(); ++k)
+				assert_cgp_no_msg(data_chunks.corner[k][0] == data.corner[k][0] && data_chunks.corner[k][1] == data.corner[k][1] && data_chunks.corner[k][2] == data.corner[k][2]);
+
+			thread_pool single_thread(1);
+			numarray<numarray<int>> correspondance, correspondance_threads;
+			mesh const m = loader::obj_build_mesh(data, correspondance, single_thread);
+			mesh const m_threads = loader::obj_build_mesh(data, correspondance_threads, pool);
+			assert_cgp_no_msg(m_threads.position.size() == m.position.size() && m_threads.connectivity.size() == m.connectivity.size());
+			for (int k = 0; k < int(m.position.size()); ++k)
+				assert_cgp_no_msg(is_equal(m_threads.position[k], m.position[k]) && is_equal(m_threads.uv[k], m.uv[k]) && is_equal(m_threads.normal[k], m.normal[k]));
+			for (int k = 0; k < int(m.connectivity.size()); ++k)
+				assert_cgp_no_msg(m_threads.connectivity[k][0] == m.connectivity[k][0] && m_threads.connectivity[k][1] == m.connectivity[k][1] && m_threads.connectivity[k][2] == m.connectivity[k][2]);
+			assert_cgp_no_msg(correspondance_threads.size() == correspondance.size());
+			for (int k = 0; k < int(correspondance.size()); ++k) {
+				assert_cgp_no_msg(correspondance_threads[k].size() == correspondance[k].size());
+				for (int i = 0; i < int(correspondance[k].size()); ++i)
+					assert_cgp_no_msg(correspondance_threads[k][i] == correspondance[k][i]);
+			}
+		}
+	}
+}
@@ -0,0 +1,124 @@
+#include "test_texture_cache.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "../texture_cache.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+
+using namespace cgp;
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	static bool same_levels(image_mipmap_view const& a, image_mipmap_view const& b)
+	{
+		size_t const size = size_t(a.face_count) * a.face_size();
+		return a.width == b.width && a.height == b.height && a.level_count == b.level_count && a.face_count == b.face_count && a.color_type == b.color_type
+			&& size == size_t(b.face_count) * b.face_size() && std::memcmp(a.data, b.data, size) == 0;
+	}
+
+	// Image of width x height with the value of each component depending on the pixel
+	static image_structure test_image(int width, int height)
+	{
+		numarray<unsigned char> data;
+		data.resize(4 * width * height);
+		for (int k = 0; k < data.size(); ++k)
+			data[k] = (unsigned char)((k * 37) % 251);
+		return image_structure(width, height, image_color_type::rgba, data);
+	}
+
+	void test_texture_cache()
+	{
+		// Mip levels: sizes down to 1x1, and average of the 2x2 pixels of the previous level
+		{
+			image_mipmap const mipmap = image_mipmap_build(test_image(5, 2));
+			image_mipmap_view const view = mipmap.view();
+			assert_cgp_no_msg(view.level_count == 3 && view.level_width(1) == 2 && view.level_height(1) == 1 && view.level_width(2) == 1);
+			assert_cgp_no_msg(size_t(mipmap.data.size()) == view.face_size() && view.face_size() == 4 * (10 + 2 + 1));
+			image_structure const level_0 = image_mipmap_level(view, 0, 0);
+			image_structure const level_1 = image_mipmap_level(view, 0, 1);
+			int const sum = level_0.data[0] + level_0.data[4] + level_0.data[20] + level_0.data[24]; // Pixels (0,0), (1,0), (0,1), (1,1), red component
+			assert_cgp_no_msg(level_1.data[0] == (sum + 2) / 4);
+			assert_cgp_no_msg(image_mipmap_build(test_image(5, 2), 1).view().level_count == 1);
+		}
+
+		std::string const source = "test_texture_cache.png";
+		std::string const cache = texture_cache_filename(source);
+		std::remove(cache.c_str());
+		image_save_png(source, test_image(8, 4));
+		image_mipmap const expected = image_mipmap_build(image_load_file(source));
+
+		// First load: from the source file, the cache is created. Second load: from the cache
+		{
+			texture_cache_file file;
+			file.load(source);
+			assert_cgp_no_msg(!file.from_cache && check_file_exist(cache));
+			assert_cgp_no_msg(same_levels(file.view, expected.view()) && file.verify());
+
+			file.load(source, "", 0, true);
+			assert_cgp_no_msg(file.from_cache && file.view.level_count == 4 && file.view.face_count == 1);
+			assert_cgp_no_msg(same_levels(file.view, expected.view()) && same_levels(file.to_mipmap().view(), expected.view()));
+
+			// Other number of levels: the cache is replaced
+			file.load(source, "", 1);
+			assert_cgp_no_msg(!file.from_cache && file.view.level_count == 1);
+			file.load(source, "", 1);
+			assert_cgp_no_msg(file.from_cache && file.view.level_count == 1);
+		}
+
+		// Cubemap split from a grid of 2x3 square images
+		{
+			std::string const cubemap_source = "test_texture_cache_cubemap.png";
+			std::string const cubemap_cache = cache_filename(cubemap_source, "", ".cubemap.cgptex");
+			std::remove(cubemap_cache.c_str());
+			image_save_png(cubemap_source, test_image(8, 12));
+			std::vector<image_structure> const grid = image_split_grid(image_load_file(cubemap_source), 2, 3);
+			std::array<int, 6> const faces = { 5, 4, 3, 2, 1, 0 };
+
+			texture_cache_file file;
+			file.load_cubemap(cubemap_source, 2, 3, faces, "", 2);
+			file.load_cubemap(cubemap_source, 2, 3, faces, "", 2);
+			assert_cgp_no_msg(file.from_cache && file.view.face_count == 6 && file.view.level_count == 2 && file.view.width == 4);
+			for (int f = 0; f < 6; ++f)
+				assert_cgp_no_msg(std::memcmp(file.view.level_data(f, 0), grid[faces[f]].data.data.data(), file.view.level_size(0)) == 0);
+			file.close();
+			std::remove(cubemap_cache.c_str());
+			std::remove(cubemap_source.c_str());
+		}
+
+		// Corrupted levels: detected by the hash, the cache is replaced when the levels are verified
+		{
+			texture_cache_file file;
+			file.load(source, "", 1);
+			std::string content;
+			{
+				file_mapping const mapped(cache);
+				content.assign(mapped.data, mapped.size);
+			}
+			file.close();
+			content[content.size() - 1] ^= 1; // Last octet of the levels (8x4 pixels of 4 octets: a multiple of the alignment, the file ends with them)
+			{
+				std::ofstream stream(cache, std::ios::out | std::ios::binary | std::ios::trunc);
+				stream << content;
+			}
+			assert_cgp_no_msg(file.open(cache, source) && !file.verify());
+			file.load(source, "", 1, true);
+			assert_cgp_no_msg(!file.from_cache && file.verify());
+
+			// Truncated cache: not opened
+			std::ofstream stream(cache, std::ios::out | std::ios::binary | std::ios::trunc);
+			stream << content.substr(0, content.size() / 2);
+			stream.close();
+			assert_cgp_no_msg(!file.open(cache, source) && file.view.data == nullptr);
+		}
+
+		std::remove(cache.c_str());
+		std::remove(source.c_str());
+	}
+}
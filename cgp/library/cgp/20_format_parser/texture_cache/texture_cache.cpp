@@ -0,0 +1,205 @@
+#include "texture_cache.hpp"
+
+#include "cgp/01_base/base.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+namespace cgp
+{
+    static char const texture_cache_magic[8] = {'C','G','P','T','E','X','\0','\0'};
+    static uint32_t const texture_cache_version = 1;
+    static uint64_t const texture_cache_alignment = 64;
+    static uint32_t const texture_cache_max_size = 1 << 16; // Larger images are considered as a corrupted header
+
+    struct texture_cache_header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t header_size;    // sizeof(texture_cache_header) when the file was written
+        uint64_t file_size;      // Size of the whole cache file (detects a truncated file)
+        uint64_t source_size;
+        int64_t source_time;     // Modification time of the source file
+        uint64_t source_hash;    // hash_bytes of the content of the source file
+        uint64_t parameters;     // Key of the parameters of the levels
+        uint32_t width;
+        uint32_t height;
+        uint32_t level_count;
+        uint32_t face_count;
+        uint32_t components;     // 3 (rgb) or 4 (rgba)
+        uint32_t padding;
+        uint64_t levels_offset;  // Offset of the levels from the start of the file
+        uint64_t levels_size;
+        uint64_t levels_hash;    // hash_bytes of the levels
+    };
+
+    static uint64_t aligned(uint64_t offset)
+    {
+        return (offset + texture_cache_alignment - 1) / texture_cache_alignment * texture_cache_alignment;
+    }
+
+    // Key of the parameters of the levels (kind of texture, number of levels, faces in the grid, etc.)
+    static uint64_t parameters_key(std::vector<int> const& values)
+    {
+        return hash_bytes(reinterpret_cast<char const*>(values.data()), values.size() * sizeof(int));
+    }
+
+    bool texture_cache_save(std::string const& cache_filename, image_mipmap_view const& mipmap, std::string const& source_filename, uint64_t parameters)
+    {
+        int64_t const source_time = file_get_modification_time(source_filename);
+        bool const source_exists = source_time != -1;
+        size_t const levels_size = size_t(mipmap.face_count) * mipmap.face_size();
+
+        texture_cache_header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, texture_cache_magic, sizeof(header.magic));
+        header.version = texture_cache_version;
+        header.header_size = uint32_t(sizeof(texture_cache_header));
+        header.source_size = source_exists ? file_get_size(source_filename) : 0;
+        header.source_time = source_time;
+        header.source_hash = source_exists ? file_hash(source_filename) : 0;
+        header.parameters = parameters;
+        header.width = uint32_t(mipmap.width);
+        header.height = uint32_t(mipmap.height);
+        header.level_count = uint32_t(mipmap.level_count);
+        header.face_count = uint32_t(mipmap.face_count);
+        header.components = mipmap.color_type == image_color_type::rgba ? 4 : 3;
+        header.levels_offset = aligned(sizeof(texture_cache_header));
+        header.levels_size = levels_size;
+        header.levels_hash = hash_bytes(reinterpret_cast<char const*>(mipmap.data), levels_size);
+        header.file_size = aligned(header.levels_offset + levels_size);
+
+        // Written under a temporary name, then renamed
+        std::string const temporary_filename = cache_filename + ".tmp";
+        {
+            std::ofstream stream(temporary_filename, std::ios::out | std::ios::binary | std::ios::trunc);
+            if (!stream.is_open())
+                return false;
+            char const padding[texture_cache_alignment] = {};
+            stream.write(reinterpret_cast<char const*>(&header), sizeof(texture_cache_header));
+            stream.write(padding, std::streamsize(header.levels_offset - sizeof(texture_cache_header)));
+            stream.write(reinterpret_cast<char const*>(mipmap.data), std::streamsize(levels_size));
+            stream.write(padding, std::streamsize(header.file_size - header.levels_offset - levels_size));
+            if (!stream.good())
+                return false;
+        }
+        return file_replace(temporary_filename, cache_filename);
+    }
+
+    bool texture_cache_file::open(std::string const& cache_filename, std::string const& source_filename)
+    {
+        close();
+        if (!check_file_exist(cache_filename) || file_get_size(cache_filename) < sizeof(texture_cache_header))
+            return false;
+        file.open(cache_filename);
+
+        // Header and size of the levels
+        texture_cache_header header;
+        std::memcpy(&header, file.data, sizeof(texture_cache_header));
+        bool valid = std::memcmp(header.magic, texture_cache_magic, sizeof(header.magic)) == 0 && header.version == texture_cache_version
+            && header.header_size == sizeof(texture_cache_header) && header.file_size == file.size
+            && header.width > 0 && header.height > 0 && header.width <= texture_cache_max_size && header.height <= texture_cache_max_size && (header.face_count == 1 || (header.face_count == 6 && header.width == header.height)) && (header.components == 3 || header.components == 4)
+            && header.level_count > 0 && int(header.level_count) <= mipmap_level_count(int(header.width), int(header.height))
+            && header.levels_offset % texture_cache_alignment == 0 && header.levels_offset + header.levels_size <= file.size;
+        if (valid) {
+            view.width = int(header.width);
+            view.height = int(header.height);
+            view.level_count = int(header.level_count);
+            view.face_count = int(header.face_count);
+            view.color_type = header.components == 4 ? image_color_type::rgba : image_color_type::rgb;
+            view.data = reinterpret_cast<unsigned char const*>(file.data + header.levels_offset);
+            valid = header.levels_size == uint64_t(view.face_count) * view.face_size();
+        }
+
+        // Signature of the source file: same size, and same time or content
+        if (valid) {
+            int64_t const source_time = file_get_modification_time(source_filename);
+            if (source_time != -1)
+                valid = file_get_size(source_filename) == header.source_size && (source_time == header.source_time || file_hash(source_filename) == header.source_hash);
+        }
+
+        if (!valid) {
+            close();
+            return false;
+        }
+        parameters = header.parameters;
+        levels_hash = header.levels_hash;
+        return true;
+    }
+
+    bool texture_cache_file::verify() const
+    {
+        if (file.data == nullptr)
+            return true;
+        return hash_bytes(reinterpret_cast<char const*>(view.data), size_t(view.face_count) * view.face_size()) == levels_hash;
+    }
+
+    void texture_cache_file::load_levels(std::string const& source_filename, std::string const& cache_filename, uint64_t parameters_arg, bool verify_levels, std::function<image_mipmap()> const& build)
+    {
+        from_cache = open(cache_filename, source_filename) && parameters == parameters_arg && (!verify_levels || verify());
+        if (from_cache)
+            return;
+
+        image_mipmap mipmap = build();
+        if (texture_cache_save(cache_filename, mipmap.view(), source_filename, parameters_arg) && open(cache_filename, source_filename))
+            return;
+
+        warning_cgp("Cannot write the texture cache " + cache_filename, "The mip levels are computed from " + source_filename + " at each call.");
+        loaded = std::move(mipmap);
+        view = loaded.view();
+    }
+
+    void texture_cache_file::load(std::string const& source_filename, std::string const& cache_directory, int level_count, bool verify_levels)
+    {
+        uint64_t const key = parameters_key({ 1, level_count });
+        load_levels(source_filename, texture_cache_filename(source_filename, cache_directory), key, verify_levels, [&]() {
+            return image_mipmap_build(image_load_file(source_filename), level_count);
+        });
+    }
+
+    void texture_cache_file::load_cubemap(std::string const& source_filename, int N_horizontal, int N_vertical, std::array<int, 6> const& faces, std::string const& cache_directory, int level_count, bool verify_levels)
+    {
+        uint64_t const key = parameters_key({ 6, level_count, N_horizontal, N_vertical, faces[0], faces[1], faces[2], faces[3], faces[4], faces[5] });
+        load_levels(source_filename, cache_filename(source_filename, cache_directory, ".cubemap.cgptex"), key, verify_levels, [&]() {
+            std::vector<image_structure> const grid = image_split_grid(image_load_file(source_filename), N_horizontal, N_vertical);
+            std::vector<image_structure> cube_faces;
+            for (int k : faces) {
+                assert_cgp(k >= 0 && k < int(grid.size()), "Incorrect index of face " + str(k) + " in a grid of " + str(N_horizontal) + "x" + str(N_vertical) + " images");
+                cube_faces.push_back(grid[k]);
+            }
+            return image_mipmap_build(cube_faces, level_count);
+        });
+    }
+
+    image_mipmap texture_cache_file::to_mipmap() const
+    {
+        image_mipmap mipmap;
+        mipmap.width = view.width;
+        mipmap.height = view.height;
+        mipmap.level_count = view.level_count;
+        mipmap.face_count = view.face_count;
+        mipmap.color_type = view.color_type;
+        size_t const size = size_t(view.face_count) * view.face_size();
+        mipmap.data.resize(int(size));
+        if (size > 0)
+            std::memcpy(mipmap.data.data.data(), view.data, size);
+        return mipmap;
+    }
+
+    void texture_cache_file::close()
+    {
+        file.close();
+        loaded = image_mipmap();
+        view = image_mipmap_view();
+        parameters = 0;
+        levels_hash = 0;
+    }
+
+    std::string texture_cache_filename(std::string const& source_filename, std::string const& cache_directory)
+    {
+        return cache_filename(source_filename, cache_directory, ".cgptex");
+    }
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "cgp/03_files/files.hpp"
+#include "cgp/07_image/image.hpp"
+
+#include <array>
+#include <functional>
+
+namespace cgp
+{
+    /** Mip levels of an image read from a binary cache file (.cgptex) instead of its source file (PNG or JPG): no decoding, no glGenerateMipmap
+    * File layout: a header (version, size/modification time/hash of the source file, parameters of the levels, size of the image, numbers of levels and faces,
+    *  hash of the levels), then all the levels of each face (see image_mipmap_view), aligned on 64 octets.
+    * The cache file is mapped in memory: view gives the levels in place, to be sent directly to the GPU with opengl_texture_image_structure::initialize_texture_2d_on_gpu(image_mipmap_view)
+    *  or initialize_cubemap_on_gpu(image_mipmap_view).
+    * Usage:
+    *   texture_cache_file file;
+    *   file.load(project::path + "assets/sand.jpg");  // Creates sand.jpg.cgptex at the first call, maps it at the next ones
+    *   terrain.texture.initialize_texture_2d_on_gpu(file.view, GL_REPEAT, GL_REPEAT);
+    */
+    struct texture_cache_file
+    {
+        image_mipmap_view view;
+        bool from_cache = false; // true if the cache was valid, false if the levels were computed from the source file
+
+        /** Load the mip levels of the image source_filename through its cache (see texture_cache_filename)
+        * The cache is created - or replaced - if it is absent, corrupted, made with other parameters, or if source_filename was modified since its creation.
+        * level_count: number of levels (0: full chain down to 1x1, 1: no mipmap)
+        * verify_levels: also compare the hash of the levels of the cache with the one of its header (reads the whole file): a corrupted cache is replaced.
+        * If the cache cannot be written, the view is the levels computed from the source file, kept in memory. */
+        void load(std::string const& source_filename, std::string const& cache_directory = "", int level_count = 0, bool verify_levels = false);
+
+        /** Same as load for the faces of a cubemap, split from the image source_filename in a grid of N_horizontal x N_vertical (see image_split_grid)
+        * faces: indices in the grid of the faces x_neg, x_pos, y_neg, y_pos, z_neg, z_pos. The cache is named source_filename.cubemap.cgptex */
+        void load_cubemap(std::string const& source_filename, int N_horizontal, int N_vertical, std::array<int, 6> const& faces, std::string const& cache_directory = "", int level_count = 1, bool verify_levels = false);
+
+        /** Map cache_filename if it is a valid cache of source_filename, otherwise return false (and nothing is mapped)
+        * The cache is valid if the source file has the same size, and the same modification time or the same content (hash), or if the source file does not exist. */
+        bool open(std::string const& cache_filename, std::string const& source_filename);
+
+        /** True if the hash of the levels is the one computed when the cache was written (always true for levels kept in memory) */
+        bool verify() const;
+
+        /** Copy of the levels */
+        image_mipmap to_mipmap() const;
+
+        void close();
+
+    private:
+        file_mapping file;
+        image_mipmap loaded;       // Levels of the view when the cache could not be written
+        uint64_t parameters = 0;   // Key of the parameters of the levels stored in the header (see load and load_cubemap)
+        uint64_t levels_hash = 0;  // hash_bytes of the levels stored in the header
+
+        void load_levels(std::string const& source_filename, std::string const& cache_filename, uint64_t parameters_arg, bool verify_levels, std::function<image_mipmap()> const& build);
+    };
+
+    /** Write mip levels in a cache file, with the signature of its source file. Return false if the file cannot be written
+    * parameters: key of the parameters used to compute the levels (a cache loaded with other parameters is replaced)
+    * The file is written under a temporary name then renamed: a cache is either complete or absent. */
+    bool texture_cache_save(std::string const& cache_filename, image_mipmap_view const& mipmap, std::string const& source_filename, uint64_t parameters = 0);
+
+    /** Cache file of an image file: next to it (source_filename.cgptex), or in cache_directory (created if needed) if it is not empty */
+    std::string texture_cache_filename(std::string const& source_filename, std::string const& cache_directory = "");
+}
@@ -0,0 +1,111 @@
+#include "asset_loader.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+namespace cgp
+{
+	asset_loader::asset_loader(thread_pool& pool_arg)
+		:pool(pool_arg), running(std::make_shared<std::atomic<int> >(0))
+	{}
+
+	asset_loader::~asset_loader()
+	{
+		pool.wait(*running);
+	}
+
+	asset_handle<mesh> asset_loader::load_mesh(std::string const& filename, std::string const& cache_directory, std::function<void(mesh&)> const& process)
+	{
+		return load([filename, cache_directory, process]() {
+			mesh_cache_file file;
+			file.load(filename, cache_directory);
+			mesh m = file.to_mesh();
+			m.fill_empty_field();
+			if (process)
+				process(m);
+			return m;
+		});
+	}
+
+	asset_handle<std::shared_ptr<mesh_cache_file> > asset_loader::load_mesh_cache(std::string const& filename, std::string const& cache_directory)
+	{
+		return load([filename, cache_directory]() {
+			std::shared_ptr<mesh_cache_file> file = std::make_shared<mesh_cache_file>();
+			file->load(filename, cache_directory);
+			return file;
+		});
+	}
+
+	asset_handle<image_structure> asset_loader::load_image(std::string const& filename)
+	{
+		return load([filename]() { return image_load_file(filename); });
+	}
+
+	asset_handle<std::shared_ptr<texture_cache_file> > asset_loader::load_texture(std::string const& filename, std::string const& cache_directory, int level_count)
+	{
+		return load([filename, cache_directory, level_count]() {
+			std::shared_ptr<texture_cache_file> file = std::make_shared<texture_cache_file>();
+			file->load(filename, cache_directory, level_count, true); // Reading the levels for the hash also brings the mapped file in memory before the upload
+			return file;
+		});
+	}
+
+	asset_handle<std::shared_ptr<texture_cache_file> > asset_loader::load_cubemap(std::string const& filename, int N_horizontal, int N_vertical, std::array<int, 6> const& faces, std::string const& cache_directory)
+	{
+		return load([filename, N_horizontal, N_vertical, faces, cache_directory]() {
+			std::shared_ptr<texture_cache_file> file = std::make_shared<texture_cache_file>();
+			file->load_cubemap(filename, N_horizontal, N_vertical, faces, cache_directory, 1, true);
+			return file;
+		});
+	}
+
+	int asset_loader::update(double time_budget)
+	{
+		typedef std::chrono::steady_clock clock;
+		clock::time_point const start = clock::now();
+
+		// The uploads registered by the calls below are appended to uploads, and wait for the next update
+		std::deque<upload_structure> waiting;
+		waiting.swap(uploads);
+		bool called = false;
+		while (!waiting.empty()) {
+			if (called && std::chrono::duration<double>(clock::now() - start).count() >= time_budget)
+				break;
+			auto it = std::find_if(waiting.begin(), waiting.end(), [](upload_structure const& u) { return u.ready(); });
+			if (it == waiting.end())
+				break;
+
+			upload_structure u = *it;
+			waiting.erase(it);
+			called = true;
+			try {
+				u.call();
+			}
+			catch (...) {
+				uploads.insert(uploads.begin(), waiting.begin(), waiting.end());
+				throw;
+			}
+		}
+		uploads.insert(uploads.begin(), waiting.begin(), waiting.end());
+		return int(uploads.size());
+	}
+
+	void asset_loader::finish()
+	{
+		while (!uploads.empty() || running->load() != 0) {
+			pool.wait(*running);
+			update(std::numeric_limits<double>::max());
+		}
+	}
+
+	int asset_loader::pending() const
+	{
+		return int(uploads.size());
+	}
+
+	int asset_loader::loading() const
+	{
+		return running->load();
+	}
+}
@@ -0,0 +1,168 @@
+#pragma once
+
+#include "cgp/01_base/base.hpp"
+#include "cgp/01_base/thread_pool/thread_pool.hpp"
+#include "cgp/07_image/image.hpp"
+#include "cgp/11_mesh/mesh.hpp"
+#include "cgp/20_format_parser/mesh_loader/mesh_cache/mesh_cache.hpp"
+#include "cgp/20_format_parser/texture_cache/texture_cache.hpp"
+
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <string>
+#include <type_traits>
+
+namespace cgp
+{
+	/** Asset loaded by a task of an asset_loader (see asset_loader::load)
+	* The handle can be copied: all the copies refer to the same asset. */
+	template <typename T>
+	struct asset_handle
+	{
+		/** True once the task is finished: get does not wait anymore */
+		bool ready() const;
+		/** The loaded asset. Waits for the task if needed, running the tasks of the pool in the meantime.
+		* If the task threw an exception (see CGP_ERROR_EXCEPTION), it is thrown again here. */
+		T& get() const;
+		/** False for a default handle, not given by an asset_loader */
+		bool valid() const;
+
+	private:
+		struct state_structure {
+			T value;
+			std::exception_ptr error;
+			std::atomic<int> remaining{ 1 }; // 0 once the task is finished
+		};
+		std::shared_ptr<state_structure> state;
+		thread_pool* pool = nullptr;
+
+		friend struct asset_loader;
+	};
+
+	/** Loading of the assets of a scene on the threads of a pool, and their upload to the GPU on the thread of the OpenGL context
+	* - load(task) runs the task on the pool (file read, image decoding, mesh processing, normals ...) and returns at once a handle on its result.
+	* - upload(asset, f) registers f(asset) to be called by update, on the thread of the OpenGL context, once the asset is loaded (ex. initialize_data_on_gpu).
+	* - update is called at the beginning of each frame: the scene is displayed while its assets are loaded, each asset appears once uploaded.
+	* The uploads of the loaded assets run in the order of their registration. An upload can load or upload other assets (ex. once several assets are there).
+	* Usage:
+	*   asset_handle<mesh> skull_mesh = assets.load_mesh(project::path + "assets/skull.obj");
+	*   assets.upload(skull_mesh, [this](mesh& m) { skull.initialize_data_on_gpu(m); });
+	*   ...
+	*   assets.update(); // In the display loop
+	* load, upload and update must be called from the same thread (the one of the OpenGL context). */
+	struct asset_loader
+	{
+		explicit asset_loader(thread_pool& pool = thread_pool_default());
+		/** Waits for the tasks still running (their uploads are not called) */
+		~asset_loader();
+		asset_loader(asset_loader const&) = delete;
+		asset_loader& operator=(asset_loader const&) = delete;
+
+		/** Run task() on the pool. The task must not access the OpenGL context, nor data used by the main thread in the meantime */
+		template <typename F>
+		asset_handle<typename std::decay<typename std::result_of<F()>::type>::type> load(F task);
+
+		/** Call f(asset.get()) in update once the asset is loaded */
+		template <typename T, typename F>
+		void upload(asset_handle<T> const& asset, F f);
+
+		/** Mesh of an OBJ file read through its binary cache (see mesh_cache_file), with its empty fields filled (normals ...)
+		* process: optional function called on the loaded mesh, on the pool as well (ex. transformations) */
+		asset_handle<mesh> load_mesh(std::string const& filename, std::string const& cache_directory = "", std::function<void(mesh&)> const& process = nullptr);
+		/** Mesh of an OBJ file mapped from its binary cache, to be sent to the GPU without copy (mesh_drawable::initialize_data_on_gpu(file->view))
+		* The arrays stay mapped until the mesh_cache_file is destroyed (or closed): use to_mesh for the ones needed on the CPU. */
+		asset_handle<std::shared_ptr<mesh_cache_file> > load_mesh_cache(std::string const& filename, std::string const& cache_directory = "");
+		/** Image of a PNG or JPG file */
+		asset_handle<image_structure> load_image(std::string const& filename);
+		/** Mip levels of a PNG or JPG file read through its texture cache (see texture_cache_file), with the hash of the cache verified on the pool
+		* The levels are mapped in memory until the texture_cache_file is destroyed (or closed) */
+		asset_handle<std::shared_ptr<texture_cache_file> > load_texture(std::string const& filename, std::string const& cache_directory = "", int level_count = 0);
+		/** Faces of a cubemap split from a PNG or JPG file, read through its texture cache (see texture_cache_file::load_cubemap) */
+		asset_handle<std::shared_ptr<texture_cache_file> > load_cubemap(std::string const& filename, int N_horizontal, int N_vertical, std::array<int, 6> const& faces, std::string const& cache_directory = "");
+
+		/** Call the uploads of the loaded assets until time_budget seconds are spent (at least one upload is called if an asset is loaded)
+		* The exception of a task which failed is thrown again here. Return the number of uploads still waiting. */
+		int update(double time_budget = 0.004);
+		/** Wait for all the tasks and call all the uploads, including the ones registered in the meantime */
+		void finish();
+
+		/** Number of uploads not called yet */
+		int pending() const;
+		/** Number of tasks not finished yet */
+		int loading() const;
+
+	private:
+		struct upload_structure {
+			std::function<bool()> ready;
+			std::function<void()> call;
+		};
+
+		thread_pool& pool;
+		std::deque<upload_structure> uploads;
+		std::shared_ptr<std::atomic<int> > running; // Tasks not finished (shared with the tasks)
+	};
+
+
+
+	template <typename T>
+	bool asset_handle<T>::ready() const
+	{
+		return state != nullptr && state->remaining.load() == 0;
+	}
+
+	template <typename T>
+	T& asset_handle<T>::get() const
+	{
+		assert_cgp(state != nullptr, "Cannot get the asset of a handle not given by asset_loader::load");
+		if (state->remaining.load() != 0)
+			pool->wait(state->remaining);
+		if (state->error)
+			std::rethrow_exception(state->error);
+		return state->value;
+	}
+
+	template <typename T>
+	bool asset_handle<T>::valid() const
+	{
+		return state != nullptr;
+	}
+
+	template <typename F>
+	asset_handle<typename std::decay<typename std::result_of<F()>::type>::type> asset_loader::load(F task)
+	{
+		typedef typename std::decay<typename std::result_of<F()>::type>::type T;
+		typedef typename asset_handle<T>::state_structure state_structure;
+
+		asset_handle<T> asset;
+		asset.state = std::make_shared<state_structure>();
+		asset.pool = &pool;
+
+		std::shared_ptr<state_structure> state = asset.state;
+		std::shared_ptr<std::atomic<int> > counter = running;
+		counter->fetch_add(1);
+		pool.submit([state, counter, task]() {
+			try {
+				state->value = task();
+			}
+			catch (...) {
+				state->error = std::current_exception();
+			}
+			state->remaining.fetch_sub(1);
+			counter->fetch_sub(1);
+		});
+		return asset;
+	}
+
+	template <typename T, typename F>
+	void asset_loader::upload(asset_handle<T> const& asset, F f)
+	{
+		assert_cgp(asset.valid(), "Cannot upload the asset of a handle not given by asset_loader::load");
+		upload_structure u;
+		u.ready = [asset]() { return asset.ready(); };
+		u.call = [asset, f]() { f(asset.get()); };
+		uploads.push_back(u);
+	}
+}
@@ -0,0 +1,99 @@
+#include "test_asset_loader.hpp"
+
+#include "cgp/01_base/base.hpp"
+#include "../asset_loader.hpp"
+#include "cgp/20_format_parser/mesh_loader/mesh_cache/mesh_cache.hpp"
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace cgp;
+
+#if defined(__linux__) || defined(__EMSCRIPTEN__)
+#pragma GCC diagnostic ignored "-Wunused-variable"
+#endif
+
+namespace cgp_test
+{
+	void test_asset_loader()
+	{
+		for (int number_of_threads : {1, 4}) {
+			thread_pool pool(number_of_threads);
+
+			// The uploads are only called by update, in the order of their registration
+			{
+				asset_loader assets(pool);
+				std::vector<int> uploaded;
+				int const N = 20;
+				for (int k = 0; k < N; ++k) {
+					asset_handle<std::vector<int> > asset = assets.load([k]() { return std::vector<int>(1000, k); });
+					assets.upload(asset, [&uploaded](std::vector<int>& v) { uploaded.push_back(v[999]); });
+				}
+				assert_cgp_no_msg(uploaded.size() == 0 && assets.pending() == N);
+				assets.finish();
+				assert_cgp_no_msg(assets.pending() == 0 && assets.loading() == 0 && int(uploaded.size()) == N);
+				for (int k = 0; k < N; ++k)
+					assert_cgp_no_msg(uploaded[k] == k);
+			}
+
+			// A zero time budget calls a single upload per update. An upload can load and upload another asset
+			{
+				asset_loader assets(pool);
+				asset_handle<int> a = assets.load([]() { return 1; });
+				asset_handle<int> b = assets.load([]() { return 2; });
+				int sum = 0;
+				assets.upload(a, [&](int& x) {
+					sum += x;
+					assets.upload(assets.load([]() { return 10; }), [&sum](int& y) { sum += y; });
+				});
+				assets.upload(b, [&sum](int& x) { sum += x; });
+				assert_cgp_no_msg(a.get() == 1 && b.get() == 2 && a.ready() && b.ready());
+				assert_cgp_no_msg(assets.update(0.0) == 2 && sum == 1);
+				assets.finish();
+				assert_cgp_no_msg(sum == 13);
+			}
+
+			// The exception of a task is thrown again by get and update
+			{
+				asset_loader assets(pool);
+				asset_handle<int> failed = assets.load([]() -> int { throw std::runtime_error("load"); });
+				bool uploaded = false;
+				assets.upload(failed, [&uploaded](int&) { uploaded = true; });
+				bool thrown = false;
+				try { failed.get(); }
+				catch (std::runtime_error const&) { thrown = true; }
+				assert_cgp_no_msg(thrown);
+				thrown = false;
+				try { assets.update(); }
+				catch (std::runtime_error const&) { thrown = true; }
+				assert_cgp_no_msg(thrown && !uploaded && assets.pending() == 0);
+			}
+
+			// Mesh with its empty fields filled, processed on the pool
+			{
+				std::string const source = "test_asset_loader.obj";
+				{
+					std::ofstream stream(source, std::ios::out | std::ios::binary | std::ios::trunc);
+					stream << "v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 3\n";
+				}
+				asset_loader assets(pool);
+				asset_handle<mesh> asset = assets.load_mesh(source, "", [](mesh& m) { m.translate({ 0,0,1 }); });
+				mesh const& m = asset.get();
+				assert_cgp_no_msg(m.position.size() == 3 && m.normal.size() == 3 && m.uv.size() == 3);
+				assert_cgp_no_msg(is_equal(m.position[1], vec3(1, 0, 1)) && is_equal(m.normal[0], vec3(0, 0, 1)));
+
+				// Same file mapped from the cache written above
+				asset_handle<std::shared_ptr<mesh_cache_file> > file = assets.load_mesh_cache(source);
+				mesh_view const& view = file.get()->view;
+				assert_cgp_no_msg(file.get()->from_cache && view.vertex_count == 3 && view.triangle_count == 1 && view.normal != nullptr);
+				assert_cgp_no_msg(is_equal(view.position[1], vec3(1, 0, 0)));
+				file.get()->close();
+				std::remove(mesh_cache_filename(source).c_str());
+				std::remove(source.c_str());
+			}
+		}
+	}
+}
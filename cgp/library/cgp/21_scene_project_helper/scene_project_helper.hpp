@@ -14,3 +14,4 @@
 
 
 #include "path/path.hpp"
+#include "asset_loader/asset_loader.hpp"
@@ -0,0 +1,157 @@
+// Headless benchmark of the fish simulation (flock_simulation_structure::step)
+//  Run N steps for several flock sizes, numbers of threads and parallel backends (OpenMP or cgp::thread_pool),
+//  and print the timings as JSON on the standard output
+//  Usage: benchmark_flock [duration_per_run_in_seconds (default 0.5)]
+
+#include "flock_simulation.hpp"
+#include "flock.hpp"
+#include "terrain.hpp"
+#include "cgp/11_mesh/primitive/primitive.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace cgp;
+
+struct benchmark_result {
+	std::string backend;
+	int nb_fish;
+	int threads;
+	int steps;
+	double seconds;
+};
+
+static double now() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Simulation in the same setting as the scene: aquarium of size 30 with 4 decorations
+static flock_simulation_structure create_simulation(int nb_fish) {
+	float const L_terrain = 30;
+	flock_simulation_structure simulation;
+	simulation.initialize(nb_fish, L_terrain);
+	simulation.add_obstacle(mesh_primitive_sphere(1.0f, { 0, 0, 0.5f }), affine().set_translation({ 0, L_terrain / 3, evaluate_dune_height(0, L_terrain / 3) }));
+	simulation.add_obstacle(mesh_primitive_sphere(2.0f, { 0, 0, 1.0f }), affine().set_translation({ -L_terrain / 4, -L_terrain / 5, evaluate_dune_height(-L_terrain / 4, -L_terrain / 5) }));
+	simulation.add_obstacle(mesh_primitive_sphere(1.0f, { 0, 0, 0.5f }), affine().set_translation({ L_terrain / 3, L_terrain / 5, evaluate_dune_height(L_terrain / 3, L_terrain / 5) }));
+	simulation.add_obstacle(mesh_primitive_sphere(3.5f, { 0, 0, 2.0f }), affine().set_translation({ L_terrain / 4, -L_terrain / 5, evaluate_dune_height(L_terrain / 4, -L_terrain / 4) }));
+	simulation.update_obstacles(); // Baked before the timing
+	return simulation;
+}
+
+static benchmark_result run(std::string const& backend, int nb_fish, int threads, double duration) {
+#ifdef _OPENMP
+	omp_set_num_threads(threads);
+#endif
+	thread_pool pool(backend == "thread_pool" ? threads : 1);
+	flock_simulation_structure simulation = create_simulation(nb_fish);
+	simulation.pool = backend == "thread_pool" ? &pool : nullptr;
+	simulation_inputs_structure inputs;
+	inputs.camera_position = { 0, 0, 100 }; // Far from the fishes: no camera repulsion
+	float const dt = 0.01f;
+
+	for (int k = 0; k < 3; ++k) // Warm-up (memory allocation, first grid build)
+		simulation.step(dt, inputs);
+
+	benchmark_result result = { backend, nb_fish, threads, 0, 0.0 };
+	double const t0 = now();
+	do {
+		simulation.step(dt, inputs);
+		result.steps++;
+		result.seconds = now() - t0;
+	} while (result.seconds < duration || result.steps < 3);
+	return result;
+}
+
+// Time of a parallel loop doing almost no work: cost of the fork/join of each backend
+static double loop_overhead(std::string const& backend, int iterations, int threads, double duration) {
+	std::vector<float> values(iterations, 1.0f);
+	thread_pool pool(backend == "thread_pool" ? threads : 1);
+#ifdef _OPENMP
+	omp_set_num_threads(threads);
+#endif
+	int loops = 0;
+	double const t0 = now();
+	double seconds = 0;
+	do {
+		if (backend == "thread_pool")
+			parallel_for(0, iterations, [&](int k) { values[k] = values[k] * 0.5f + 0.5f; }, 0, pool);
+		else {
+#pragma omp parallel for
+			for (int k = 0; k < iterations; ++k)
+				values[k] = values[k] * 0.5f + 0.5f;
+		}
+		loops++;
+		seconds = now() - t0;
+	} while (seconds < duration);
+	return seconds / loops;
+}
+
+int main(int argc, char* argv[])
+{
+	double const duration = argc > 1 ? std::atof(argv[1]) : 0.5;
+
+	int max_threads = std::max(1, int(std::thread::hardware_concurrency()));
+	std::vector<std::string> backends = { "thread_pool" };
+#ifdef _OPENMP
+	max_threads = omp_get_max_threads();
+	backends.insert(backends.begin(), "openmp");
+#endif
+	std::vector<int> thread_counts;
+	for (int t = 1; t < max_threads; t *= 2)
+		thread_counts.push_back(t);
+	thread_counts.push_back(max_threads);
+
+	std::vector<int> const flock_sizes = { 100, 1000, 10000, 100000 };
+
+	std::cout << "{\n";
+	std::cout << "  \"simd\": \"" << flock_simd_name() << "\",\n";
+	std::cout << "  \"max_threads\": " << max_threads << ",\n";
+	std::cout << "  \"results\": [";
+	bool first = true;
+	for (int nb_fish : flock_sizes) {
+		for (std::string const& backend : backends) {
+			double time_single_thread = 0;
+			for (int threads : thread_counts) {
+				benchmark_result const r = run(backend, nb_fish, threads, duration);
+				double const time_per_step = r.seconds / r.steps;
+				if (threads == 1)
+					time_single_thread = time_per_step;
+				double const efficiency = time_single_thread / (threads * time_per_step);
+
+				std::cout << (first ? "\n" : ",\n");
+				std::cout << "    { \"backend\": \"" << r.backend << "\", \"nb_fish\": " << r.nb_fish << ", \"threads\": " << r.threads << ", \"steps\": " << r.steps
+					<< ", \"steps_per_second\": " << r.steps / r.seconds
+					<< ", \"ns_per_fish_step\": " << 1e9 * time_per_step / r.nb_fish
+					<< ", \"parallel_efficiency\": " << efficiency << " }";
+				std::cout.flush();
+				first = false;
+			}
+		}
+	}
+	std::cout << "\n  ],\n";
+
+	std::cout << "  \"loop_overhead\": [";
+	first = true;
+	for (int iterations : { 100, 1000, 10000, 100000 }) {
+		for (std::string const& backend : backends) {
+			double const seconds = loop_overhead(backend, iterations, max_threads, duration / 5);
+			std::cout << (first ? "\n" : ",\n");
+			std::cout << "    { \"backend\": \"" << backend << "\", \"iterations\": " << iterations << ", \"threads\": " << max_threads
+				<< ", \"ns_per_loop\": " << 1e9 * seconds << " }";
+			std::cout.flush();
+			first = false;
+		}
+	}
+	std::cout << "\n  ]\n}" << std::endl;
+
+	return 0;
+}
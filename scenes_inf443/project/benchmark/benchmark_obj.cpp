@@ -0,0 +1,100 @@
+// Benchmark of the OBJ loader on the meshes of the project
+//  Compare the single-pass parser of mesh_load_file_obj (memory-mapped file, direct float parsing) to the former loader
+//  reading the file once per attribute with std::getline and std::stringstream (loader::mesh_load_file_obj_multipass).
+//  Both loaders must give the same mesh: the program fails otherwise (also run as a test with a duration of 0).
+//  Also times the binary cache of the meshes (mesh_cache_file, written in the directory mesh_cache of the working directory):
+//  mapping the cache (view sent as is to the GPU), and its copy in a mesh, compared to mesh_load_file_obj (which also fills the normals).
+//  Usage: benchmark_obj [duration_per_file_in_seconds (default 0.5)] [assets directory]
+
+#include "cgp/20_format_parser/mesh_loader/obj/obj.hpp"
+#include "cgp/20_format_parser/mesh_loader/mesh_cache/mesh_cache.hpp"
+#include "cgp/03_files/files.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cgp;
+
+static double now() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+template <typename T>
+static bool same_values(numarray<T> const& a, numarray<T> const& b) {
+	return a.size() == b.size() && (a.size() == 0 || std::memcmp(&a[0], &b[0], a.size() * sizeof(T)) == 0);
+}
+
+static bool same_mesh(mesh const& a, numarray<numarray<int>> const& correspondance_a, mesh const& b, numarray<numarray<int>> const& correspondance_b) {
+	if (!same_values(a.position, b.position) || !same_values(a.uv, b.uv) || !same_values(a.normal, b.normal) || !same_values(a.color, b.color) || !same_values(a.connectivity, b.connectivity))
+		return false;
+	if (correspondance_a.size() != correspondance_b.size())
+		return false;
+	for (size_t k = 0; k < correspondance_a.size(); ++k)
+		if (!same_values(correspondance_a[k], correspondance_b[k]))
+			return false;
+	return true;
+}
+
+// Seconds per load (at least one load)
+template <typename F>
+static double time_per_load(F const& load, double duration) {
+	int loads = 0;
+	double seconds = 0;
+	double const t0 = now();
+	do {
+		load();
+		loads++;
+		seconds = now() - t0;
+	} while (seconds < duration);
+	return seconds / loads;
+}
+
+int main(int argc, char* argv[])
+{
+	double const duration = argc > 1 ? std::atof(argv[1]) : 0.5;
+	std::string const assets = argc > 2 ? std::string(argv[2]) + "/" : std::string(PROJECT_ASSETS);
+	std::vector<std::string> const files = { "Poisson3/shark.obj", "Poisson3/shark2.obj", "seaweed_m.obj", "Volcano_OBJ.obj", "Chateau.obj", "skull/skull.obj" };
+
+	bool all_equal = true;
+	std::cout << "[\n";
+	for (size_t k = 0; k < files.size(); ++k) {
+		std::string const filename = assets + files[k];
+		double const megabytes = file_get_size(filename) / 1e6;
+
+		numarray<numarray<int>> correspondance_multipass, correspondance;
+		mesh const m_multipass = loader::mesh_load_file_obj_multipass(filename, correspondance_multipass);
+		mesh const m = mesh_load_file_obj(filename, correspondance);
+		bool const equal = same_mesh(m_multipass, correspondance_multipass, m, correspondance);
+		all_equal = all_equal && equal;
+
+		double const t_multipass = time_per_load([&]() { numarray<numarray<int>> c; loader::mesh_load_file_obj_multipass(filename, c); }, duration);
+		double const t = time_per_load([&]() { numarray<numarray<int>> c; mesh_load_file_obj(filename, c); }, duration);
+
+		mesh const m_filled = mesh_load_file_obj(filename);
+		mesh_cache_file cache;
+		cache.load(filename, "mesh_cache");
+		bool const equal_cache = same_mesh(m_filled, {}, cache.to_mesh(), {});
+		all_equal = all_equal && equal_cache;
+		double const t_filled = time_per_load([&]() { mesh_load_file_obj(filename); }, duration);
+		double const t_cache_view = time_per_load([&]() { mesh_cache_file c; c.load(filename, "mesh_cache"); }, duration);
+		double const t_cache_mesh = time_per_load([&]() { mesh_cache_file c; c.load(filename, "mesh_cache"); c.to_mesh(); }, duration);
+
+		std::cout << "  {\"file\": \"" << files[k] << "\", \"megabytes\": " << megabytes << ", \"triangles\": " << m.connectivity.size()
+			<< ", \"same_mesh\": " << (equal ? "true" : "false")
+			<< ", \"mb_per_s_multipass\": " << megabytes / t_multipass << ", \"mb_per_s_single_pass\": " << megabytes / t
+			<< ", \"speedup\": " << t_multipass / t
+			<< ", \"same_mesh_cache\": " << (equal_cache ? "true" : "false")
+			<< ", \"ms_load_filled\": " << 1000 * t_filled << ", \"ms_cache_view\": " << 1000 * t_cache_view << ", \"ms_cache_mesh\": " << 1000 * t_cache_mesh << "}" << (k + 1 < files.size() ? "," : "") << "\n";
+	}
+	std::cout << "]" << std::endl;
+
+	if (!all_equal) {
+		std::cerr << "The single-pass OBJ parser differs from the former loader, or the cached mesh from the loaded one" << std::endl;
+		return EXIT_FAILURE;
+	}
+	return 0;
+}
@@ -0,0 +1,85 @@
+// Benchmark of the CPU cost of finding the uniform locations of a draw call (no OpenGL context needed)
+//  A draw of a mesh_drawable with the scene environment sends 15 uniforms (model, image_texture, 9 material values, projection, view, light, time).
+//  Compare the lookup of their locations from the names (string keys of cache_uniform_location_structure, previous path of every uniform)
+//  to the lookup from interned uniform_id (current path, except for the uniforms of uniform_generic_structure such as time).
+//  The locations are pre-filled in the cache: the measure excludes glGetUniformLocation and the glUniform* calls.
+//  Usage: benchmark_uniform [duration_in_seconds (default 0.5)]
+
+#include "cgp/13_opengl/shaders/shaders.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace cgp;
+
+static double now() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static char const* const uniform_names[] = {
+	"model", "image_texture",
+	"material.color", "material.alpha", "material.phong.ambient", "material.phong.diffuse", "material.phong.specular", "material.phong.specular_exponent",
+	"material.texture_settings.use_texture", "material.texture_settings.texture_inverse_v", "material.texture_settings.two_sided",
+	"projection", "view", "light",
+	"time" };
+static int const uniform_count = sizeof(uniform_names) / sizeof(uniform_names[0]);
+static int const shader_count = 8; // Shaders of the scene (mesh, mesh_custom, instancing, skybox, ...)
+
+// Time per draw of the function looking up the uniform_count locations of a draw with the given shader
+template <typename F>
+static double time_per_draw(F const& draw_lookups, double duration) {
+	long long draws = 0;
+	GLint checksum = 0;
+	double const t0 = now();
+	double seconds = 0;
+	do {
+		for (int k = 0; k < 1000; ++k, ++draws)
+			checksum += draw_lookups(GLuint(1 + draws % shader_count));
+		seconds = now() - t0;
+	} while (seconds < duration);
+	if (checksum == 42) std::cerr << ""; // Keep the lookups
+	return seconds / draws;
+}
+
+int main(int argc, char* argv[])
+{
+	double const duration = argc > 1 ? std::atof(argv[1]) : 0.5;
+
+	cache_uniform_location_structure cache;
+	for (GLuint shader = 1; shader <= GLuint(shader_count); ++shader)
+		for (int k = 0; k < uniform_count; ++k)
+			cache.cache_data[shader][uniform_names[k]] = k;
+
+	std::vector<uniform_id> ids;
+	for (int k = 0; k < uniform_count - 1; ++k)
+		ids.push_back(uniform_id(uniform_names[k]));
+
+	// Previous path: a std::string built from the literal, then a search in the map of the shader and in the map of the names
+	double const t_string = time_per_draw([&](GLuint shader) {
+		GLint sum = 0;
+		for (int k = 0; k < uniform_count; ++k)
+			sum += cache.query(shader, uniform_names[k]);
+		return sum;
+	}, duration);
+
+	// Current path: interned names, except the uniforms of uniform_generic_structure (time) still looked up by name
+	double const t_id = time_per_draw([&](GLuint shader) {
+		GLint sum = 0;
+		for (uniform_id const& id : ids)
+			sum += cache.query(shader, id);
+		sum += cache.query(shader, std::string("time"));
+		return sum;
+	}, duration);
+
+	std::cout << "{\n";
+	std::cout << "  \"uniforms_per_draw\": " << uniform_count << ",\n";
+	std::cout << "  \"ns_per_draw_string_lookup\": " << 1e9 * t_string << ",\n";
+	std::cout << "  \"ns_per_draw_uniform_id\": " << 1e9 * t_id << ",\n";
+	std::cout << "  \"speedup\": " << t_string / t_id << "\n";
+	std::cout << "}" << std::endl;
+
+	return 0;
+}
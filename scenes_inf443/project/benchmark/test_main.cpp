@@ -0,0 +1,18 @@
+// Run the tests of the project that do not require a window
+#include "test/test_flock.hpp"
+#include "test/test_heightfield.hpp"
+#include "test/test_signed_distance_field.hpp"
+#include <iostream>
+
+int main(int, char* argv[])
+{
+	std::cout << "Run " << argv[0] << std::endl;
+
+	project_test::test_flock_forces();
+	project_test::test_flock_instance_transforms();
+	project_test::test_heightfield();
+	project_test::test_signed_distance_field();
+
+	std::cout << "All tests passed" << std::endl;
+	return 0;
+}
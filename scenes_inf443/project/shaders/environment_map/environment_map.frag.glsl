@@ -30,9 +30,16 @@ layout(location=0) out vec4 FragColor;
 
 uniform sampler2D image_texture;   // Texture image identifiant
 
-uniform mat4 view;       // View matrix (rigid transform) of the camera - to compute the camera position
+// Camera, light, fog and time shared by all the shaders (uniform buffer updated once per frame by the C++ program)
+layout(std140, row_major) uniform environment_block {
+    mat4 projection; // Projection (perspective or orthogonal) matrix of the camera
+    mat4 view;       // View matrix (rigid transform) of the camera
+    vec3 light;      // Position of the light
+    float time;      // Time of the animation
+    vec3 fogColor;   // Fog color
+    float d_max;     // Distance to the camera of full fog effect
+};
 
-uniform vec3 light; // position of the light
 
 
 // Coefficients of phong illumination model
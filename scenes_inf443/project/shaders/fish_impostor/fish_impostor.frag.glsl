@@ -0,0 +1,85 @@
+#version 330 core
+
+// Fragment shader of the distant fishes: albedo and normal read in the impostor atlas, then the same shading as mesh_custom.frag.glsl
+
+in struct fragment_data {
+    vec3 position;
+    vec2 uv;
+} fragment;
+flat in vec4 fragment_orientation;
+
+layout(location=0) out vec4 FragColor;
+
+uniform sampler2D image_texture;   // Albedo atlas (coverage in alpha)
+uniform sampler2D impostor_normal; // Normal atlas (0.5*n+0.5, in the frame of the fish)
+uniform vec2 fade_distance;        // Cross-fade with the meshes (start distance, width): the quads appear with the complementary dithering of mesh_custom.frag.glsl
+
+layout(std140, row_major) uniform environment_block {
+    mat4 projection;
+    mat4 view;
+    vec3 light;
+    float time;
+    vec3 fogColor;
+    float d_max;
+};
+
+struct phong_structure {
+    float ambient;
+    float diffuse;
+    float specular;
+    float specular_exponent;
+};
+struct texture_settings_structure {
+    bool use_texture;
+    bool texture_inverse_v;
+    bool two_sided;
+};
+struct material_structure {
+    vec3 color;
+    float alpha;
+    phong_structure phong;
+    texture_settings_structure texture_settings;
+};
+uniform material_structure material;
+
+vec3 rotate(vec4 q, vec3 p) {
+    return p + 2.0 * cross(q.xyz, cross(q.xyz, p) + q.w * p);
+}
+
+// Threshold of a 4x4 ordered dithering in ]0,1[
+float dither(vec2 p) {
+    const float bayer[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0, 3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    ivec2 i = ivec2(mod(p, 4.0));
+    return (bayer[i.x + 4 * i.y] + 0.5) / 16.0;
+}
+
+void main() {
+    vec4 albedo = texture(image_texture, fragment.uv);
+    if (albedo.a < 0.5) {
+        discard;
+    }
+
+    mat3 O = transpose(mat3(view));
+    vec3 last_col = vec3(view * vec4(0.0, 0.0, 0.0, 1.0));
+    vec3 camera_position = -O * last_col;
+    float distance = length(fragment.position - camera_position);
+    if (fade_distance.y > 0.0 && clamp((distance - fade_distance.x) / fade_distance.y, 0.0, 1.0) <= dither(gl_FragCoord.xy)) {
+        discard;
+    }
+    float alpha_f = min(distance / d_max, 1.0);
+
+    vec3 N = normalize(rotate(fragment_orientation, 2.0 * texture(impostor_normal, fragment.uv).xyz - 1.0));
+    vec3 L = normalize(light - fragment.position);
+    float diffuse_component = max(dot(N, L), 0.0);
+    float specular_component = 0.0;
+    if (diffuse_component > 0.0) {
+        vec3 R = reflect(-L, N);
+        vec3 V = normalize(camera_position - fragment.position);
+        specular_component = pow(max(dot(R, V), 0.0), material.phong.specular_exponent);
+    }
+
+    vec3 color_object = albedo.rgb / albedo.a;
+    vec3 color_shading = (material.phong.ambient + material.phong.diffuse * diffuse_component) * color_object + material.phong.specular * specular_component * vec3(1.0, 1.0, 1.0);
+    vec3 final_color = mix(color_shading, fogColor, alpha_f);
+    FragColor = vec4(final_color, material.alpha);
+}
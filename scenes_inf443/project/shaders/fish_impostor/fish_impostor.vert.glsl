@@ -0,0 +1,76 @@
+#version 330 core
+
+// Vertex shader of the distant fishes: one camera-facing quad per fish, textured with the view of the impostor atlas closest to the camera direction
+//  The quad has the vertices (+-1, +-1, 0), and the instances the same attributes as fish_instancing.vert.glsl
+
+layout (location = 0) in vec3 vertex_position;
+layout (location = 4) in vec4 instance_position_phase; // position of the fish (xyz) and phase of its animation (w)
+layout (location = 5) in vec4 instance_orientation;    // orientation of the fish (unit quaternion x,y,z,w)
+
+out struct fragment_data
+{
+    vec3 position; // position in world space (on the quad)
+    vec2 uv;       // uv in the atlas
+} fragment;
+flat out vec4 fragment_orientation; // to rotate the normals of the atlas
+
+// Impostor atlas (see impostor_atlas in cgp)
+uniform int impostor_grid;      // Number of views along each side of the atlas
+uniform vec3 impostor_center;   // Bounding sphere of the shark, in the frame of the fish
+uniform float impostor_radius;
+
+layout(std140, row_major) uniform environment_block {
+    mat4 projection;
+    mat4 view;
+    vec3 light;
+    float time;
+    vec3 fogColor;
+    float d_max;
+};
+
+vec3 rotate(vec4 q, vec3 p) {
+    return p + 2.0 * cross(q.xyz, cross(q.xyz, p) + q.w * p);
+}
+
+// Same mapping as octahedral_encode/decode and impostor_view_frame in cgp
+vec2 octahedral_encode(vec3 d) {
+    vec2 p = d.xy / (abs(d.x) + abs(d.y) + abs(d.z));
+    if (d.z < 0.0) {
+        p = (1.0 - abs(p.yx)) * vec2(p.x >= 0.0 ? 1.0 : -1.0, p.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return 0.5 * p + 0.5;
+}
+vec3 octahedral_decode(vec2 uv) {
+    vec2 p = 2.0 * uv - 1.0;
+    vec3 d = vec3(p, 1.0 - abs(p.x) - abs(p.y));
+    if (d.z < 0.0) {
+        d.xy = (1.0 - abs(d.yx)) * vec2(d.x >= 0.0 ? 1.0 : -1.0, d.y >= 0.0 ? 1.0 : -1.0);
+    }
+    return normalize(d);
+}
+
+void main()
+{
+    vec4 q = instance_orientation;
+    vec4 q_inverse = vec4(-q.xyz, q.w);
+    vec3 camera_position = -transpose(mat3(view)) * vec3(view * vec4(0.0, 0.0, 0.0, 1.0));
+
+    // View of the atlas closest to the direction of the camera, in the frame of the fish
+    vec3 center = rotate(q, impostor_center) + instance_position_phase.xyz;
+    vec3 direction = normalize(rotate(q_inverse, camera_position - center));
+    vec2 cell = clamp(floor(octahedral_encode(direction) * float(impostor_grid)), 0.0, float(impostor_grid - 1));
+    vec3 d = octahedral_decode((cell + 0.5) / float(impostor_grid));
+
+    // Quad in the image plane of this view (the quad faces the camera up to the angular size of a cell)
+    vec3 reference = abs(d.z) < 0.999 ? vec3(0.0, 0.0, 1.0) : vec3(1.0, 0.0, 0.0);
+    vec3 right = normalize(cross(reference, d));
+    vec3 up = cross(d, right);
+    vec3 local_position = impostor_center + impostor_radius * (vertex_position.x * right + vertex_position.y * up);
+    vec3 world_position = rotate(q, local_position) + instance_position_phase.xyz;
+
+    fragment.position = world_position;
+    fragment.uv = (cell + 0.5 + 0.5 * vertex_position.xy) / float(impostor_grid);
+    fragment_orientation = q;
+
+    gl_Position = projection * view * vec4(world_position, 1.0);
+}
@@ -0,0 +1,66 @@
+#version 330 core
+
+// Vertex shader of the flock: one instance per fish (same swimming deformation as mesh_custom.vert.glsl)
+
+// Inputs coming from VBOs
+layout (location = 0) in vec3 vertex_position;
+layout (location = 1) in vec3 vertex_normal;
+layout (location = 2) in vec3 vertex_color;
+layout (location = 3) in vec2 vertex_uv;
+layout (location = 4) in vec4 instance_position_phase; // position of the fish (xyz) and phase of its animation (w)
+layout (location = 5) in vec4 instance_orientation;    // orientation of the fish (unit quaternion x,y,z,w)
+
+// Output variables sent to the fragment shader
+out struct fragment_data
+{
+    vec3 position; // vertex position in world space
+    vec3 normal;   // normal in world space
+    vec3 color;    // vertex color 
+    vec2 uv;       // vertex uv
+} fragment;
+
+// Uniform variables expected to receive from the C++ program
+uniform mat4 model; // Model matrix (shared by all the fishes: scaling of the shark)
+uniform mat3 modelNormal; // Normal matrix: transpose(inverse()) of the linear part of model (computed on the C++ side)
+// Camera, light, fog and time shared by all the shaders (uniform buffer updated once per frame by the C++ program)
+layout(std140, row_major) uniform environment_block {
+    mat4 projection; // Projection (perspective or orthogonal) matrix of the camera
+    mat4 view;       // View matrix (rigid transform) of the camera
+    vec3 light;      // Position of the light
+    float time;      // Time of the animation
+    vec3 fogColor;   // Fog color
+    float d_max;     // Distance to the camera of full fog effect
+};
+
+// Rotation of the vector p by the unit quaternion q
+vec3 rotate(vec4 q, vec3 p) {
+    return p + 2.0 * cross(q.xyz, cross(q.xyz, p) + q.w * p);
+}
+
+void main()
+{
+    // Adjusting the deformation factor based on the vertex y position
+    float amplitude = 0.08 * vertex_position.y; // Amplitude increases with y
+    float waveNumber = 4.0; // Frequency of the wave along the y-axis
+    float speed = 3.0; // Speed of the wave
+
+    // Position in the model's local space including the oscillation deformation (shifted by the phase of the fish)
+    float deformation = amplitude * cos(speed * time + vertex_position.y * waveNumber + instance_position_phase.w);
+    vec3 deformed_position = vertex_position + vec3(deformation, 0, 0); // Applying deformation along the x-axis
+
+    // Model transform, then rotation and translation of the fish
+    vec4 model_position = model * vec4(deformed_position, 1.0);
+    vec3 world_position = rotate(instance_orientation, model_position.xyz) + instance_position_phase.xyz;
+
+    // Normal transformation to world space
+    vec3 world_normal = rotate(instance_orientation, modelNormal * vertex_normal);
+
+    // Fill the fragment shader inputs
+    fragment.position = world_position;
+    fragment.normal = world_normal;
+    fragment.color = vertex_color;
+    fragment.uv = vertex_uv;
+
+    // Output the final transformed position
+    gl_Position = projection * view * vec4(world_position, 1.0);
+}
@@ -0,0 +1,54 @@
+#version 330 core
+
+// Fragment shader of the impostor views: albedo, or normal encoded as 0.5*n+0.5 (bake_normal = 1). The alpha stores the coverage.
+
+in struct fragment_data {
+    vec3 normal;
+    vec3 color;
+    vec2 uv;
+} fragment;
+
+layout(location=0) out vec4 FragColor;
+
+uniform sampler2D image_texture;
+uniform int bake_normal;
+
+struct phong_structure {
+    float ambient;
+    float diffuse;
+    float specular;
+    float specular_exponent;
+};
+struct texture_settings_structure {
+    bool use_texture;
+    bool texture_inverse_v;
+    bool two_sided;
+};
+struct material_structure {
+    vec3 color;
+    float alpha;
+    phong_structure phong;
+    texture_settings_structure texture_settings;
+};
+uniform material_structure material;
+
+void main() {
+    if (bake_normal == 1) {
+        vec3 N = normalize(fragment.normal);
+        if (material.texture_settings.two_sided && gl_FrontFacing == false) {
+            N = -N;
+        }
+        FragColor = vec4(0.5 * N + 0.5, 1.0);
+        return;
+    }
+
+    vec2 uv_image = fragment.uv;
+    if (material.texture_settings.texture_inverse_v) {
+        uv_image.y = 1.0 - uv_image.y;
+    }
+    vec4 color_image_texture = texture(image_texture, uv_image);
+    if (!material.texture_settings.use_texture) {
+        color_image_texture = vec4(1.0, 1.0, 1.0, 1.0);
+    }
+    FragColor = vec4(fragment.color * material.color * color_image_texture.rgb, 1.0);
+}
@@ -0,0 +1,28 @@
+#version 330 core
+
+// Vertex shader of the impostor views (see impostor_atlas::bake): the mesh is placed by its model only, in front of an orthographic camera
+
+layout (location = 0) in vec3 vertex_position;
+layout (location = 1) in vec3 vertex_normal;
+layout (location = 2) in vec3 vertex_color;
+layout (location = 3) in vec2 vertex_uv;
+
+out struct fragment_data
+{
+    vec3 normal; // normal in the frame of the mesh (after the model)
+    vec3 color;
+    vec2 uv;
+} fragment;
+
+uniform mat4 model;
+uniform mat3 modelNormal;
+uniform mat4 view;       // Camera of the view baked in the current cell
+uniform mat4 projection; // Orthographic projection of the bounding sphere
+
+void main()
+{
+    fragment.normal = modelNormal * vertex_normal;
+    fragment.color = vertex_color;
+    fragment.uv = vertex_uv;
+    gl_Position = projection * view * model * vec4(vertex_position, 1.0);
+}
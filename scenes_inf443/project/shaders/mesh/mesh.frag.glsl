@@ -13,10 +13,15 @@ layout(location=0) out vec4 FragColor;
 
 // Uniforms
 uniform sampler2D image_texture;    // Texture image
-uniform mat4 view;                  // View matrix
-uniform vec3 light;                 // Light position
-uniform vec3 fogColor = vec3(0.2, 0.5, 0.6); // Fog color
-uniform float d_max = 50.0;        // Max distance for full fog effect
+// Camera, light, fog and time shared by all the shaders (uniform buffer updated once per frame by the C++ program)
+layout(std140, row_major) uniform environment_block {
+    mat4 projection; // Projection (perspective or orthogonal) matrix of the camera
+    mat4 view;       // View matrix (rigid transform) of the camera
+    vec3 light;      // Position of the light
+    float time;      // Time of the animation
+    vec3 fogColor;   // Fog color
+    float d_max;     // Distance to the camera of full fog effect
+};
 
 // Phong and texture settings
 struct phong_structure {
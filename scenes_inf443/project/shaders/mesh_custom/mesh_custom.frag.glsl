@@ -13,10 +13,16 @@ layout(location=0) out vec4 FragColor;
 
 // Uniforms
 uniform sampler2D image_texture;    // Texture image
-uniform mat4 view;                  // View matrix
-uniform vec3 light;                 // Light position
-uniform vec3 fogColor = vec3(0.2, 0.5, 0.6); // Fog color
-uniform float d_max = 50.0;        // Max distance for full fog effect
+uniform vec2 fade_distance;         // Cross-fade toward the impostors (start distance, width): the fragments disappear with an ordered dithering (width 0: no fade)
+// Camera, light, fog and time shared by all the shaders (uniform buffer updated once per frame by the C++ program)
+layout(std140, row_major) uniform environment_block {
+    mat4 projection; // Projection (perspective or orthogonal) matrix of the camera
+    mat4 view;       // View matrix (rigid transform) of the camera
+    vec3 light;      // Position of the light
+    float time;      // Time of the animation
+    vec3 fogColor;   // Fog color
+    float d_max;     // Distance to the camera of full fog effect
+};
 
 // Phong and texture settings
 struct phong_structure {
@@ -38,6 +44,13 @@ struct material_structure {
 }; 
 uniform material_structure material;
 
+// Threshold of a 4x4 ordered dithering in ]0,1[
+float dither(vec2 p) {
+    const float bayer[16] = float[16](0.0, 8.0, 2.0, 10.0, 12.0, 4.0, 14.0, 6.0, 3.0, 11.0, 1.0, 9.0, 15.0, 7.0, 13.0, 5.0);
+    ivec2 i = ivec2(mod(p, 4.0));
+    return (bayer[i.x + 4 * i.y] + 0.5) / 16.0;
+}
+
 void main() {
     // Compute the position of the camera
     mat3 O = transpose(mat3(view));
@@ -47,6 +60,9 @@ void main() {
     // Distance from the fragment to the camera
     float distance = length(fragment.position - camera_position);
     float alpha_f = min(distance / d_max, 1.0);
+    if (fade_distance.y > 0.0 && clamp((distance - fade_distance.x) / fade_distance.y, 0.0, 1.0) > dither(gl_FragCoord.xy)) {
+        discard;
+    }
 
     // Normal calculations
     vec3 N = normalize(fragment.normal);
@@ -17,9 +17,16 @@ out struct fragment_data
 
 // Uniform variables expected to receive from the C++ program
 uniform mat4 model; // Model matrix
-uniform mat4 view;  // View matrix of the camera
-uniform mat4 projection; // Projection matrix
-uniform float time;
+uniform mat3 modelNormal; // Normal matrix: transpose(inverse()) of the linear part of model (computed on the C++ side)
+// Camera, light, fog and time shared by all the shaders (uniform buffer updated once per frame by the C++ program)
+layout(std140, row_major) uniform environment_block {
+    mat4 projection; // Projection (perspective or orthogonal) matrix of the camera
+    mat4 view;       // View matrix (rigid transform) of the camera
+    vec3 light;      // Position of the light
+    float time;      // Time of the animation
+    vec3 fogColor;   // Fog color
+    float d_max;     // Distance to the camera of full fog effect
+};
 
 void main()
 {
@@ -37,8 +44,7 @@ void main()
     vec4 world_position = model * vec4(deformed_position, 1.0);
 
     // Normal transformation to world space
-    mat4 modelNormal = transpose(inverse(model));
-    vec4 world_normal = modelNormal * vec4(vertex_normal, 0.0);
+    vec4 world_normal = vec4(modelNormal * vertex_normal, 0.0);
 
     // Calculate the projected position
     vec4 position_projected = projection * view * world_position;
@@ -0,0 +1,65 @@
+#version 330 core
+
+// Vertex shader of the seaweed: one instance per plant (same deformation as mesh_custom.vert - Copie.glsl)
+
+// Inputs coming from VBOs
+layout (location = 0) in vec3 vertex_position;
+layout (location = 1) in vec3 vertex_normal;
+layout (location = 2) in vec3 vertex_color;
+layout (location = 3) in vec2 vertex_uv;
+layout (location = 4) in vec3 instance_color;  // color of the plant
+layout (location = 5) in mat4 instance_matrix; // transform of the plant (locations 5 to 8)
+
+// Output variables sent to the fragment shader
+out struct fragment_data
+{
+    vec3 position; // vertex position in world space
+    vec3 normal;   // normal in world space
+    vec3 color;    // vertex color 
+    vec2 uv;       // vertex uv
+} fragment;
+
+// Uniform variables expected to receive from the C++ program
+uniform mat4 model; // Model matrix (shared by all the plants)
+// Camera, light, fog and time shared by all the shaders (uniform buffer updated once per frame by the C++ program)
+layout(std140, row_major) uniform environment_block {
+    mat4 projection; // Projection (perspective or orthogonal) matrix of the camera
+    mat4 view;       // View matrix (rigid transform) of the camera
+    vec3 light;      // Position of the light
+    float time;      // Time of the animation
+    vec3 fogColor;   // Fog color
+    float d_max;     // Distance to the camera of full fog effect
+};
+
+void main()
+{
+    // Adjusting the deformation factor based on the vertex y position
+    // Increase deformation exponentially as y increases
+    float amplitude = 0.08 * vertex_position.y; // Amplitude increases with y
+    float waveNumber = 4.0; // Frequency of the wave along the y-axis
+    float speed = 3.0; // Speed of the wave
+
+    // Position in the model's local space including the oscillation deformation
+    float deformation = amplitude * cos(speed * time + vertex_position.y * waveNumber);
+    vec3 deformed_position = vertex_position + vec3(deformation, 0, 0); // Applying deformation along the x-axis
+
+    // Convert local position to world position
+    mat4 M = instance_matrix * model;
+    vec4 world_position = M * vec4(deformed_position, 1.0);
+
+    // Normal transformation to world space
+    mat4 modelNormal = transpose(inverse(M));
+    vec4 world_normal = modelNormal * vec4(vertex_normal, 0.0);
+
+    // Calculate the projected position
+    vec4 position_projected = projection * view * world_position;
+
+    // Fill the fragment shader inputs
+    fragment.position = world_position.xyz;
+    fragment.normal = world_normal.xyz;
+    fragment.color = vertex_color * instance_color;
+    fragment.uv = vertex_uv;
+
+    // Output the final transformed position
+    gl_Position = position_projected;
+}
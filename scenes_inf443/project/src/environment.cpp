@@ -22,12 +22,44 @@ std::string project::path = "";
 
 
 
+static uniform_id const uniform_projection("projection");
+static uniform_id const uniform_view("view");
+static uniform_id const uniform_light("light");
+
+// Binding point of the uniform buffer of the environment (shared by all the shaders)
+static GLuint const environment_block_binding = 0;
+static_assert(sizeof(environment_block_structure) == 160, "environment_block_structure must match the std140 layout of environment_block");
+
+void environment_structure::send_opengl_uniform_buffer()
+{
+	environment_block_structure block;
+	block.projection = camera_projection;
+	block.view = camera_view;
+	block.light = light;
+	block.time = time;
+	block.fog_color = fog_color;
+	block.fog_distance = fog_distance;
+
+	if (uniform_buffer.id == 0)
+		uniform_buffer.initialize_data_on_gpu(sizeof(environment_block_structure), environment_block_binding);
+	uniform_buffer.update(block);
+}
+
 void environment_structure::send_opengl_uniform(opengl_shader_structure const& shader, bool expected) const
 {
-	opengl_uniform(shader, "projection", camera_projection, expected);
-	opengl_uniform(shader, "view", camera_view, expected);
-	opengl_uniform(shader, "light", light, false);
+	// The block of a shader is connected to the binding point the first time the shader is used
+	if (shader.id >= shader_reads_uniform_buffer.size())
+		shader_reads_uniform_buffer.resize(shader.id + 1, 0);
+	char& reads_uniform_buffer = shader_reads_uniform_buffer[shader.id];
+	if (reads_uniform_buffer == 0)
+		reads_uniform_buffer = opengl_uniform_block_binding(shader.id, "environment_block", environment_block_binding) ? 1 : 2;
+
+	if (reads_uniform_buffer == 2) {
+		opengl_uniform(shader, uniform_projection, camera_projection, expected);
+		opengl_uniform(shader, uniform_view, camera_view, expected);
+		opengl_uniform(shader, uniform_light, light, false);
+	}
 
 	uniform_generic.send_opengl_uniform(shader, false);
 
-}
\ No newline at end of file
+}
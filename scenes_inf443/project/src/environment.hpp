@@ -25,15 +25,40 @@ struct environment_structure : environment_generic_structure
 	// The position of a light
 	vec3 light = {1,1,1};
 
+	// Fog added to the shading: color and distance to the camera of full fog
+	vec3 fog_color = {0.2f, 0.5f, 0.6f};
+	float fog_distance = 50.0f;
+
+	// Time of the animation (ex. deformation of the fishes and seaweed)
+	float time = 0.0f;
+
 	// Additional uniforms that can be attached to the environment if needed (empty by default)
 	uniform_generic_structure uniform_generic;
 
 
+	// Upload the camera, light, fog and time to the uniform buffer read by the shaders declaring environment_block
+	//  To be called once per frame, after these variables are updated and before the drawing.
+	void send_opengl_uniform_buffer();
+
 	// This function will be called in the draw() call of a drawable element.
 	//  The function is expected to send the uniform variables to the shader (e.g. camera, light)
+	//  Shaders declaring environment_block already read them from the uniform buffer: only uniform_generic is sent to them.
 	void send_opengl_uniform(opengl_shader_structure const& shader, bool expected = true) const override;
 
+private:
+	opengl_ubo_structure uniform_buffer;
+	mutable std::vector<char> shader_reads_uniform_buffer; // For each shader id: 0 = not checked yet, 1 = declares environment_block, 2 = does not
+};
 
+// Content of the uniform block environment_block (std140 layout: each vec3 is padded to 16 bytes by the following float)
+struct environment_block_structure
+{
+	mat4 projection;
+	mat4 view;
+	vec3 light;
+	float time;
+	vec3 fog_color;
+	float fog_distance;
 };
 
 
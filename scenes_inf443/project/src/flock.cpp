@@ -0,0 +1,282 @@
+#include "flock.hpp"
+#include "fonctions.hpp"
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define FLOCK_SIMD_AVX2
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define FLOCK_SIMD_SSE2
+#endif
+
+using namespace cgp;
+
+vec3 interaction_force(vec3 const& pi, vec3 const& vi, vec3 const& pj, vec3 const& vj) {
+	float angle = angle_between(vi, pj - pi);
+	if (fabs(angle) < Pi / 1.5f) {  //Field of view
+		float distance = norm(pi - pj);
+		if (distance > 0) {
+			if (distance < 1.5f) {
+				return (pi - pj) / pow(distance, 2); //Repulsion
+			}
+			else if (distance < 2) {
+				return exp(-3 * distance) * (vj - vi); //Same vitess
+			}
+			else if (distance < 3) {
+				return (pj - pi) * pow(distance, 1); // Attraction
+			}
+		}
+	}
+	return vec3(0, 0, 0);
+}
+
+void flock_interaction_forces_reference(std::vector<vec3> const& p, std::vector<vec3> const& v, std::vector<vec3>& F) {
+	int const N = int(p.size());
+	F.resize(N);
+#ifdef _OPENMP
+#pragma omp parallel for
+#endif
+	for (int i = 0; i < N; i++) {
+		vec3 Fi = { 0,0,0 };
+		for (int j = 0; j < N; j++) {
+			if (i == j) continue;
+			Fi += interaction_force(p[i], v[i], p[j], v[j]);
+		}
+		F[i] = Fi;
+	}
+}
+
+
+// ****************************************** //
+// SIMD abstraction: the kernel is written once for a generic lane type S
+//  S::type is a pack of S::width floats, S::mask the result of a comparison
+// ****************************************** //
+
+namespace {
+	struct simd_scalar {
+		static int const width = 1;
+		typedef float type;
+		typedef bool mask;
+		static type load(float const* p) { return *p; }
+		static type set(float a) { return a; }
+		static type sqrt(type a) { return std::sqrt(a); }
+		static type exp(type a) { return exp_fast(a); }
+		static type select(mask m, type a, type b) { return m ? a : b; }
+		static float sum(type a) { return a; }
+	};
+
+#if defined(FLOCK_SIMD_AVX2)
+	struct simd_float { __m256 v; };
+	struct simd_mask { __m256 v; };
+	inline simd_float operator+(simd_float a, simd_float b) { return { _mm256_add_ps(a.v, b.v) }; }
+	inline simd_float operator-(simd_float a, simd_float b) { return { _mm256_sub_ps(a.v, b.v) }; }
+	inline simd_float operator*(simd_float a, simd_float b) { return { _mm256_mul_ps(a.v, b.v) }; }
+	inline simd_float operator/(simd_float a, simd_float b) { return { _mm256_div_ps(a.v, b.v) }; }
+	inline simd_mask operator<(simd_float a, simd_float b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ) }; }
+	inline simd_mask operator>(simd_float a, simd_float b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ) }; }
+	inline simd_mask operator>=(simd_float a, simd_float b) { return { _mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ) }; }
+	inline simd_mask operator&(simd_mask a, simd_mask b) { return { _mm256_and_ps(a.v, b.v) }; }
+
+	struct simd_native {
+		static int const width = 8;
+		typedef simd_float type;
+		typedef simd_mask mask;
+		static type load(float const* p) { return { _mm256_loadu_ps(p) }; }
+		static type set(float a) { return { _mm256_set1_ps(a) }; }
+		static type sqrt(type a) { return { _mm256_sqrt_ps(a.v) }; }
+		static type select(mask m, type a, type b) { return { _mm256_blendv_ps(b.v, a.v, m.v) }; }
+		static float sum(type a) {
+			__m128 s = _mm_add_ps(_mm256_castps256_ps128(a.v), _mm256_extractf128_ps(a.v, 1));
+			alignas(16) float t[4];
+			_mm_store_ps(t, s);
+			return t[0] + t[1] + t[2] + t[3];
+		}
+		// Same approximation as exp_fast: 2^n * P(f) with x*log2(e) = n + f, |f| <= 1/2
+		static type exp(type a) {
+			__m256 t = _mm256_mul_ps(a.v, _mm256_set1_ps(1.44269504f));
+			t = _mm256_max_ps(_mm256_min_ps(t, _mm256_set1_ps(126.0f)), _mm256_set1_ps(-126.0f));
+			__m256i const n = _mm256_cvtps_epi32(t);
+			__m256 const f = _mm256_sub_ps(t, _mm256_cvtepi32_ps(n));
+			__m256 p = _mm256_set1_ps(1.54035304e-4f);
+			p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(1.33335581e-3f));
+			p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(9.61812911e-3f));
+			p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(5.55041087e-2f));
+			p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(2.40226507e-1f));
+			p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(6.93147181e-1f));
+			p = _mm256_add_ps(_mm256_mul_ps(p, f), _mm256_set1_ps(1.0f));
+			__m256 const scale = _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_add_epi32(n, _mm256_set1_epi32(127)), 23));
+			return { _mm256_mul_ps(p, scale) };
+		}
+	};
+#elif defined(FLOCK_SIMD_SSE2)
+	struct simd_float { __m128 v; };
+	struct simd_mask { __m128 v; };
+	inline simd_float operator+(simd_float a, simd_float b) { return { _mm_add_ps(a.v, b.v) }; }
+	inline simd_float operator-(simd_float a, simd_float b) { return { _mm_sub_ps(a.v, b.v) }; }
+	inline simd_float operator*(simd_float a, simd_float b) { return { _mm_mul_ps(a.v, b.v) }; }
+	inline simd_float operator/(simd_float a, simd_float b) { return { _mm_div_ps(a.v, b.v) }; }
+	inline simd_mask operator<(simd_float a, simd_float b) { return { _mm_cmplt_ps(a.v, b.v) }; }
+	inline simd_mask operator>(simd_float a, simd_float b) { return { _mm_cmpgt_ps(a.v, b.v) }; }
+	inline simd_mask operator>=(simd_float a, simd_float b) { return { _mm_cmpge_ps(a.v, b.v) }; }
+	inline simd_mask operator&(simd_mask a, simd_mask b) { return { _mm_and_ps(a.v, b.v) }; }
+
+	struct simd_native {
+		static int const width = 4;
+		typedef simd_float type;
+		typedef simd_mask mask;
+		static type load(float const* p) { return { _mm_loadu_ps(p) }; }
+		static type set(float a) { return { _mm_set1_ps(a) }; }
+		static type sqrt(type a) { return { _mm_sqrt_ps(a.v) }; }
+		static type select(mask m, type a, type b) { return { _mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v)) }; }
+		static float sum(type a) {
+			alignas(16) float t[4];
+			_mm_store_ps(t, a.v);
+			return t[0] + t[1] + t[2] + t[3];
+		}
+		// Same approximation as exp_fast: 2^n * P(f) with x*log2(e) = n + f, |f| <= 1/2
+		static type exp(type a) {
+			__m128 t = _mm_mul_ps(a.v, _mm_set1_ps(1.44269504f));
+			t = _mm_max_ps(_mm_min_ps(t, _mm_set1_ps(126.0f)), _mm_set1_ps(-126.0f));
+			__m128i const n = _mm_cvtps_epi32(t);
+			__m128 const f = _mm_sub_ps(t, _mm_cvtepi32_ps(n));
+			__m128 p = _mm_set1_ps(1.54035304e-4f);
+			p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(1.33335581e-3f));
+			p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(9.61812911e-3f));
+			p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(5.55041087e-2f));
+			p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(2.40226507e-1f));
+			p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(6.93147181e-1f));
+			p = _mm_add_ps(_mm_mul_ps(p, f), _mm_set1_ps(1.0f));
+			__m128 const scale = _mm_castsi128_ps(_mm_slli_epi32(_mm_add_epi32(n, _mm_set1_epi32(127)), 23));
+			return { _mm_mul_ps(p, scale) };
+		}
+	};
+#else
+	typedef simd_scalar simd_native;
+#endif
+
+	// Accumulate in (Fx,Fy,Fz) the forces exerted on fish i by the fishes [start,end) of the arrays (x,y,z,vx,vy,vz)
+	//  Process packs of S::width fishes and return the index of the first fish that was not processed
+	template <typename S>
+	int accumulate_interaction(vec3 const& pi, vec3 const& vi, float const* x, float const* y, float const* z, float const* vx, float const* vy, float const* vz, int start, int end,
+		typename S::type& Fx, typename S::type& Fy, typename S::type& Fz)
+	{
+		typedef typename S::type V;
+		V const pix = S::set(pi.x), piy = S::set(pi.y), piz = S::set(pi.z);
+		V const vix = S::set(vi.x), viy = S::set(vi.y), viz = S::set(vi.z);
+		V const cone = S::set(-0.5f * norm(vi)); // cos(angle) > cos(2Pi/3) = -1/2
+		V const zero = S::set(0.0f), one = S::set(1.0f), minus_three = S::set(-3.0f);
+		V const d_repulsion = S::set(1.5f), d_alignment = S::set(2.0f), d_attraction = S::set(3.0f);
+
+		int j = start;
+		for (; j + S::width <= end; j += S::width) {
+			V const dx = S::load(x + j) - pix; // pj - pi
+			V const dy = S::load(y + j) - piy;
+			V const dz = S::load(z + j) - piz;
+			V const d2 = dx * dx + dy * dy + dz * dz;
+			V const d = S::sqrt(d2);
+			V const dot = vix * dx + viy * dy + viz * dz;
+
+			// Repulsion: -(pj-pi)/d^2, Attraction: (pj-pi)*d, Same vitess: exp(-3d)*(vj-vi)
+			V a = S::select(d < d_repulsion, zero - one / d2, S::select(d < d_alignment, zero, d));
+			V b = S::select((d >= d_repulsion) & (d < d_alignment), S::exp(minus_three * d), zero);
+			auto const valid = (dot > cone * d) & (d > zero) & (d < d_attraction);
+			a = S::select(valid, a, zero);
+			b = S::select(valid, b, zero);
+
+			Fx = Fx + a * dx + b * (S::load(vx + j) - vix);
+			Fy = Fy + a * dy + b * (S::load(vy + j) - viy);
+			Fz = Fz + a * dz + b * (S::load(vz + j) - viz);
+		}
+		return j;
+	}
+
+	// Forces on fish i from the run [start,end), SIMD packs followed by the scalar remainder
+	vec3 interaction_run(vec3 const& pi, vec3 const& vi, soa_vec3_array const& p, soa_vec3_array const& v, int start, int end)
+	{
+		typename simd_native::type Fx = simd_native::set(0), Fy = simd_native::set(0), Fz = simd_native::set(0);
+		int const j = accumulate_interaction<simd_native>(pi, vi, p.x.data(), p.y.data(), p.z.data(), v.x.data(), v.y.data(), v.z.data(), start, end, Fx, Fy, Fz);
+		float fx = 0, fy = 0, fz = 0;
+		accumulate_interaction<simd_scalar>(pi, vi, p.x.data(), p.y.data(), p.z.data(), v.x.data(), v.y.data(), v.z.data(), j, end, fx, fy, fz);
+		return { simd_native::sum(Fx) + fx, simd_native::sum(Fy) + fy, simd_native::sum(Fz) + fz };
+	}
+}
+
+void flock_interaction_forces(flock_structure& flock, spatial_grid_structure const& grid, soa_vec3_array& F, thread_pool* pool) {
+	int const N = flock.size();
+	F.resize(N);
+
+	// Copy of the state in the grid order: the fishes of consecutive cells along x are contiguous in memory
+	flock.p_sorted.resize(N);
+	flock.v_sorted.resize(N);
+	flock_parallel_for(pool, N, 1024, [&](int s) {
+		int const i = grid.sorted_index[s];
+		flock.p_sorted.set(s, flock.p[i]);
+		flock.v_sorted.set(s, flock.v[i]);
+	});
+
+	flock_parallel_for(pool, N, 64, [&](int s) {
+		int const i = grid.sorted_index[s];
+		int const c = grid.particle_cell[i];
+		int const kx = c % grid.dimension.x;
+		int const ky = (c / grid.dimension.x) % grid.dimension.y;
+		int const kz = c / (grid.dimension.x * grid.dimension.y);
+		int const x0 = std::max(kx - 1, 0), x1 = std::min(kx + 1, grid.dimension.x - 1);
+
+		vec3 const pi = flock.p_sorted[s];
+		vec3 const vi = flock.v_sorted[s];
+		vec3 Fi = { 0,0,0 };
+		for (int z = std::max(kz - 1, 0); z <= std::min(kz + 1, grid.dimension.z - 1); z++) {
+			for (int y = std::max(ky - 1, 0); y <= std::min(ky + 1, grid.dimension.y - 1); y++) {
+				int const start = grid.cell_start[grid.cell_index(x0, y, z)];
+				int const end = grid.cell_start[grid.cell_index(x1, y, z) + 1];
+				Fi += interaction_run(pi, vi, flock.p_sorted, flock.v_sorted, start, end);
+			}
+		}
+		F.set(i, Fi);
+	});
+}
+
+void flock_interaction_forces_brute_force(flock_structure const& flock, soa_vec3_array& F, thread_pool* pool) {
+	int const N = flock.size();
+	F.resize(N);
+	flock_parallel_for(pool, N, 64, [&](int i) {
+		F.set(i, interaction_run(flock.p[i], flock.v[i], flock.p, flock.v, 0, N));
+	});
+}
+
+void flock_instance_transforms(flock_snapshot_structure const& snapshot, float alpha, vec4* position_phase, vec4* orientation) {
+	int const N = snapshot.p.size();
+	float const* px = snapshot.p.x.data(), * py = snapshot.p.y.data(), * pz = snapshot.p.z.data();
+	float const* qx = snapshot.p_previous.x.data(), * qy = snapshot.p_previous.y.data(), * qz = snapshot.p_previous.z.data();
+	float const* vx = snapshot.v.x.data(), * vy = snapshot.v.y.data(), * vz = snapshot.v.z.data();
+	float const s = std::sqrt(0.5f); // Quarter turn around z of the model: (0, 0, s, s)
+
+	for (int i = 0; i < N; i++) {
+		float const dx = px[i] - qx[i], dy = py[i] - qy[i], dz = pz[i] - qz[i];
+		float const a = dx * dx + dy * dy + dz * dz < 1.0f ? alpha : 1.0f; //No interpolation for a teleported fish
+		float const phase = 2 * Pi * (0.618034f * i - int(0.618034f * i)); //Golden ratio: neighbor indices swim out of phase
+		position_phase[i] = { qx[i] + a * dx, qy[i] + a * dy, qz[i] + a * dz, phase };
+
+		// Shortest rotation from (1,0,0) to the unit speed u: (cross(e_x,u), 1+dot(e_x,u)) normalized
+		float const n = std::sqrt(vx[i] * vx[i] + vy[i] * vy[i] + vz[i] * vz[i]);
+		float const ux = n > 1e-6f ? vx[i] / n : 1.0f, uy = n > 1e-6f ? vy[i] / n : 0.0f, uz = n > 1e-6f ? vz[i] / n : 0.0f;
+		float rx = 0, ry = -uz, rz = uy, rw = 1 + ux;
+		if (rw < 1e-6f) { ry = 0; rz = 1; rw = 0; } //Fish swimming along -x: half turn around z
+		float const r = std::sqrt(ry * ry + rz * rz + rw * rw);
+		rx /= r; ry /= r; rz /= r; rw /= r;
+
+		// Product with the quarter turn around z
+		orientation[i] = { s * (rx + ry), s * (ry - rx), s * (rz + rw), s * (rw - rz) };
+	}
+}
+
+char const* flock_simd_name() {
+#if defined(FLOCK_SIMD_AVX2)
+	return "AVX2";
+#elif defined(FLOCK_SIMD_SSE2)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include "cgp/01_base/thread_pool/thread_pool.hpp"
+#include "cgp/05_vec/vec.hpp"
+#include "spatial_grid.hpp"
+
+#include <vector>
+#include <cstdlib>
+#include <cstdint>
+#include <new>
+
+// Allocator returning memory aligned for SIMD loads (32 bytes = one AVX register)
+template <typename T, size_t alignment = 32>
+struct aligned_allocator {
+	using value_type = T;
+	template <typename U> struct rebind { using other = aligned_allocator<U, alignment>; };
+
+	aligned_allocator() = default;
+	template <typename U> aligned_allocator(aligned_allocator<U, alignment> const&) {}
+
+	T* allocate(size_t n) {
+		void* raw = std::malloc(n * sizeof(T) + alignment + sizeof(void*));
+		if (raw == nullptr) throw std::bad_alloc();
+		uintptr_t const aligned = (uintptr_t(raw) + sizeof(void*) + alignment - 1) & ~uintptr_t(alignment - 1);
+		reinterpret_cast<void**>(aligned)[-1] = raw; // Store the original pointer just before the aligned block
+		return reinterpret_cast<T*>(aligned);
+	}
+	void deallocate(T* p, size_t) { std::free(reinterpret_cast<void**>(p)[-1]); }
+};
+template <typename T, typename U, size_t A> bool operator==(aligned_allocator<T, A> const&, aligned_allocator<U, A> const&) { return true; }
+template <typename T, typename U, size_t A> bool operator!=(aligned_allocator<T, A> const&, aligned_allocator<U, A> const&) { return false; }
+
+using aligned_float_array = std::vector<float, aligned_allocator<float> >;
+
+
+// Array of vec3 stored as separate x, y, z arrays (structure of arrays)
+struct soa_vec3_array {
+	aligned_float_array x, y, z;
+
+	int size() const { return int(x.size()); }
+	void resize(int N) { x.resize(N); y.resize(N); z.resize(N); }
+	void fill(float value) { x.assign(x.size(), value); y.assign(y.size(), value); z.assign(z.size(), value); }
+
+	cgp::vec3 operator[](int i) const { return { x[i], y[i], z[i] }; }
+	void set(int i, cgp::vec3 const& p) { x[i] = p.x; y[i] = p.y; z[i] = p.z; }
+};
+
+// State of the fishes: positions and speeds
+struct flock_structure {
+	soa_vec3_array p; //Fishes' position
+	soa_vec3_array v; //Fishes' speed
+
+	// Copy of the state ordered by grid cell (filled by flock_interaction_forces)
+	soa_vec3_array p_sorted;
+	soa_vec3_array v_sorted;
+
+	int size() const { return p.size(); }
+	void resize(int N) { p.resize(N); v.resize(N); }
+};
+
+// State of the flock published by the simulation for the display
+struct flock_snapshot_structure {
+	soa_vec3_array p_previous; // Positions at the previous step (used to interpolate between steps)
+	soa_vec3_array p;          // Positions at the last step
+	soa_vec3_array v;          // Speeds at the last step
+	double time = 0;           // Wall-clock time at which the last step was computed (s)
+};
+
+// Per-instance data of the displayed fishes, computed from a snapshot in a single pass over the x/y/z arrays
+//  position_phase[i]: position interpolated between the last two steps (alpha in [0,1]), and phase of the swimming animation
+//  orientation[i]: unit quaternion (x,y,z,w) turning the axis (0,-1,0) of the shark model toward the speed of the fish
+void flock_instance_transforms(flock_snapshot_structure const& snapshot, float alpha, cgp::vec4* position_phase, cgp::vec4* orientation);
+
+
+// Call f(i) for i in [0,N[ on the threads of the pool, or with OpenMP if pool is null
+//  grain: number of consecutive indices run by a task (also the chunk size of the OpenMP dynamic schedule)
+template <typename F>
+void flock_parallel_for(cgp::thread_pool* pool, int N, int grain, F const& f) {
+	if (pool != nullptr) {
+		cgp::parallel_for(0, N, f, grain, *pool);
+		return;
+	}
+#ifdef _OPENMP // Without OpenMP (ex. scene build on Unix) the loop is sequential
+#pragma omp parallel for schedule(dynamic, grain)
+#endif
+	for (int i = 0; i < N; i++)
+		f(i);
+}
+
+
+// Boids interaction forces (repulsion, alignment, attraction) between the fishes, computed with SIMD instructions (AVX2, SSE2, or scalar fallback)
+//  The field of view is a cone test on the dot product and the exponential decay uses exp_fast.
+//  The grid must be built on the current positions with a cell size >= 3 (interaction radius).
+void flock_interaction_forces(flock_structure& flock, spatial_grid_structure const& grid, soa_vec3_array& F, cgp::thread_pool* pool = nullptr);
+// Same forces, considering every pair of fishes
+void flock_interaction_forces_brute_force(flock_structure const& flock, soa_vec3_array& F, cgp::thread_pool* pool = nullptr);
+
+// Scalar reference of the interaction between fish i and fish j (angle_between, pow and exp in double precision)
+cgp::vec3 interaction_force(cgp::vec3 const& pi, cgp::vec3 const& vi, cgp::vec3 const& pj, cgp::vec3 const& vj);
+// Scalar reference of the forces on all the fishes (brute force)
+void flock_interaction_forces_reference(std::vector<cgp::vec3> const& p, std::vector<cgp::vec3> const& v, std::vector<cgp::vec3>& F);
+
+// Name of the SIMD instruction set used by flock_interaction_forces
+char const* flock_simd_name();
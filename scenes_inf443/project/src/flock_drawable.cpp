@@ -0,0 +1,191 @@
+#include "flock_drawable.hpp"
+
+using namespace cgp;
+
+void flock_drawable_structure::initialize_data_on_gpu(mesh const& shark_mesh, opengl_shader_structure const& shader, int nb_fish) {
+	initialize_data_on_gpu(mesh_lod_chain(shark_mesh), shader, nb_fish);
+}
+
+void flock_drawable_structure::initialize_data_on_gpu(std::vector<mesh> const& shark_chain, opengl_shader_structure const& shader, int nb_fish) {
+	shark.initialize_data_on_gpu(shark_chain, shader);
+	instance_count = nb_fish;
+	visible_count = nb_fish;
+	instance_count_total = nb_fish;
+	level_instance_count.assign(shark.level_count(), 0);
+	level_instance_count[0] = nb_fish;
+}
+
+void flock_drawable_structure::initialize_impostor(opengl_shader_structure const& bake_shader, opengl_shader_structure const& impostor_shader) {
+	impostor.bake(shark.drawable, bake_shader);
+
+	mesh quad;
+	quad.position = { {-1,-1,0}, {1,-1,0}, {1,1,0}, {-1,1,0} };
+	quad.uv = { {0,0}, {1,0}, {1,1}, {0,1} };
+	quad.connectivity = { {0,1,2}, {0,2,3} };
+	quad.fill_empty_field();
+	impostor_quad.initialize_data_on_gpu(quad, impostor_shader);
+	impostor_quad.texture = impostor.color.texture;
+	impostor_quad.supplementary_texture["impostor_normal"] = impostor.normal.texture;
+
+	uniforms_impostor.uniform_int["impostor_grid"] = impostor.grid_size;
+	uniforms_impostor.uniform_vec3["impostor_center"] = impostor.center;
+	uniforms_impostor.uniform_float["impostor_radius"] = impostor.radius;
+}
+
+void flock_drawable_structure::update(flock_snapshot_structure const& snapshot, float alpha, opengl_streaming_buffer& stream, frustum const* view_frustum, occlusion_buffer const* occlusion, lod_view const* view) {
+	int const N = snapshot.p.size();
+	int const levels = view != nullptr ? shark.level_count() : 1;
+	bool const impostors = view != nullptr && impostor_distance > 0 && impostor_quad.vao != 0;
+	instance_count_total = N;
+	instance_count = N;
+	visible_count = N;
+	impostor_instance_count = 0;
+	level_instance_count.assign(shark.level_count(), 0);
+	vec2 const fade = impostors ? vec2(impostor_distance, impostor_fade) : vec2(0, 0);
+	uniforms_mesh.uniform_vec2["fade_distance"] = fade;
+	uniforms_impostor.uniform_vec2["fade_distance"] = fade;
+	if (N == 0)
+		return;
+
+	// Without culling, levels of detail nor impostors, the instances are written directly in the stream
+	bool const select = view_frustum != nullptr || levels > 1 || impostors;
+	if (select) {
+		// The model (scaling, offset) is applied before the orientation of the fish: the sphere must contain the model in any rotation
+		mesh_drawable const& d = shark.drawable;
+		vec3 const center = (d.bounds.p_min + d.bounds.p_max) / 2.0f;
+		vec4 const s = transform_bounding_sphere(d.model_matrix(), vec4(center, norm(d.bounds.p_max - d.bounds.p_min) / 2.0f));
+		float const radius = norm(s.xyz()) + s.w;
+
+		position_phase.resize(N);
+		orientation.resize(N);
+		sphere.resize(N);
+		visible.assign(N, 1);
+		as_impostor.assign(N, 0);
+		flock_instance_transforms(snapshot, alpha, position_phase.data(), orientation.data());
+		for (int i = 0; i < N; ++i)
+			sphere[i] = vec4(position_phase[i].xyz(), radius);
+		if (view_frustum != nullptr)
+			visible_count = view_frustum->cull_spheres(sphere.data(), N, visible.data());
+
+		if (view_frustum != nullptr && occlusion != nullptr) {
+			box.resize(N);
+			for (int i = 0; i < N; ++i) {
+				box[i].p_min = sphere[i].xyz() - vec3(radius, radius, radius);
+				box[i].p_max = sphere[i].xyz() + vec3(radius, radius, radius);
+			}
+			visible_count = occlusion->cull_boxes(box.data(), N, visible.data());
+		}
+
+		for (int i = 0; i < N; ++i) {
+			if (!visible[i])
+				continue;
+			// In the cross-fade band, the fish is drawn both as a mesh and as an impostor
+			float const distance = view != nullptr ? norm(sphere[i].xyz() - view->camera_position) : 0.0f;
+			as_impostor[i] = impostors && distance > impostor_distance;
+			if (impostors && distance >= impostor_distance + impostor_fade)
+				visible[i] = impostor_only;
+			else
+				visible[i] = (unsigned char)(1 + lod_level(view != nullptr ? view->screen_size(sphere[i].xyz(), radius) : 1.0f, shark.detail_screen_size, levels));
+		}
+	}
+	instance_count = 0;
+	if (visible_count == 0)
+		return;
+
+	// Fishes grouped by level, then the impostors: first[k] is the index of the first fish of the group k in the stream
+	std::vector<int> first(levels + 2, 0);
+	if (select) {
+		for (int i = 0; i < N; ++i) {
+			if (visible[i] != 0 && visible[i] != impostor_only)
+				level_instance_count[visible[i] - 1]++;
+			impostor_instance_count += as_impostor[i];
+		}
+		for (int k = 0; k < levels; ++k)
+			first[k + 1] = first[k] + level_instance_count[k];
+		first[levels + 1] = first[levels] + impostor_instance_count;
+	}
+	else {
+		level_instance_count[0] = N;
+		first[1] = first[2] = N;
+	}
+	int const count = first[levels + 1];
+	instance_count = count;
+
+	// Checked at each update (not only when the band is crowded): the fishes of the band are written twice
+	assert_cgp(count <= 2 * N && stream.region_size >= stream_size(N), "Stream region of " + str(stream.region_size) + " bytes too small for the instances of " + str(N) + " fishes: " + str(stream_size(N)) + " bytes needed (see flock_drawable_structure::stream_size)");
+	GLsizeiptr const size_attribute = GLsizeiptr(count * sizeof(vec4));
+	opengl_stream_range const range = stream.allocate(2 * size_attribute);
+	vec4* mapped = static_cast<vec4*>(stream.map(range));
+	if (!select)
+		flock_instance_transforms(snapshot, alpha, mapped, mapped + N);
+	else {
+		// Compact the visible fishes (sequential writes in the mapped range of each group)
+		std::vector<int> next(first.begin(), first.end() - 1);
+		for (int i = 0; i < N; ++i) {
+			if (visible[i] != 0 && visible[i] != impostor_only) {
+				int const k = next[visible[i] - 1]++;
+				mapped[k] = position_phase[i];
+				mapped[count + k] = orientation[i];
+			}
+			if (as_impostor[i]) {
+				int const k = next[levels]++;
+				mapped[k] = position_phase[i];
+				mapped[count + k] = orientation[i];
+			}
+		}
+	}
+	stream.unmap();
+
+	for (int k = 0; k <= levels; ++k) {
+		if (first[k + 1] == first[k])
+			continue;
+		if (k > 0 && k < levels)
+			lod_copy_parameters(shark.drawable, shark.level[k - 1]);
+		if (k == levels)
+			impostor_quad.material = shark.drawable.material;
+		opengl_stream_range position_range = range;
+		position_range.offset += GLintptr(first[k] * sizeof(vec4));
+		opengl_stream_range orientation_range = position_range;
+		orientation_range.offset += size_attribute;
+		GLuint const vao = k < levels ? level_drawable(k).vao : impostor_quad.vao;
+		opengl_set_vao_location(vao, stream, position_range, 4, 4, 1);
+		opengl_set_vao_location(vao, stream, orientation_range, 5, 4, 1);
+	}
+}
+
+GLsizeiptr flock_drawable_structure::stream_size(int nb_fish) {
+	return GLsizeiptr(2 * 2 * size_t(nb_fish) * sizeof(vec4)) + 16; // 16: alignment of the range given by allocate
+}
+
+mesh_drawable const& flock_drawable_structure::level_drawable(int k) const {
+	return k == 0 ? shark.drawable : shark.level[k - 1];
+}
+
+int flock_drawable_structure::triangle_count() const {
+	int count = 2 * impostor_instance_count;
+	for (int k = 0; k < int(level_instance_count.size()); ++k)
+		count += level_instance_count[k] * int(level_drawable(k).ebo_connectivity.size);
+	return count;
+}
+
+void draw(flock_drawable_structure const& flock, environment_generic_structure const& environment) {
+	for (int k = 0; k < int(flock.level_instance_count.size()); ++k)
+		if (flock.level_instance_count[k] > 0)
+			draw(flock.level_drawable(k), environment, flock.level_instance_count[k], true, flock.uniforms_mesh);
+	if (flock.impostor_instance_count > 0)
+		draw(flock.impostor_quad, environment, flock.impostor_instance_count, false, flock.uniforms_impostor);
+}
+
+void draw_wireframe(flock_drawable_structure const& flock, environment_generic_structure const& environment) {
+	for (int k = 0; k < int(flock.level_instance_count.size()); ++k)
+		if (flock.level_instance_count[k] > 0)
+			draw_wireframe(flock.level_drawable(k), environment, { 0,0,1 }, flock.level_instance_count[k], true, flock.uniforms_mesh);
+	if (flock.impostor_instance_count > 0)
+		draw_wireframe(flock.impostor_quad, environment, { 0,0,1 }, flock.impostor_instance_count, false, flock.uniforms_impostor);
+}
+
+void push(render_queue& queue, flock_drawable_structure const& flock, environment_generic_structure const& environment) {
+	for (int k = 0; k < int(flock.level_instance_count.size()); ++k)
+		queue.push_instanced(flock.level_drawable(k), environment, flock.level_instance_count[k], true, flock.uniforms_mesh);
+	queue.push_instanced(flock.impostor_quad, environment, flock.impostor_instance_count, false, flock.uniforms_impostor);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "cgp/cgp.hpp"
+#include "flock.hpp"
+
+// Shark mesh drawn for the whole flock with one instanced draw call per level of detail
+//  Each instance reads its position/animation phase (location 4) and its orientation quaternion (location 5)
+//  from a range of a streaming buffer written at each frame (see shaders/fish_instancing).
+//  Beyond impostor_distance, the fishes are drawn as camera-facing quads textured with the impostor atlas of the shark (see shaders/fish_impostor),
+//  with a dithered cross-fade between the mesh and the quad over impostor_fade.
+struct flock_drawable_structure {
+	cgp::lod_mesh_drawable shark;  // Mesh and its levels of detail, texture, material and model scaling shared by all the fishes
+	int instance_count = 0;        // Number of instances drawn (a fish of the cross-fade band counts twice: as a mesh and as an impostor)
+	int visible_count = 0;         // Number of fishes drawn (each fish once)
+	int instance_count_total = 0;  // Number of fishes in the snapshot (visible or not)
+	std::vector<int> level_instance_count; // Number of fishes drawn at each level of detail
+
+	cgp::impostor_atlas impostor;  // Views of the shark (with the model scaling)
+	cgp::mesh_drawable impostor_quad;
+	int impostor_instance_count = 0;
+	float impostor_distance = 0.0f; // Distance to the camera beyond which the fishes are drawn as impostors (0: no impostors)
+	float impostor_fade = 0.0f;     // Width of the cross-fade band (the fishes in the band are drawn both ways)
+	cgp::uniform_generic_structure uniforms_mesh;     // Cross-fade uniforms sent with the draw calls (set by update)
+	cgp::uniform_generic_structure uniforms_impostor;
+
+	void initialize_data_on_gpu(cgp::mesh const& shark_mesh, cgp::opengl_shader_structure const& shader, int nb_fish);
+	// Same with the levels of detail already computed (mesh_lod_chain)
+	void initialize_data_on_gpu(std::vector<cgp::mesh> const& shark_chain, cgp::opengl_shader_structure const& shader, int nb_fish);
+	// Bake the impostor atlas of the shark: to be called once its texture, material and model are set
+	void initialize_impostor(cgp::opengl_shader_structure const& bake_shader, cgp::opengl_shader_structure const& impostor_shader);
+	// Compute the instances from the snapshot (interpolated by alpha between its last two steps)
+	//  They are written directly in a range of the stream allocated for the current frame: (x, y, z, animation phase) of each fish, then the unit quaternions (x, y, z, w).
+	//  If view_frustum is given, only the fishes whose bounding sphere intersects it are written (and drawn).
+	//  If occlusion is given as well, the fishes hidden behind its occluders are skipped too.
+	//  If view is given, each fish is drawn at the level of detail of its projected size (the fishes are grouped by level in the stream),
+	//  or as an impostor beyond impostor_distance (the impostors follow the levels in the stream).
+	void update(flock_snapshot_structure const& snapshot, float alpha, cgp::opengl_streaming_buffer& stream, cgp::frustum const* view_frustum = nullptr, cgp::occlusion_buffer const* occlusion = nullptr, cgp::lod_view const* view = nullptr);
+
+	// Bytes written in the stream by update in the worst case: 2 attributes for 2*nb_fish instances (every fish in the cross-fade band), and the alignment of the range
+	//  The region of the stream given to update must be at least this size.
+	static GLsizeiptr stream_size(int nb_fish);
+
+	// Drawable of the level k (its parameters are copied from the full resolution at each update)
+	cgp::mesh_drawable const& level_drawable(int k) const;
+	// Number of triangles drawn for all the fishes
+	int triangle_count() const;
+
+private:
+	// Instances of all the fishes before culling
+	std::vector<cgp::vec4> position_phase;
+	std::vector<cgp::vec4> orientation;
+	std::vector<cgp::vec4> sphere;
+	std::vector<cgp::bounding_box> box;
+	std::vector<unsigned char> visible; // 0: hidden, otherwise 1 + level of detail (or impostor_only)
+	std::vector<unsigned char> as_impostor;
+	static unsigned char const impostor_only = 255;
+};
+
+void draw(flock_drawable_structure const& flock, cgp::environment_generic_structure const& environment);
+void draw_wireframe(flock_drawable_structure const& flock, cgp::environment_generic_structure const& environment);
+// Push the instanced draw call of each level of detail and of the impostors
+void push(cgp::render_queue& queue, flock_drawable_structure const& flock, cgp::environment_generic_structure const& environment);
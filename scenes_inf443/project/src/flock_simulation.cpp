@@ -0,0 +1,119 @@
+#include "flock_simulation.hpp"
+#include "terrain.hpp"
+#include "fonctions.hpp"
+#include "cgp/08_random_noise/random_stream/random_stream.hpp"
+#include <cmath>
+#include <algorithm>
+#include <iostream>
+
+using namespace cgp;
+
+// Random position above the terrain and random speed of a fish
+static void random_fish_state(random_stream& rng, heightfield_structure const& ground, float l, vec3& p, vec3& v) {
+	float x = rng.uniform(-l, l);
+	float y = rng.uniform(-l, l);
+	float z = ground.height(x, y);
+	p = { x, y, rng.uniform(1, l - z - 1) + z };
+	v = vec3(rng.uniform(-1, 1), rng.uniform(-1, 1), rng.uniform(-1, 1));
+}
+
+void flock_simulation_structure::initialize(int nb_fish, float L_terrain_arg, uint64_t seed_arg) {
+	L_terrain = L_terrain_arg;
+	seed = seed_arg;
+	step_count = 0;
+	float l = L_terrain / 2;
+	ground = create_dune_heightfield(1.2f * L_terrain);
+	obstacles_need_update = true;
+
+	flock.resize(nb_fish);
+	for (int i = 0; i < nb_fish; i++) {
+		random_stream rng(seed, i); //One stream per fish
+		vec3 p0, v0;
+		random_fish_state(rng, ground, l, p0, v0);
+
+		flock.p.set(i, p0);
+		flock.v.set(i, v0);
+	}
+}
+
+void flock_simulation_structure::add_obstacle(mesh const& shape, affine const& transform) {
+	for (uint3 const& tri : shape.connectivity)
+		for (int k = 0; k < 3; ++k)
+			obstacle_triangles.push_back(transform * shape.position[tri[k]]);
+	obstacles_need_update = true;
+}
+
+void flock_simulation_structure::update_obstacles() {
+	float const scale = L_terrain / 30;
+	float const l = L_terrain / 2;
+	float const band = 2 * obstacle_distance * scale; // The repulsion is negligible beyond
+	float const voxel = obstacle_voxel_size * scale;
+
+	float z_min = l;
+	for (vec4 const& n : ground.node)
+		z_min = std::min(z_min, n.x);
+	vec3 const p_min = { -l - band, -l - band, z_min - band };
+	vec3 const p_max = { l + band, l + band, l + band };
+	vec3 const length = p_max - p_min;
+	int3 const samples = { int(length.x / voxel) + 2, int(length.y / voxel) + 2, int(length.z / voxel) + 2 };
+	spatial_domain_grid_3D const domain = spatial_domain_grid_3D::from_corners(p_min, p_max, samples);
+
+	auto aquarium_distance = [this, l](vec3 const& p) { //Walls, ceiling and terrain
+		vec2 const g = ground.gradient(p.x, p.y);
+		float const d_ground = (p.z - ground.height(p.x, p.y)) / std::sqrt(1 + dot(g, g));
+		float const d_walls = std::min(l - std::abs(p.x), l - std::abs(p.y));
+		float const d_ceiling = l - p.z;
+		return std::min(std::min(d_ground, d_walls), d_ceiling);
+	};
+	obstacles.bake(obstacle_triangles, domain, band, aquarium_distance);
+	obstacles_need_update = false;
+}
+
+void flock_simulation_structure::step(float dt, simulation_inputs_structure const& inputs) {
+	int const nb_fish = flock.size();
+	step_count++;
+	if (obstacles_need_update)
+		update_obstacles();
+
+	if (inputs.neighbor_grid) { //Cell list limiting the neighbor search to the 27 surrounding cells
+		grid.build(flock.p.x.data(), flock.p.y.data(), flock.p.z.data(), nb_fish, interaction_radius, 1, pool);
+		flock_interaction_forces(flock, grid, forces, pool);
+	}
+	else {
+		flock_interaction_forces_brute_force(flock, forces, pool);
+	}
+
+	//Parallel calculation (the interaction forces are already computed: each fish can be updated in place)
+	flock_parallel_for(pool, nb_fish, 256, [&](int i) {
+		vec3 const pi = flock.p[i];
+		vec3 vi = flock.v[i];
+		vec3 F = forces[i];
+
+		//Start Comment here to switch camera
+		vec3 const& cam = inputs.camera_position; //Camera repulsion
+		float cam_dist = norm(pi - cam);
+		if (cam_dist < 6) {
+			F += (pi - cam) * plateau_decay_fast(cam_dist, 7, 2.5f, 5);
+		}
+		//End Comment here to switch camera
+		vec4 const d = obstacles.value(pi); //Repulsion of the scene's objects, walls, ceiling and ground: along the gradient of the distance
+		F += vec3(d.y, d.z, d.w) * plateau_decay_fast(d.x, obstacle_repulsion, obstacle_distance * L_terrain / 30, 6);
+
+
+		vi = vi + dt * F;
+
+		if (norm(vi) > 4 * L_terrain / 30) vi = 4 * L_terrain / 30 * normalize(vi); //Avoid divergence
+
+		vec3 pi_new = pi + dt * vi;
+
+		float l = L_terrain / 2;
+		float acceptance=0.4f;
+		if (std::abs(pi_new.x) > l+ acceptance || std::abs(pi_new.y) > l+ acceptance || std::abs(pi_new.z) > l+ acceptance) { //Deal with out of bound's fish
+			random_stream rng(seed, i, step_count); //Stream of this fish at this step: independent of the thread running it
+			random_fish_state(rng, ground, l, pi_new, vi);
+			std::cerr << "Error : fish out of bound !!" << std::endl;
+		}
+		flock.p.set(i, pi_new);
+		flock.v.set(i, vi);
+	});
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "cgp/05_vec/vec.hpp"
+#include "cgp/09_geometric_transformation/geometric_transformation.hpp"
+#include "cgp/11_mesh/mesh/mesh.hpp"
+#include "flock.hpp"
+#include "spatial_grid.hpp"
+#include "heightfield.hpp"
+#include "signed_distance_field.hpp"
+
+#include <vector>
+#include <cstdint>
+
+// Values read by the simulation at each step, written by the display
+struct simulation_inputs_structure {
+	cgp::vec3 camera_position;
+	float time_scale = 1.0f;
+	bool neighbor_grid = true;
+};
+
+// Boids simulation of the fishes in the aquarium
+//  Only depends on the geometric part of cgp (no OpenGL/GLFW): it can run headless (see benchmark/)
+struct flock_simulation_structure {
+	float L_terrain = 30;            // Size of the aquarium
+	float interaction_radius = 3.0f; // Fishes do not interact beyond this distance
+	float obstacle_repulsion = 15.0f; // Repulsion of the static geometry (obstacles, walls, ceiling and terrain)
+	float obstacle_distance = 1.0f;   // Maximal repulsion below this distance to the static geometry (for L_terrain=30)
+	float obstacle_voxel_size = 0.3f; // Resolution of the distance field (for L_terrain=30)
+	uint64_t seed = 0;               // Seed of the random streams of the fishes
+	uint64_t step_count = 0;         // Number of steps since initialize
+	cgp::thread_pool* pool = &cgp::thread_pool_default(); // Threads of the parallel loops (OpenMP if null)
+
+	flock_structure flock;       // Fishes' position and speed (stored as x/y/z arrays)
+	soa_vec3_array forces;       // Interaction forces between the fishes
+	spatial_grid_structure grid; // Fishes sorted by cell for the neighbor search
+	heightfield_structure ground; // Baked height of the dunes (covers a margin around the aquarium)
+
+	std::vector<cgp::vec3> obstacle_triangles;  // Triangles of the static obstacles in world coordinates (3 positions per triangle)
+	signed_distance_field_structure obstacles;  // Distance to the obstacles, walls, ceiling and terrain
+	bool obstacles_need_update = true;
+
+	// Place nb_fish fishes at random positions above the terrain of size L_terrain
+	//  The random numbers of fish i come from random_stream(seed, i, step): the simulation is reproducible from the seed.
+	void initialize(int nb_fish, float L_terrain, uint64_t seed = 0);
+	// Add the triangles of a static obstacle placed in the scene by the transform (ex. the model of its mesh_drawable)
+	void add_obstacle(cgp::mesh const& shape, cgp::affine const& transform);
+	// Bake the distance field of the static geometry (done by the first step if the obstacles changed)
+	void update_obstacles();
+
+	void step(float dt, simulation_inputs_structure const& inputs);
+
+	int size() const { return flock.size(); }
+};
@@ -1,5 +1,7 @@
 #include "fonctions.hpp"
-#include <random>
+#include "cgp/08_random_noise/random_stream/random_stream.hpp"
+#include <cstring>
+#include <limits>
 
 using namespace cgp;
 
@@ -57,10 +59,7 @@ float angle_between(const vec3& v1, const vec3& v2) {
 }
 
 double rand_interval(double a, double b) {
-	std::random_device rd;
-	std::mt19937 gen(rd());
-	std::uniform_real_distribution<> dis(a, b);
-	return dis(gen);
+	return random_stream_thread().uniform(float(a), float(b));
 }
 
 double plateau_decay(double x, double plateau_level, double plateau_end, double decay_rate) {
@@ -71,3 +70,31 @@ double plateau_decay(double x, double plateau_level, double plateau_end, double
 		return plateau_level * std::exp(-decay_rate * (x - plateau_end));
 	}
 }
+
+float exp_fast(float x) {
+	// exp(x) = 2^(x*log2(e)) = 2^n * 2^f with n integer and |f| <= 1/2, 2^f approximated by its Taylor polynomial
+	float t = x * 1.44269504f;
+	t = std::max(-126.0f, std::min(126.0f, t));
+	float const n = std::floor(t + 0.5f);
+	float const f = t - n;
+	float p = 1.54035304e-4f;
+	p = p * f + 1.33335581e-3f;
+	p = p * f + 9.61812911e-3f;
+	p = p * f + 5.55041087e-2f;
+	p = p * f + 2.40226507e-1f;
+	p = p * f + 6.93147181e-1f;
+	p = p * f + 1.0f;
+	int32_t const bits = (int32_t(n) + 127) << 23;
+	float scale;
+	std::memcpy(&scale, &bits, sizeof(float));
+	return p * scale;
+}
+
+float plateau_decay_fast(float x, float plateau_level, float plateau_end, float decay_rate) {
+	if (x <= plateau_end) {
+		return plateau_level;
+	}
+	else {
+		return plateau_level * exp_fast(-decay_rate * (x - plateau_end));
+	}
+}
@@ -1,12 +1,17 @@
 #pragma once
 
-#include "cgp/cgp.hpp"
+#include "cgp/11_mesh/mesh/mesh.hpp"
 
 cgp::vec4 mesh_center(cgp::mesh const& m, float scaling);
 std::pair<float, cgp::vec2> distance_to_closest_border_with_normal(const cgp::vec2& point, const std::vector<cgp::vec2>& limits);
 
 float angle_between(const cgp::vec3& v1, const cgp::vec3& v2);
 
+// Uniform random value in [a,b[ drawn from the stream of the calling thread (reproducible from the seed given to random_stream_set_seed)
 double rand_interval(double a, double b);
 
-double plateau_decay(double x, double plateau_level, double plateau_end, double decay_rate);
\ No newline at end of file
+double plateau_decay(double x, double plateau_level, double plateau_end, double decay_rate);
+
+// Float approximations used in the simulation loop (relative error about 2e-6 on exp)
+float exp_fast(float x);
+float plateau_decay_fast(float x, float plateau_level, float plateau_end, float decay_rate);
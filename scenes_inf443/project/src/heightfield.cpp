@@ -0,0 +1,121 @@
+#include "heightfield.hpp"
+#include "cgp/01_base/thread_pool/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+
+using namespace cgp;
+
+void heightfield_structure::initialize(std::function<vec4(float, float)> const& f, float length_arg, int N) {
+	assert_cgp(N > 1, "Heightfield needs at least 2 nodes along each direction");
+	length = length_arg;
+	dx = length / (N - 1);
+	node.resize(N, N);
+	parallel_for(0, N, [&](int ky) { // f is called from several threads
+		for (int kx = 0; kx < N; ++kx)
+			node(kx, ky) = f(-length / 2 + kx * dx, -length / 2 + ky * dx);
+	});
+}
+
+void heightfield_structure::locate(float x, float y, int& kx, int& ky, float& u, float& v) const {
+	int const N = node.dimension.x;
+	float const gx = std::min(std::max((x + length / 2) / dx, 0.0f), float(N - 1));
+	float const gy = std::min(std::max((y + length / 2) / dx, 0.0f), float(N - 1));
+	kx = std::min(int(gx), N - 2);
+	ky = std::min(int(gy), N - 2);
+	u = gx - kx;
+	v = gy - ky;
+}
+
+float heightfield_structure::height(float x, float y) const {
+	int kx, ky; float u, v;
+	locate(x, y, kx, ky, u, v);
+	vec4 const* n = &node.data.data[node.index_to_offset(kx, ky)];
+	int const N = node.dimension.x;
+	return (1 - v) * ((1 - u) * n[0].x + u * n[1].x) + v * ((1 - u) * n[N].x + u * n[N + 1].x);
+}
+
+vec2 heightfield_structure::gradient(float x, float y) const {
+	int kx, ky; float u, v;
+	locate(x, y, kx, ky, u, v);
+	vec4 const* n = &node.data.data[node.index_to_offset(kx, ky)];
+	int const N = node.dimension.x;
+	vec4 const g = (1 - v) * ((1 - u) * n[0] + u * n[1]) + v * ((1 - u) * n[N] + u * n[N + 1]);
+	return { g.y, g.z };
+}
+
+vec3 heightfield_structure::normal(float x, float y) const {
+	vec2 const g = gradient(x, y);
+	return normalize(vec3(-g.x, -g.y, 1.0f));
+}
+
+// Cubic Hermite basis: value weights (h00, h01), derivative weights (h10, h11), and their derivatives in t
+static void hermite_basis(float t, float w[4], float dw[4]) {
+	float const t2 = t * t, t3 = t2 * t;
+	w[0] = 2 * t3 - 3 * t2 + 1;  dw[0] = 6 * t2 - 6 * t;      // value at 0
+	w[1] = -2 * t3 + 3 * t2;     dw[1] = -6 * t2 + 6 * t;     // value at 1
+	w[2] = t3 - 2 * t2 + t;      dw[2] = 3 * t2 - 4 * t + 1;  // derivative at 0
+	w[3] = t3 - t2;              dw[3] = 3 * t2 - 2 * t;      // derivative at 1
+}
+
+float heightfield_structure::height_bicubic(float x, float y, vec2& grad) const {
+	int kx, ky; float u, v;
+	locate(x, y, kx, ky, u, v);
+	float wu[4], dwu[4], wv[4], dwv[4];
+	hermite_basis(u, wu, dwu);
+	hermite_basis(v, wv, dwv);
+
+	float h = 0, hu = 0, hv = 0;
+	for (int b = 0; b < 2; ++b) {
+		for (int a = 0; a < 2; ++a) {
+			vec4 const& n = node(kx + a, ky + b);
+			// Derivatives are expressed in the local coordinates (u,v) of the cell: scaled by dx
+			float const c[4] = { n.x, dx * n.y, dx * n.z, dx * dx * n.w };
+			float const Au = wu[a], Bu = wu[2 + a], dAu = dwu[a], dBu = dwu[2 + a];
+			float const Av = wv[b], Bv = wv[2 + b], dAv = dwv[b], dBv = dwv[2 + b];
+			h  += c[0] * Au * Av  + c[1] * Bu * Av  + c[2] * Au * Bv  + c[3] * Bu * Bv;
+			hu += c[0] * dAu * Av + c[1] * dBu * Av + c[2] * dAu * Bv + c[3] * dBu * Bv;
+			hv += c[0] * Au * dAv + c[1] * Bu * dAv + c[2] * Au * dBv + c[3] * Bu * dBv;
+		}
+	}
+	grad = { hu / dx, hv / dx };
+	return h;
+}
+
+float heightfield_structure::height_bicubic(float x, float y) const {
+	vec2 grad;
+	return height_bicubic(x, y, grad);
+}
+
+// The batch loops only use min/max and array accesses (no branch): they can be vectorized with gather instructions
+void heightfield_structure::height(float const* x, float const* y, float* h, int count) const {
+	int const N = node.dimension.x;
+	float const* n = &node.data.data[0].x; // 4 floats per node
+	float const inv_dx = 1.0f / dx;
+	for (int k = 0; k < count; ++k) {
+		float const gx = std::min(std::max((x[k] + length / 2) * inv_dx, 0.0f), float(N - 1));
+		float const gy = std::min(std::max((y[k] + length / 2) * inv_dx, 0.0f), float(N - 1));
+		int const kx = std::min(int(gx), N - 2);
+		int const ky = std::min(int(gy), N - 2);
+		float const u = gx - kx, v = gy - ky;
+		int const o = 4 * (kx + N * ky);
+		h[k] = (1 - v) * ((1 - u) * n[o] + u * n[o + 4]) + v * ((1 - u) * n[o + 4 * N] + u * n[o + 4 * N + 4]);
+	}
+}
+
+void heightfield_structure::height_and_gradient(float const* x, float const* y, float* h, float* dhdx, float* dhdy, int count) const {
+	int const N = node.dimension.x;
+	float const* n = &node.data.data[0].x;
+	float const inv_dx = 1.0f / dx;
+	for (int k = 0; k < count; ++k) {
+		float const gx = std::min(std::max((x[k] + length / 2) * inv_dx, 0.0f), float(N - 1));
+		float const gy = std::min(std::max((y[k] + length / 2) * inv_dx, 0.0f), float(N - 1));
+		int const kx = std::min(int(gx), N - 2);
+		int const ky = std::min(int(gy), N - 2);
+		float const u = gx - kx, v = gy - ky;
+		float const w00 = (1 - u) * (1 - v), w10 = u * (1 - v), w01 = (1 - u) * v, w11 = u * v;
+		int const o00 = 4 * (kx + N * ky), o10 = o00 + 4, o01 = o00 + 4 * N, o11 = o01 + 4;
+		h[k]    = w00 * n[o00]     + w10 * n[o10]     + w01 * n[o01]     + w11 * n[o11];
+		dhdx[k] = w00 * n[o00 + 1] + w10 * n[o10 + 1] + w01 * n[o01 + 1] + w11 * n[o11 + 1];
+		dhdy[k] = w00 * n[o00 + 2] + w10 * n[o10 + 2] + w01 * n[o01 + 2] + w11 * n[o11 + 2];
+	}
+}
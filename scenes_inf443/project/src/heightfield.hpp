@@ -0,0 +1,36 @@
+#pragma once
+
+#include "cgp/04_grid_container/grid_container.hpp"
+#include "cgp/05_vec/vec.hpp"
+#include <functional>
+
+// Height function z = h(x,y) baked on a regular grid covering the square [-length/2, length/2]^2
+//  Each node stores the height and its derivatives: the bicubic lookup (Hermite patch) interpolates them exactly and is C1,
+//  the bilinear lookup is cheaper and only interpolates the values of the nodes.
+//  Queries outside of the square are clamped to its border.
+struct heightfield_structure {
+	float length = 0;
+	float dx = 0;                 // Distance between two nodes
+	cgp::grid_2D<cgp::vec4> node; // (h, dh/dx, dh/dy, d2h/dxdy) at each node, node(kx,ky) is at (-length/2 + kx*dx, -length/2 + ky*dx)
+
+	// Sample the function f(x,y) = (h, dh/dx, dh/dy, d2h/dxdy) on N x N nodes
+	void initialize(std::function<cgp::vec4(float, float)> const& f, float length, int N);
+
+	// Bilinear interpolation
+	float height(float x, float y) const;
+	cgp::vec2 gradient(float x, float y) const;
+	cgp::vec3 normal(float x, float y) const;
+
+	// Bicubic interpolation: height and exact gradient of the patch
+	float height_bicubic(float x, float y) const;
+	float height_bicubic(float x, float y, cgp::vec2& gradient) const;
+
+	// Bilinear queries on count points (x[k], y[k]), written as separate arrays
+	void height(float const* x, float const* y, float* h, int count) const;
+	void height_and_gradient(float const* x, float const* y, float* h, float* dhdx, float* dhdy, int count) const;
+
+	bool empty() const { return node.size() == 0; }
+
+	// Cell (kx,ky) containing (x,y) and local coordinates (u,v) in [0,1]
+	void locate(float x, float y, int& kx, int& ky, float& u, float& v) const;
+};
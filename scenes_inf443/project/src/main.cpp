@@ -152,6 +152,7 @@ void initialize_default_shaders()
 	// Set standard mesh shader for mesh_drawable
 	mesh_drawable::default_shader.load(default_path_shaders +"mesh/mesh.vert.glsl", default_path_shaders +"mesh/mesh.frag.glsl");
 	triangles_drawable::default_shader.load(default_path_shaders +"mesh/mesh.vert.glsl", default_path_shaders +"mesh/mesh.frag.glsl");
+	instanced_mesh_drawable::default_shader.load(default_path_shaders +"mesh_instanced/mesh_instanced.vert.glsl", default_path_shaders +"mesh/mesh.frag.glsl");
 
 	// Set default white texture
 	image_structure const white_image = image_structure{ 1,1,image_color_type::rgba,{255,255,255,255} };
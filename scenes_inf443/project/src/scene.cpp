@@ -3,7 +3,7 @@
 #include "fonctions.hpp"
 #include "interpolation.hpp"
 #include <cmath>
-#include <omp.h>
+#include <chrono>
 
 using namespace cgp;
 
@@ -13,96 +13,51 @@ int L_terrain = 30;
 int nb_seaw = 30;
 int nb_islet = 3;
 int nb_crater = 30;
+int random_seed = 0; //Same seed = same scene (positions of the decorations and the fishes)
 
 //Non - Configurable Parameters
 int N_terrain_samples = 100;
 float view_height = 1.5f;
 int nb_bubble = 3;
-float volume_factor = 1.2f;
+float simulation_dt = 0.01f; //Time step of the simulation (scaled by the timer scale)
+float simulation_frequency = 60.0f; //Steps per second of the simulation thread
 std::vector<int> crater_bubble_indices(nb_crater);
 std::vector<vec3> craters(nb_crater);
 std::vector<vec3> seaws(nb_seaw);
-std::vector<vec2> limits = { vec2(-L_terrain / 2, -L_terrain / 2), vec2(L_terrain / 2, -L_terrain / 2), vec2(L_terrain / 2, L_terrain / 2), vec2(-L_terrain / 2, L_terrain / 2) };
-
-void scene_structure::simulation_step(float dt) {
-	std::vector<vec3> new_p(nb_fish);
-	std::vector<vec3> new_v(nb_fish);
-
-#pragma omp parallel for //Parallel calculation
-	for (int i = 0; i < nb_fish; i++) {
-		vec3& pi = p[i];
-		vec3 vi = v[i];
-		vec3 F = vec3(0, 0, 0);
-
-		for (int j = 0; j < nb_fish; j++) {
-			if (i == j) continue;
-			vec3& pj = p[j];
-			vec3& vj = v[j];
-			float angle = angle_between(vi, pj - pi);
-			if (fabs(angle) < Pi / 1.5f) {  //Field of view
-				float distance = norm(pi - pj);
-				if (distance > 0) {
-					if (distance < 1.5f) {
-						F += (pi - pj) / pow(distance, 2); //Repulsion
-					}
-					else if (distance < 2) {
-						F += exp(-3 * distance) * (vj - vi); //Same vitess
-					}
-					else if (distance < 3) {
-						F += (pj - pi) * pow(distance, 1); // Attraction
-					}
-				}
-			}
-		}
-		//Start Comment here to switch camera
-		vec3& cam = camera_control.camera_model.position_camera; //Camera repulsion
-		float cam_dist = norm(pi - cam);
-		if (cam_dist < 6) {
-			F += (pi - cam) * plateau_decay(cam_dist, 7, 2.5f, 5);
-		}
-		//End Comment here to switch camera
-		int k = 0;
-		for (vec4 position : lmesh_center) { //Collision with scene's objects 
-			vec3 place = { position[0], position[1], position[2] };
-			place += trans_mesh[k];
-			F += (pi - place) * plateau_decay(norm(pi - place), 7, volume_factor * position[3] * L_terrain / 30, 10);
-			k++;
-		}
-
-		float ground_angle = angle_between(vi, vec3(0, 0, 1)); //Ground's Repulsion
-		float z = evaluate_dune_height(p[i][0], p[i][1]);
-		vec3 dir = { 0, 0, 1 };
-		F += dir * plateau_decay(fabs(z - p[i][2]), 12, 0.75f, 8);
-
-		std::pair<float, vec2> result = distance_to_closest_border_with_normal(vec2(pi.x, pi.y), limits); //Walls Repulsion
-		F += vec3(result.second.x, result.second.y, 0) * plateau_decay(result.first, 15, 1.5f * L_terrain / 30, 4);
-		float z_dist = fabs((pi.z - L_terrain /2));
-		F += vec3(0, 0, -1) * plateau_decay(z_dist, 20, 1 * L_terrain / 30, 8);
 
+//Directory of the binary caches of the meshes and textures, read instead of the OBJ/PNG/JPG files after the first launch
+static std::string asset_cache_directory() {
+	return project::path + "cache";
+}
 
-		vi = vi + dt * F;
+//Mesh of an OBJ asset, read from its binary cache
+static mesh mesh_load_file_obj_cached(std::string const& filename) {
+	mesh_cache_file file;
+	file.load(filename, asset_cache_directory());
+	return file.to_mesh();
+}
 
-		if (norm(vi) > 4 * L_terrain / 30) vi = 4 * L_terrain / 30 * normalize(vi); //Avoid divergence
+using texture_file = std::shared_ptr<texture_cache_file>; //Mip levels of a texture, mapped from its cache
+using mesh_file = std::shared_ptr<mesh_cache_file>; //Arrays of a mesh, mapped from its cache
 
-		new_v[i] = vi;
-		new_p[i] = pi + dt * vi;
+static double wall_clock_time() {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
-		float l = L_terrain / 2;
-		float acceptance=0.4f;
-		if (std::abs(new_p[i].x) > l+ acceptance || std::abs(new_p[i].y) > l+ acceptance || std::abs(new_p[i].z) > l+ acceptance) { //Deal with out of bound's fish
-			float x = rand_interval(-l, l);
-			float y = rand_interval(-l, l);
-			float z = evaluate_dune_height(x, y);
-			new_p[i] = { x, y, rand_interval(1, l - z - 1) + z };
-			new_v[i] = vec3(rand_interval(-1, 1), rand_interval(-1, 1), rand_interval(-1, 1));
-			std::cerr << "Error : fish out of bound !!" << std::endl;
-		}
+void scene_structure::simulation_tick() { //One step of the simulation, published for the display
+	simulation_inputs_structure inputs;
+	{
+		std::lock_guard<std::mutex> lock(simulation_inputs_mutex);
+		inputs = simulation_inputs;
 	}
 
-	for (int i = 0; i < nb_fish; i++) {
-		p[i] = new_p[i];
-		v[i] = new_v[i];
-	}
+	flock_snapshot_structure& snapshot = flock_snapshots.write_buffer();
+	snapshot.p_previous = simulation.flock.p;
+	simulation.step(simulation_dt * inputs.time_scale, inputs);
+	snapshot.p = simulation.flock.p;
+	snapshot.v = simulation.flock.v;
+	snapshot.time = wall_clock_time();
+	flock_snapshots.publish();
 }
 
 void scene_structure::gestion_timer() { //Bubbles timers/key frames/key positions
@@ -125,170 +80,239 @@ void scene_structure::gestion_timer() { //Bubbles timers/key frames/key position
 }
 
 void scene_structure::creation_mesh_terrain() {
-	mesh terrain_mesh = create_dune_mesh(N_terrain_samples, L_terrain);
+	mesh terrain_mesh = create_dune_mesh(dune_heightfield, N_terrain_samples, L_terrain);
+	occluder_terrain = create_dune_occluder(terrain_mesh, N_terrain_samples, 17);
 	terrain.initialize_data_on_gpu(terrain_mesh);
 	terrain.material.phong.specular = 0.0f;
-	terrain.texture.load_and_initialize_texture_2d_on_gpu(project::path + "assets/sand1.jpg", GL_CLAMP_TO_BORDER,
-		GL_CLAMP_TO_BORDER);
+	texture_sand = assets.load_texture(project::path + "assets/sand1.jpg", asset_cache_directory()); //Also used by the arch and the craters
+	assets.upload(texture_sand, [this](texture_file& file) {
+		terrain.texture.initialize_texture_2d_on_gpu(file->view, GL_CLAMP_TO_BORDER, GL_CLAMP_TO_BORDER);
+	});
 
 }
 
 void scene_structure::creation_skybox() {
-	image_structure image_skybox_template = image_load_file(project::path + "assets/skybox2_483.jpg");
-	std::vector<image_structure> image_grid = image_split_grid(image_skybox_template, 4, 3);
+	asset_handle<texture_file> skybox_faces = assets.load_cubemap(project::path + "assets/skybox2_483.jpg", 4, 3, { 1, 7, 5, 3, 10, 4 }, asset_cache_directory()); //Faces split once, stored in the cache
 	skybox.initialize_data_on_gpu();
-	skybox.texture.initialize_cubemap_on_gpu(image_grid[1], image_grid[7], image_grid[5], image_grid[3], image_grid[10], image_grid[4]);
 	opengl_shader_structure shader_environment_map;
 	shader_environment_map.load(project::path + "shaders/environment_map/environment_map.vert.glsl", project::path + "shaders/environment_map/environment_map.frag.glsl");
-	for (auto& shape_it : shapes) {
-		mesh_drawable& shape = shape_it.second;
-		shape.shader = shader_environment_map;
-		shape.supplementary_texture["image_skybox"] = skybox.texture;
-	}
+	for (auto& shape_it : shapes)
+		shape_it.second.shader = shader_environment_map;
 	skybox.model.rotation = rotation_transform::from_axis_angle(vec3(1, 0, 0), Pi / 2);
+	assets.upload(skybox_faces, [this](texture_file& file) {
+		skybox.texture.initialize_cubemap_on_gpu(file->view);
+		for (auto& shape_it : shapes)
+			shape_it.second.supplementary_texture["image_skybox"] = skybox.texture;
+	});
 }
 
 void scene_structure::creation_wall() {
 	float l = L_terrain / 2;
 	mesh wall_mesh = mesh_primitive_quadrangle({ l,-l,0 }, { l,l,0 }, { l,l,l }, { l,-l,l });
 	wall.initialize_data_on_gpu(wall_mesh);
-	wall.texture.load_and_initialize_texture_2d_on_gpu(project::path + "assets/window_blue.png", GL_REPEAT, GL_REPEAT);
+	assets.upload(assets.load_texture(project::path + "assets/window_blue.png", asset_cache_directory()), [this](texture_file& file) {
+		wall.texture.initialize_texture_2d_on_gpu(file->view, GL_REPEAT, GL_REPEAT);
+	});
 	wall.material.phong.specular = 0;
 
 	mesh ceiling_mesh = mesh_primitive_quadrangle({ -l,-l,0 }, { l,-l,0 }, { l,l,0 }, { -l,l,0 });
 	ceiling.initialize_data_on_gpu(ceiling_mesh);
-	ceiling.texture.load_and_initialize_texture_2d_on_gpu(project::path + "assets/noir+star.png", GL_REPEAT, GL_REPEAT);
+	assets.upload(assets.load_texture(project::path + "assets/noir+star.png", asset_cache_directory()), [this](texture_file& file) {
+		ceiling.texture.initialize_texture_2d_on_gpu(file->view, GL_REPEAT, GL_REPEAT);
+	});
 	ceiling.material.phong.specular = 0;
 	ceiling.model.rotation= rotation_transform::from_axis_angle(vec3(1, 0, 0), Pi );
 	ceiling.model.translation = vec3(0, 0, l);
 }
 void scene_structure::creation_mesh_fish() {
-	mesh fish_mesh = mesh_load_file_obj(project::path + "assets/Poisson3/shark2.obj");
-	fish_mesh.centered();
-	fish.initialize_data_on_gpu(fish_mesh);
-	fish.texture.load_and_initialize_texture_2d_on_gpu(project::path + "assets/Poisson3/Sport_Shark_Diffuse.png",GL_REPEAT,GL_REPEAT);
-	fish.model.scaling = 0.3f * L_terrain / 30;
-	
-	opengl_shader_structure shader_custom;
-	shader_custom.load(
-		project::path + "shaders/mesh_custom/mesh_custom.vert.glsl",
+	asset_handle<std::vector<mesh>> fish_chain = assets.load([]() { //Levels of detail simplified on the pool
+		mesh fish_mesh = mesh_load_file_obj_cached(project::path + "assets/Poisson3/shark2.obj");
+		fish_mesh.centered();
+		return mesh_lod_chain(fish_mesh);
+	});
+	asset_handle<texture_file> fish_texture = assets.load_texture(project::path + "assets/Poisson3/Sport_Shark_Diffuse.png", asset_cache_directory());
+	opengl_shader_structure shader_fish;
+	shader_fish.load(
+		project::path + "shaders/fish_instancing/fish_instancing.vert.glsl",
 		project::path + "shaders/mesh_custom/mesh_custom.frag.glsl");
-	fish.shader = shader_custom;
-
-	p.resize(nb_fish);
-	v.resize(nb_fish);
-	float l = L_terrain / 2;
-	for (int i = 0; i < nb_fish; i++) {
-		float x = rand_interval(-l, l);
-		float y = rand_interval(-l, l);
-		float z = evaluate_dune_height(x, y);
-		vec3 p0 = { x, y, rand_interval(1, l-z-1) + z };
-		vec3 v0 = vec3(rand_interval(-1, 1), rand_interval(-1, 1), rand_interval(-1, 1));
-
-		p[i] = p0;
-		v[i] = v0;
-	}
+	stream.initialize_data_on_gpu(flock_drawable_structure::stream_size(nb_fish)); //Position/phase and orientation of each fish (twice for the fishes of the cross-fade band)
+	opengl_shader_structure shader_impostor_bake;
+	shader_impostor_bake.load(
+		project::path + "shaders/impostor_bake/impostor_bake.vert.glsl",
+		project::path + "shaders/impostor_bake/impostor_bake.frag.glsl");
+	opengl_shader_structure shader_fish_impostor;
+	shader_fish_impostor.load(
+		project::path + "shaders/fish_impostor/fish_impostor.vert.glsl",
+		project::path + "shaders/fish_impostor/fish_impostor.frag.glsl");
+	assets.upload(fish_chain, [=](std::vector<mesh>& chain) {
+		fish.initialize_data_on_gpu(chain, shader_fish, nb_fish);
+		fish.shark.drawable.model.scaling = 0.3f * L_terrain / 30;
+		assets.upload(fish_texture, [=](texture_file& file) { //The impostors are baked once the shark is textured
+			fish.shark.drawable.texture.initialize_texture_2d_on_gpu(file->view, GL_REPEAT, GL_REPEAT);
+			fish.initialize_impostor(shader_impostor_bake, shader_fish_impostor);
+		});
+	});
+	fish.impostor_fade = 0.1f * L_terrain;
+	gui.impostor_distance = 0.5f * L_terrain;
+
+	simulation.initialize(nb_fish, L_terrain, random_seed);
+	flock_snapshot_structure& snapshot = flock_snapshots.write_buffer();
+	snapshot.p_previous = simulation.flock.p;
+	snapshot.p = simulation.flock.p;
+	snapshot.v = simulation.flock.v;
+	snapshot.time = wall_clock_time();
+	flock_snapshots.publish();
 }
 void scene_structure::creation_mesh_decoration() {
-	mesh volume_mesh = mesh_primitive_sphere(); //Mesh to show bounding volume
-	volume.initialize_data_on_gpu(volume_mesh);
-	volume.material.alpha = 0.1f;
-	volume.material.phong.specular = 0;
-	volume.material.color = { 1,0,0 };
-
-	mesh skull_mesh = mesh_load_file_obj(project::path + "assets/skull/skull.obj"); //Skull decoration
-	skull.initialize_data_on_gpu(skull_mesh);
-	skull.texture.load_and_initialize_texture_2d_on_gpu(project::path + "assets/skull/skull.jpg");
-	vec3 skull_trans = vec3(0, L_terrain / 3, evaluate_dune_height(0, L_terrain / 3));
-	trans_mesh.push_back(skull_trans); 
-	skull.model.translation = skull_trans;
-	float skull_scaling = 0.3f * L_terrain / 30;
-	skull.model.scaling = skull_scaling;
-	vec4 cent = mesh_center(skull_mesh, skull_scaling);
-	lmesh_center.push_back(cent); 
-
-	mesh arch_mesh = mesh_load_file_obj(project::path + "assets/arch.obj"); //Arch decoration
-	arch_mesh.rotate({ 1, 0,0 }, Pi / 2);
-	arch.initialize_data_on_gpu(arch_mesh);
-	arch.texture.load_and_initialize_texture_2d_on_gpu(project::path + "assets/sand1.jpg");
-	vec3 arch_trans = vec3(-L_terrain / 4, -L_terrain / 5, evaluate_dune_height(-L_terrain / 4, -L_terrain / 5) + 1 * L_terrain / 30);
-	trans_mesh.push_back(arch_trans);
-	arch.model.translation = arch_trans;
-	
-	float arch_scaling = 0.1f*L_terrain/40;
-	arch.model.scaling = arch_scaling;
-	vec4 arch_cent = mesh_center(arch_mesh, arch_scaling);
-	lmesh_center.push_back(arch_cent);
-
-	mesh chest_mesh = mesh_load_file_obj(project::path + "assets/chest/13019_aquarium_treasure_chest_v1_L2.obj"); //Chest decoration
-	chest.initialize_data_on_gpu(chest_mesh);
-	vec3 chest_trans = { L_terrain / 3, L_terrain / 5,evaluate_dune_height(L_terrain / 3,L_terrain / 5) };
-	chest.model.translation = chest_trans;
-	trans_mesh.push_back(chest_trans);
-	chest.texture.load_and_initialize_texture_2d_on_gpu(project::path + "assets/chest/aquarium_treasure_chest_diffuse.jpg", GL_REPEAT, GL_REPEAT);
-	float chest_scaling = 0.1f * L_terrain / 30;
-	chest.model.scaling = chest_scaling;
-	lmesh_center.push_back(mesh_center(chest_mesh, chest_scaling));
-
-	mesh seaw_mesh = mesh_load_file_obj(project::path + "assets/seaweed_m.obj"); //Sea weed
-	seaw.initialize_data_on_gpu(seaw_mesh);
-	vec3 seaw_trans = { 0,0,evaluate_dune_height(0,0)-0.1f };
-	seaw.model.translation = seaw_trans;
-	seaw.texture.load_and_initialize_texture_2d_on_gpu(project::path + "assets/green1.jpg", GL_REPEAT, GL_REPEAT);
+	std::string const cache_directory = asset_cache_directory();
+	obstacles_pending = 4; //Skull, arch, chest and castle
+
+	asset_handle<mesh_file> skull_file = assets.load_mesh_cache(project::path + "assets/skull/skull.obj", cache_directory); //Skull decoration: sent to the GPU from the mapped cache
+	assets.upload(skull_file, [this](mesh_file& file) {
+		skull.initialize_data_on_gpu(file->view);
+		vec3 skull_trans = vec3(0, L_terrain / 3, evaluate_dune_height(0, L_terrain / 3));
+		skull.model.translation = skull_trans;
+		float skull_scaling = 0.3f * L_terrain / 30;
+		skull.model.scaling = skull_scaling;
+		add_obstacle(file->to_mesh(), skull.model); //Copy for the distance field of the simulation
+	});
+	assets.upload(assets.load_texture(project::path + "assets/skull/skull.jpg", cache_directory), [this](texture_file& file) {
+		skull.texture.initialize_texture_2d_on_gpu(file->view);
+	});
+
+	asset_handle<mesh> arch_mesh = assets.load_mesh(project::path + "assets/arch.obj", cache_directory, [](mesh& m) { m.rotate({ 1, 0,0 }, Pi / 2); }); //Arch decoration
+	assets.upload(arch_mesh, [this](mesh& m) {
+		arch.initialize_data_on_gpu(m);
+		vec3 arch_trans = vec3(-L_terrain / 4, -L_terrain / 5, evaluate_dune_height(-L_terrain / 4, -L_terrain / 5) + 1 * L_terrain / 30);
+		arch.model.translation = arch_trans;
+		float arch_scaling = 0.1f*L_terrain/40;
+		arch.model.scaling = arch_scaling;
+		add_obstacle(m, arch.model);
+		occluder_arch = m;
+	});
+	assets.upload(texture_sand, [this](texture_file& file) {
+		arch.texture.initialize_texture_2d_on_gpu(file->view);
+	});
+
+	asset_handle<mesh> chest_mesh = assets.load_mesh(project::path + "assets/chest/13019_aquarium_treasure_chest_v1_L2.obj", cache_directory); //Chest decoration
+	assets.upload(chest_mesh, [this](mesh& m) {
+		chest.initialize_data_on_gpu(m);
+		vec3 chest_trans = { L_terrain / 3, L_terrain / 5,evaluate_dune_height(L_terrain / 3,L_terrain / 5) };
+		chest.model.translation = chest_trans;
+		float chest_scaling = 0.1f * L_terrain / 30;
+		chest.model.scaling = chest_scaling;
+		add_obstacle(m, chest.model);
+	});
+	assets.upload(assets.load_texture(project::path + "assets/chest/aquarium_treasure_chest_diffuse.jpg", cache_directory), [this](texture_file& file) {
+		chest.texture.initialize_texture_2d_on_gpu(file->view, GL_REPEAT, GL_REPEAT);
+	});
+
+	asset_handle<mesh_file> seaw_file = assets.load_mesh_cache(project::path + "assets/seaweed_m.obj", cache_directory); //Sea weed: sent to the GPU from the mapped cache
+	opengl_shader_structure shader_custom_seaw;
+	shader_custom_seaw.load(
+		project::path + "shaders/seaweed_instancing/seaweed_instancing.vert.glsl",
+		project::path + "shaders/mesh_custom/mesh_custom.frag.glsl");
 	float seaw_scaling = 10 * L_terrain / 30;
-	seaw.model.scaling = seaw_scaling;
-	seaw.model.scaling_xyz = vec3(1, 1, 4);
-	seaw.model.rotation = rotation_transform::from_axis_angle({ 1, 0,0 }, Pi / 2);
+	rotation_transform seaw_rotation = rotation_transform::from_axis_angle({ 1, 0,0 }, Pi / 2);
 	std::vector<vec3> islets = generate_positions_on_terrain(nb_islet, L_terrain, 0,5);
 	seaws = generate_positions_around_points(nb_seaw, L_terrain, 0.5f,islets,3); //Generate sea weed's cluster
 	random_floats.reserve(nb_seaw);
 	for (int i = 0; i < nb_seaw; ++i) {
 		random_floats.push_back(rand_interval(1.0f, 7.0f));
 	}
-	opengl_shader_structure shader_custom_seaw;
-	shader_custom_seaw.load(
-		project::path + "shaders/mesh_custom/mesh_custom.vert - Copie.glsl",
-		project::path + "shaders/mesh_custom/mesh_custom.frag - Copie.glsl");
-	seaw.shader = shader_custom_seaw;
-
-	mesh castle_mesh = mesh_load_file_obj(project::path + "assets/Chateau.obj");
-	castle_mesh.rotate({ 1,0,0 }, Pi / 2);
-	castle_mesh.rotate({ 0,0,1 }, Pi );
-	castle.initialize_data_on_gpu(castle_mesh);
-	castle.texture.load_and_initialize_texture_2d_on_gpu(project::path + "assets/castle_text.png", GL_REPEAT, GL_REPEAT);
-	vec3 castle_trans = vec3(L_terrain / 4, -L_terrain / 5, evaluate_dune_height(L_terrain / 4, -L_terrain / 4)-6.5f * L_terrain / 35);
-	castle.model.translation = castle_trans;
-	trans_mesh.push_back(castle_trans);
-	float castle_scaling = 2.1* L_terrain / 30;
-	castle.model.scaling = castle_scaling;
-	lmesh_center.push_back(mesh_center(castle_mesh, castle_scaling));
+	std::vector<affine> seaw_instances; //Sea weed with random heights, sent once to the GPU
+	for (int i = 0; i < nb_seaw; ++i) {
+		seaw_instances.push_back(affine(seaw_rotation, seaws[i], seaw_scaling, vec3(1, 1, random_floats[i])));
+	}
+	assets.upload(seaw_file, [this, shader_custom_seaw, seaw_instances](mesh_file& file) {
+		seaw.initialize_data_on_gpu(file->view, shader_custom_seaw);
+		seaw.update_instances(seaw_instances);
+	});
+	assets.upload(assets.load_texture(project::path + "assets/green1.jpg", cache_directory), [this](texture_file& file) {
+		seaw.drawable.texture.initialize_texture_2d_on_gpu(file->view, GL_REPEAT, GL_REPEAT);
+	});
+
+	asset_handle<std::vector<mesh>> castle_chain = assets.load([]() { //Levels of detail simplified on the pool
+		mesh castle_mesh = mesh_load_file_obj_cached(project::path + "assets/Chateau.obj");
+		castle_mesh.rotate({ 1,0,0 }, Pi / 2);
+		castle_mesh.rotate({ 0,0,1 }, Pi );
+		return mesh_lod_chain(castle_mesh);
+	});
+	assets.upload(castle_chain, [this](std::vector<mesh>& chain) {
+		castle.initialize_data_on_gpu(chain);
+		vec3 castle_trans = vec3(L_terrain / 4, -L_terrain / 5, evaluate_dune_height(L_terrain / 4, -L_terrain / 4)-6.5f * L_terrain / 35);
+		castle.drawable.model.translation = castle_trans;
+		float castle_scaling = 2.1* L_terrain / 30;
+		castle.drawable.model.scaling = castle_scaling;
+		add_obstacle(chain[0], castle.drawable.model);
+		occluder_castle = chain[0];
+	});
+	assets.upload(assets.load_texture(project::path + "assets/castle_text.png", cache_directory), [this](texture_file& file) {
+		castle.drawable.texture.initialize_texture_2d_on_gpu(file->view, GL_REPEAT, GL_REPEAT);
+	});
 
 }
 void scene_structure::creation_mesh_bubble_crater() {
-	mesh crater_mesh = mesh_load_file_obj(project::path + "assets/Volcano_OBJ.obj");
-	crater.initialize_data_on_gpu(crater_mesh);
-	crater.model.scaling = 0.008f * L_terrain / 30;
-	crater.model.rotation = rotation_transform::from_axis_angle({ 1, 0,0 }, Pi / 2);
-	crater.texture.load_and_initialize_texture_2d_on_gpu(project::path + "assets/sand1.jpg");
-	crater.material.phong.specular = 0.0f;
+	asset_handle<std::vector<mesh>> crater_chain = assets.load([]() { //Levels of detail simplified on the pool
+		return mesh_lod_chain(mesh_load_file_obj_cached(project::path + "assets/Volcano_OBJ.obj"));
+	});
 	craters = generate_positions_on_terrain(nb_crater, L_terrain, 0.6f * L_terrain / 30,1); //Generate uniformly random positions
+	std::vector<affine> crater_instances;
+	for (vec3 const& p : craters) {
+		crater_instances.push_back(affine().set_translation(p));
+	}
+	assets.upload(crater_chain, [this, crater_instances](std::vector<mesh>& chain) {
+		crater.initialize_data_on_gpu(chain[0]);
+		crater.drawable.model.scaling = 0.008f * L_terrain / 30;
+		crater.drawable.model.rotation = rotation_transform::from_axis_angle({ 1, 0,0 }, Pi / 2);
+		crater.drawable.material.phong.specular = 0.0f;
+		crater.initialize_lod(chain);
+		crater.update_instances(crater_instances);
+	});
+	assets.upload(texture_sand, [this](texture_file& file) {
+		crater.drawable.texture.initialize_texture_2d_on_gpu(file->view);
+	});
 	for (int i = 0; i < nb_crater; ++i) { //Choice of which bubble is assigned to each crater
-		crater_bubble_indices[i] = std::rand() % nb_bubble;
+		crater_bubble_indices[i] = random_stream_thread().uniform_int(0, nb_bubble - 1);
 	}
 
 	mesh bubble_mesh = mesh_primitive_quadrangle({ -0.5f,0,0 }, { 0.5f,0,0 }, { 0.5f,0,1 }, { -0.5f,0,1 });
 	bubble.initialize_data_on_gpu(bubble_mesh);
-	bubble.texture.load_and_initialize_texture_2d_on_gpu(project::path + "assets/bubble.png"); //Semi-transparent 
-	bubble.material.phong = { 0.4f, 0.6f,0,1 };
-	bubble.model.scaling = 0.5f * L_terrain / 30;
+	assets.upload(assets.load_texture(project::path + "assets/bubble.png", asset_cache_directory()), [this](texture_file& file) { //Semi-transparent 
+		bubble.drawable.texture.initialize_texture_2d_on_gpu(file->view);
+	});
+	bubble.drawable.material.phong = { 0.4f, 0.6f,0,1 };
+	bubble.drawable.model.scaling = 0.5f * L_terrain / 30;
+}
+void scene_structure::add_obstacle(mesh const& shape, affine const& transform) {
+	simulation.add_obstacle(shape, transform);
+	if (--obstacles_pending > 0)
+		return;
+
+	asset_handle<mesh> volume_mesh = assets.load([this]() { //The simulation is not running yet: the distance field is computed on the pool
+		simulation.update_obstacles(); //Distance field of the decorations, walls and terrain
+		return marching_cube(simulation.obstacles.distance(), simulation.obstacles.domain, simulation.obstacle_distance * L_terrain / 30.0f); //Mesh to show the repulsion volume
+	});
+	assets.upload(volume_mesh, [this](mesh& m) {
+		volume.initialize_data_on_gpu(m);
+		volume.material.alpha = 0.1f;
+		volume.material.phong.specular = 0;
+		volume.material.color = { 1,0,0 };
+
+		simulation_ready = true;
+		if (gui.simulation_thread)
+			simulation_thread.start([this]() { simulation_tick(); });
+	});
 }
 void scene_structure::initialize() {
 	std::cout << "Start function scene_structure::initialize()" << std::endl;
+	random_stream_set_seed(random_seed);
+	dune_heightfield = create_dune_heightfield(1.2f * L_terrain); //Margin for the camera going out of bounds
 	camera_control.initialize(inputs, window); 
 	camera_control.set_rotation_axis_z();
 	camera_projection.field_of_view = Pi / 2;
 	//Start Comment here to switch camera
-	camera_control.camera_model.position_camera.z = view_height + evaluate_dune_height(0, 0);
+	camera_control.camera_model.position_camera.z = view_height + dune_heightfield.height(0, 0);
 	//End Comment here to switch camera
 	display_info();
 	
@@ -296,6 +320,7 @@ void scene_structure::initialize() {
 
 	gestion_timer();
 
+	//The files are read and processed on the threads of the pool: each element is sent to the GPU by display_frame once loaded
 	creation_mesh_terrain();
 
 	creation_skybox();
@@ -307,6 +332,10 @@ void scene_structure::initialize() {
 	creation_mesh_decoration();
 
 	creation_mesh_bubble_crater();
+
+	occlusion.initialize(256, 144);
+
+	simulation_thread.frequency = simulation_frequency; //Started once the obstacles are loaded (add_obstacle)
 }
 
 void scene_structure::display_info()
@@ -329,33 +358,40 @@ void scene_structure::display_info()
 
 void scene_structure::display_frame()
 {
+	assets.update(); //Assets loaded since the last frame sent to the GPU
+
 	// Set the light to the current position of the camera
 	environment.light = camera_control.camera_model.position();
 	 
 	//Start Comment here to switch camera
 	//If camera out of bounds
-	camera_control.camera_model.position_camera.z = view_height + evaluate_dune_height(camera_control.camera_model.position().x, camera_control.camera_model.position().y);
+	camera_control.camera_model.position_camera.z = view_height + dune_heightfield.height(camera_control.camera_model.position().x, camera_control.camera_model.position().y);
 	float l = L_terrain / 2;
 	float acceptance = 0.5f;
 	if (std::abs(camera_control.camera_model.position_camera.x) > l + acceptance || std::abs(camera_control.camera_model.position_camera.y) > l + acceptance) { //Deal with out of bound's camera
 		float x = rand_interval(-l, l);
 		float y = rand_interval(-l, l);
-		float z = evaluate_dune_height(x, y);
+		float z = dune_heightfield.height(x, y);
 		camera_control.camera_model.position_camera = { x, y, view_height + z };
 		vec3 v0 = vec3(rand_interval(-1, 1), rand_interval(-1, 1), rand_interval(-1, 1));
-		camera_control.camera_model.position_camera = { rand_interval(-l, l), rand_interval(-l,l), rand_interval(0, l) + evaluate_dune_height(rand_interval(-l, l), rand_interval(-l, l)) };
+		camera_control.camera_model.position_camera = { rand_interval(-l, l), rand_interval(-l,l), rand_interval(0, l) + dune_heightfield.height(rand_interval(-l, l), rand_interval(-l, l)) };
 		std::cerr << "Oups !! You got teleported !!" << std::endl;
 	}
 	//End Comment here to switch camera
-	
-	display_skybox();
-	
 
 	// Update time
 	timer.update();
 	timer_i.update();
 	timer_i_1.update();
 	timer_i_2.update();
+
+	// Camera, light, fog and time sent once for all the shaders of the frame
+	environment.time = timer.t;
+	environment.send_opengl_uniform_buffer();
+	stream.begin_frame();
+
+	display_skybox();
+
 	float t = timer_i.t;
 	if (t < timer_i.t_min + 0.1f)
 		keyframe.trajectory.clear();
@@ -364,12 +400,16 @@ void scene_structure::display_frame()
 	if (t < timer_i_2.t_min + 0.1f)
 		keyframe_2.trajectory.clear();
 
-	draw(global_frame, environment);
+	opaque_queue.camera_position = camera_control.camera_model.position();
+	opaque_queue.frustum_culling = gui.frustum_culling;
+	opaque_queue.view_frustum = frustum::from_matrix(environment.camera_projection, environment.camera_view);
+	opaque_queue.push(global_frame, environment);
+	lod_view const lod = lod_view::from_matrix(environment.camera_projection, environment.camera_view);
+	lod_view const* lod_selection = gui.level_of_detail ? &lod : nullptr;
 
 	if (gui.display_wireframe) {
 		draw_wireframe(chest, environment);
 		draw_wireframe(terrain, environment);
-		draw_wireframe(volume, environment);
 		draw_wireframe(skull, environment);
 		draw_wireframe(fish, environment);
 		draw_wireframe(crater, environment);
@@ -379,44 +419,57 @@ void scene_structure::display_frame()
 	}
 	
 	if (gui.display_volume) {
-		int i = 0;
-		for (vec4 position : lmesh_center) {
-			vec3 place = { position[0],position[1], position[2] };
-			volume.model.scaling = volume_factor*position[3];
-			volume.model.translation = place+ trans_mesh[i];
-			i++;
-			draw(volume, environment);
-		}
+		draw(volume, environment);
 	}
 
-	for (int i = 0; i < nb_crater; i++) { //Craters
-		crater.model.translation = craters[i];
-		draw(crater, environment);
+	bool const occlusion_culling = gui.frustum_culling && gui.occlusion_culling;
+	if (occlusion_culling)
+		rasterize_occluders();
+	occlusion_buffer const* occlusion_test = occlusion_culling ? &occlusion : nullptr;
+	if (gui.frustum_culling) { //Only the visible instances are sent to the GPU (again only when they change)
+		crater.cull(opaque_queue.view_frustum, 0.0f, occlusion_test, lod_selection);
+		seaw.cull(opaque_queue.view_frustum, 0.5f * L_terrain / 30, occlusion_test); //Margin for the waving of the sea weed in the shader
+	}
+	else {
+		crater.uncull();
+		seaw.uncull();
 	}
+	opaque_queue.push(crater, environment); //Craters
 	
-	draw(terrain);
-	draw(skull);
-	draw(chest);
-	draw(arch);
-	draw(ceiling);
-	draw(castle);
+	opaque_queue.push(terrain, environment);
+	opaque_queue.push(skull, environment);
+	opaque_queue.push(chest, environment);
+	opaque_queue.push(arch, environment);
+	opaque_queue.push(ceiling, environment);
+	opaque_queue.push(castle.level_drawable(gui.level_of_detail ? castle.select_level(lod) : 0), environment);
 	
 
-	for (int i = 0; i < nb_seaw; i++) { //Sea weed with random heights
-		seaw.model.scaling_xyz = vec3(1, 1, random_floats[i]);
-		seaw.model.translation = seaws[i];
-		draw(seaw, environment);
-	}
-
-	simulation_step(timer.scale * 0.01f);
+	opaque_queue.push(seaw, environment); //Sea weed with random heights
 
-	for (int i = 0; i < nb_fish; i++) { //Fish translation and rotation toward speed vector
-		fish.model.translation = p[i];
-		fish.model.rotation = rotation_transform::from_vector_transform(vec3(1, 0, 0), normalize(v[i]))* rotation_transform::from_axis_angle({ 0, 0, 1 }, Pi/2);
-		draw(fish, environment);
+	{
+		std::lock_guard<std::mutex> lock(simulation_inputs_mutex);
+		//Start Comment here to switch camera
+		simulation_inputs.camera_position = camera_control.camera_model.position_camera;
+		//End Comment here to switch camera
+		simulation_inputs.time_scale = timer.scale;
+		simulation_inputs.neighbor_grid = gui.neighbor_grid;
+	}
+	if (simulation_ready && !simulation_thread.is_running())
+		simulation_tick();
+
+	flock_snapshot_structure const& snapshot = flock_snapshots.read();
+	float alpha = 1.0f; //Interpolation between the last two steps (the display is one step behind the simulation)
+	if (gui.interpolation && simulation_thread.is_running())
+		alpha = std::min(std::max(float(wall_clock_time() - snapshot.time) * simulation_frequency, 0.0f), 1.0f);
+
+	fish.impostor_distance = gui.impostors ? gui.impostor_distance : 0.0f;
+	if (fish.shark.drawable.vao != 0) { //Once the shark is loaded
+		fish.update(snapshot, alpha, stream, gui.frustum_culling ? &opaque_queue.view_frustum : nullptr, occlusion_test, lod_selection); //Fish translation and rotation toward speed vector, computed for the whole flock
+		push(opaque_queue, fish, environment);
 	}
 
-	environment.uniform_generic.uniform_float["time"] = timer.t;
+	opaque_queue.submit();
+	stream.end_frame(); //After the draw calls reading the stream
 	p_interpolations[0] = interpolation(t, keyframe.key_positions, keyframe.key_times);
 	p_interpolations[1] = interpolation(t, keyframe_1.key_positions, keyframe_1.key_times);
 	p_interpolations[2] = interpolation(t, keyframe_2.key_positions, keyframe_2.key_times);
@@ -427,11 +480,20 @@ void scene_structure::display_skybox() {
 	glEnable(GL_BLEND);
 	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 	glDepthMask(false);
-	draw(skybox, environment);
+	if (skybox.texture.id != 0) //Once the skybox is loaded
+		draw(skybox, environment);
 	glDepthMask(true);
 	glDisable(GL_BLEND);
 }
 
+void scene_structure::rasterize_occluders() {
+	occlusion.clear(environment.camera_projection * environment.camera_view);
+	occlusion.add_occluder(occluder_terrain);
+	occlusion.add_occluder(occluder_castle, castle.drawable.model_matrix());
+	occlusion.add_occluder(occluder_arch, arch.model_matrix());
+	occlusion.rasterize();
+}
+
 void scene_structure::display_bubble_wall(vec3 p_interpolations[3])
 {
 	glEnable(GL_BLEND);
@@ -444,7 +506,7 @@ void scene_structure::display_bubble_wall(vec3 p_interpolations[3])
 	vec3 const right = camera.right();
 	// Rotation such that the grass follows the right-vector of the camera, while pointing toward the z-direction
 	rotation_transform R = rotation_transform::from_frame_transform({ 1,0,0 }, { 0,0,1 }, right, { 0,0,1 });
-	bubble.model.rotation = R;
+	bubble.drawable.model.rotation = R;
 	for (int i = 0; i < 4; i++) { //Walls
 		wall.model.rotation = rotation_transform::from_axis_angle({ 0, 0, 1 }, Pi*i/2);
 		draw(wall, environment);
@@ -452,19 +514,21 @@ void scene_structure::display_bubble_wall(vec3 p_interpolations[3])
 	
 
 	vec3 trans = { 0,0,-0.5f }; //Bubbles
+	std::vector<affine> bubble_instances(nb_crater);
 	for (int i = 0; i < nb_crater; i++) {
 		vec3 crat = craters[i];
 		int bub = crater_bubble_indices[i];
 		if (i % 2 == 0) {
-			bubble.model.translation = p_interpolations[bub] + crat + trans;
+			bubble_instances[i].translation = p_interpolations[bub] + crat + trans;
 		}
 		else {
 			vec3 p_inter = p_interpolations[bub];
 			vec3 p_inter_inv = {-p_inter.x,-p_inter.y,p_inter.z};
-			bubble.model.translation = p_inter_inv + crat + trans;
+			bubble_instances[i].translation = p_inter_inv + crat + trans;
 		}
-		draw(bubble, environment);
 	}
+	bubble.update_instances(bubble_instances);
+	draw(bubble, environment);
 	
 	glDepthMask(true);
 	glDisable(GL_BLEND);
@@ -475,6 +539,36 @@ void scene_structure::display_gui()
 	ImGui::Checkbox("Frame", &gui.display_frame);
 	ImGui::Checkbox("Wireframe", &gui.display_wireframe);
 	ImGui::Checkbox("Volume", &gui.display_volume);
+	ImGui::Checkbox("Neighbor grid", &gui.neighbor_grid);
+#ifndef __EMSCRIPTEN__
+	if (ImGui::Checkbox("Simulation thread", &gui.simulation_thread)) {
+		if (gui.simulation_thread && simulation_ready)
+			simulation_thread.start([this]() { simulation_tick(); });
+		else
+			simulation_thread.stop();
+	}
+	ImGui::Checkbox("Interpolation", &gui.interpolation);
+#endif
+	ImGui::Checkbox("Frustum culling", &gui.frustum_culling);
+	ImGui::Checkbox("Occlusion culling", &gui.occlusion_culling);
+	ImGui::Checkbox("Occlusion buffer", &gui.display_occlusion_buffer);
+	ImGui::Checkbox("Level of detail", &gui.level_of_detail);
+	ImGui::Checkbox("Impostors", &gui.impostors);
+	ImGui::SliderFloat("Impostor distance", &gui.impostor_distance, 0.1f * L_terrain, 2.0f * L_terrain);
+	ImGui::Text("Draw calls: %d, state changes saved: %d", opaque_queue.statistics.draw_calls, opaque_queue.statistics.state_changes_saved());
+	int const instances_drawn = crater.instance_count + seaw.instance_count + fish.visible_count; //Fishes of the cross-fade band counted once
+	int const instances_total = crater.instance_count_total() + seaw.instance_count_total() + fish.instance_count_total;
+	ImGui::Text("Culled: %d objects, %d/%d instances", opaque_queue.statistics.culled, instances_total - instances_drawn, instances_total);
+	ImGui::Text("Triangles: sharks %d (%d impostors), craters %d", fish.triangle_count(), fish.impostor_instance_count, crater.triangle_count());
+	if (gui.display_occlusion_buffer && gui.frustum_culling && gui.occlusion_culling) {
+		grid_2D<vec3> const depth = occlusion.depth_image();
+		if (occlusion_texture.id == 0)
+			occlusion_texture.initialize_texture_2d_on_gpu(depth, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE, false, GL_NEAREST, GL_NEAREST);
+		else
+			occlusion_texture.update(depth);
+		ImGui::Text("Occluder triangles: %d", occlusion.triangle_count());
+		ImGui::Image((void*)(intptr_t)occlusion_texture.id, ImVec2(float(occlusion.width), float(occlusion.height)), ImVec2(0, 1), ImVec2(1, 0)); //Row 0 at the bottom
+	}
 
 }
 
@@ -3,6 +3,11 @@
 #include "cgp/cgp.hpp"
 #include "environment.hpp"
 #include "key_positions_structure.hpp"
+#include "flock_simulation.hpp"
+#include "flock_drawable.hpp"
+#include "simulation_thread.hpp"
+
+#include <mutex>
 
 using cgp::mesh;
 using cgp::mesh_drawable;
@@ -13,6 +18,19 @@ struct gui_parameters {
     bool display_frame = true;
     bool display_wireframe = false;
     bool display_volume = false;
+    bool neighbor_grid = true; // Use the spatial grid for the fish neighbor search (brute force otherwise)
+#ifndef __EMSCRIPTEN__
+    bool simulation_thread = true; // Run the simulation on its own thread at a fixed rate (one step per frame otherwise)
+#else
+    bool simulation_thread = false;
+#endif
+    bool interpolation = true; // Interpolate the displayed fishes between the last two simulation steps
+    bool frustum_culling = true; // Skip the objects and instances outside of the camera frustum
+    bool occlusion_culling = true; // Skip the fishes and instances hidden behind the castle, the arch and the terrain (with frustum_culling)
+    bool display_occlusion_buffer = false;
+    bool level_of_detail = true; // Draw the distant sharks, craters and castle with their simplified meshes
+    bool impostors = true; // Draw the sharks beyond impostor_distance as textured quads (with level_of_detail)
+    float impostor_distance = 15.0f;
 };
 
 struct scene_structure : cgp::scene_inputs_generic {
@@ -48,23 +66,34 @@ struct scene_structure : cgp::scene_inputs_generic {
 
     mesh_drawable terrain;
     mesh_drawable chest;
-    mesh_drawable fish;
-    mesh_drawable crater;
-    mesh_drawable bubble;
+    flock_drawable_structure fish; //Sharks drawn with one instanced draw call
+    cgp::instanced_mesh_drawable crater; //Static instances
+    cgp::instanced_mesh_drawable bubble; //Instances updated at each frame (animated, facing the camera)
     mesh_drawable skull;
     mesh_drawable volume;
     mesh_drawable arch;
-    mesh_drawable seaw;
+    cgp::instanced_mesh_drawable seaw; //Static instances with random heights
     mesh_drawable wall;
     mesh_drawable ceiling;
-    mesh_drawable castle;
-
-    std::vector<vec3> p; //Fishes' position
-    std::vector<vec3> v; //Fishes' speed
-    std::vector<vec4> lmesh_center; //Store the mesh's center for the bounding volume handling collisions
-    std::vector<vec3> trans_mesh; //Store the translation for the bounding volume handling collisions
-
+    lod_mesh_drawable castle;
+
+    heightfield_structure dune_heightfield; //Baked height of the dunes used by the terrain mesh and the camera
+    flock_simulation_structure simulation; //Fishes' boids simulation (obstacles, walls, terrain)
+    triple_buffer<flock_snapshot_structure> flock_snapshots; //Last states of the flock, read by the display without lock
+    simulation_inputs_structure simulation_inputs; //Protected by simulation_inputs_mutex
+    std::mutex simulation_inputs_mutex;
+
+    cgp::render_queue opaque_queue; //Opaque shapes of the frame, sorted to limit the OpenGL state changes
+    cgp::opengl_streaming_buffer stream; //Dynamic data of the frame (fish instances), written without waiting for the GPU to finish the previous frames
+    cgp::occlusion_buffer occlusion; //Depth of the occluders rasterized on the CPU at each frame
+    mesh occluder_terrain; //Occluders in local coordinates (placed by the model of their drawable)
+    mesh occluder_castle;
+    mesh occluder_arch;
+    opengl_texture_image_structure occlusion_texture; //Debug view of the occlusion buffer
     cgp::skybox_drawable skybox;
+    cgp::asset_handle<std::shared_ptr<cgp::texture_cache_file>> texture_sand; //Texture of the terrain, the arch and the craters (read once)
+    int obstacles_pending = 0; //Decorations not loaded yet: the distance field of the obstacles is computed once they are all added
+    bool simulation_ready = false; //The simulation only starts once its obstacles are computed
     std::map<std::string, mesh_drawable> shapes;
     std::vector<float> random_floats;
     vec3 p_interpolations[3];
@@ -73,7 +102,7 @@ struct scene_structure : cgp::scene_inputs_generic {
     // Functions
     // ****************************** //
 
-    void simulation_step(float dt);
+    void simulation_tick();
     void initialize();   
     void display_frame(); 
     void display_gui();  
@@ -84,8 +113,10 @@ struct scene_structure : cgp::scene_inputs_generic {
     void creation_mesh_fish();
     void creation_mesh_decoration();
     void creation_mesh_bubble_crater();
+    void add_obstacle(mesh const& shape, cgp::affine const& transform); //Obstacle of a decoration once loaded (the last one starts the simulation)
     void display_skybox();
     void display_bubble_wall(vec3 p_interpolations[3]);
+    void rasterize_occluders();
 
     void mouse_move_event();
     void mouse_click_event();
@@ -93,4 +124,8 @@ struct scene_structure : cgp::scene_inputs_generic {
     void idle_frame();
 
     void display_info();
+
+    cgp::thread_pool asset_pool; //Own pool: the waits of the per-frame parallel loops (occlusion, simulation) on the default pool never run a loading task
+    cgp::asset_loader assets{ asset_pool }; //Files read and processed on the threads of asset_pool, sent to the GPU at the beginning of the frames (its tasks may use the simulation)
+    simulation_thread_structure simulation_thread; //Declared last: the thread is stopped before the rest of the scene is destroyed
 };
@@ -0,0 +1,226 @@
+#include "signed_distance_field.hpp"
+#include "cgp/01_base/thread_pool/thread_pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <limits>
+
+using namespace cgp;
+
+// Closest point to p on the triangle (a,b,c) (Ericson, Real-Time Collision Detection, 5.1.5)
+static vec3 closest_point_triangle(vec3 const& p, vec3 const& a, vec3 const& b, vec3 const& c) {
+	vec3 const ab = b - a, ac = c - a, ap = p - a;
+	float const d1 = dot(ab, ap), d2 = dot(ac, ap);
+	if (d1 <= 0 && d2 <= 0) return a;
+
+	vec3 const bp = p - b;
+	float const d3 = dot(ab, bp), d4 = dot(ac, bp);
+	if (d3 >= 0 && d4 <= d3) return b;
+
+	float const vc = d1 * d4 - d3 * d2;
+	if (vc <= 0 && d1 >= 0 && d3 <= 0) return a + d1 / (d1 - d3) * ab;
+
+	vec3 const cp = p - c;
+	float const d5 = dot(ab, cp), d6 = dot(ac, cp);
+	if (d6 >= 0 && d5 <= d6) return c;
+
+	float const vb = d5 * d2 - d1 * d6;
+	if (vb <= 0 && d2 >= 0 && d6 <= 0) return a + d2 / (d2 - d6) * ac;
+
+	float const va = d3 * d6 - d5 * d4;
+	if (va <= 0 && (d4 - d3) >= 0 && (d5 - d6) >= 0) return b + (d4 - d3) / ((d4 - d3) + (d5 - d6)) * (c - b);
+
+	float const denom = 1.0f / (va + vb + vc);
+	return a + (vb * denom) * ab + (vc * denom) * ac;
+}
+
+// Squared distance from p to the box [p_min, p_max]
+static float distance_squared_box(vec3 const& p, vec3 const& p_min, vec3 const& p_max) {
+	float const ex = std::max(std::max(p_min.x - p.x, p.x - p_max.x), 0.0f);
+	float const ey = std::max(std::max(p_min.y - p.y, p.y - p_max.y), 0.0f);
+	float const ez = std::max(std::max(p_min.z - p.z, p.z - p_max.z), 0.0f);
+	return ex * ex + ey * ey + ez * ez;
+}
+
+void signed_distance_field_structure::bake(std::vector<vec3> const& triangles, spatial_domain_grid_3D const& domain_arg, float band_width_arg,
+	std::function<float(vec3 const&)> const& analytic_distance)
+{
+	assert_cgp(triangles.size() % 3 == 0, "Triangles must be given as 3 consecutive positions");
+	domain = domain_arg;
+	band_width = band_width_arg;
+	int3 const N = domain.samples;
+	vec3 const p0 = domain.corner_min();
+	vec3 const h = domain.voxel_length();
+	node.resize(N);
+
+	// Exact distance in a narrow band around the triangles, then propagated to the other nodes by fast sweeping:
+	//  each node takes the closest surface point of its neighbors if it is closer than its own.
+	float const narrow_width = norm(h); // Diagonal of a voxel: the nodes around each triangle get their exact closest point
+
+	// Triangles stored in buckets of size narrow_width: all the triangles closer than narrow_width to a node are in the bucket of the node
+	int const nb_triangle = int(triangles.size() / 3);
+	std::vector<vec3> box_min(nb_triangle), box_max(nb_triangle);
+	int3 const B = { int(domain.length.x / narrow_width) + 1, int(domain.length.y / narrow_width) + 1, int(domain.length.z / narrow_width) + 1 };
+	std::vector<std::vector<int> > bucket(size_t(B.x) * B.y * B.z);
+	auto bucket_coordinate = [&](float x, int k) { return std::min(std::max(int((x - p0[k]) / narrow_width), 0), B[k] - 1); };
+	for (int t = 0; t < nb_triangle; ++t) {
+		vec3 const& a = triangles[3 * t], & b = triangles[3 * t + 1], & c = triangles[3 * t + 2];
+		if (norm(cross(b - a, c - a)) < 1e-12f) continue; // Degenerate triangle
+		for (int k = 0; k < 3; ++k) {
+			box_min[t][k] = std::min(std::min(a[k], b[k]), c[k]);
+			box_max[t][k] = std::max(std::max(a[k], b[k]), c[k]);
+		}
+		int3 const k0 = { bucket_coordinate(box_min[t].x - narrow_width, 0), bucket_coordinate(box_min[t].y - narrow_width, 1), bucket_coordinate(box_min[t].z - narrow_width, 2) };
+		int3 const k1 = { bucket_coordinate(box_max[t].x + narrow_width, 0), bucket_coordinate(box_max[t].y + narrow_width, 1), bucket_coordinate(box_max[t].z + narrow_width, 2) };
+		for (int kz = k0.z; kz <= k1.z; ++kz)
+			for (int ky = k0.y; ky <= k1.y; ++ky)
+				for (int kx = k0.x; kx <= k1.x; ++kx)
+					bucket[kx + B.x * (ky + B.y * kz)].push_back(t);
+	}
+
+	float const no_point = std::numeric_limits<float>::max();
+	std::vector<vec3> closest(node.size());  // Closest surface point found for each node
+	std::vector<float> d2(node.size(), no_point); // Squared distance to it
+	parallel_for(0, N.z, [&](int kz) {
+		for (int ky = 0; ky < N.y; ++ky) {
+			for (int kx = 0; kx < N.x; ++kx) {
+				vec3 const p = { p0.x + kx * h.x, p0.y + ky * h.y, p0.z + kz * h.z };
+				std::vector<int> const& candidates = bucket[bucket_coordinate(p.x, 0) + B.x * (bucket_coordinate(p.y, 1) + B.y * bucket_coordinate(p.z, 2))];
+				int const offset = node.index_to_offset(kx, ky, kz);
+				float d2_min = narrow_width * narrow_width;
+				for (int t : candidates) {
+					if (distance_squared_box(p, box_min[t], box_max[t]) >= d2_min) continue;
+					vec3 const q = closest_point_triangle(p, triangles[3 * t], triangles[3 * t + 1], triangles[3 * t + 2]);
+					float const d2_q = dot(p - q, p - q);
+					if (d2_q < d2_min) {
+						d2_min = d2_q;
+						closest[offset] = q;
+						d2[offset] = d2_q;
+					}
+				}
+			}
+		}
+	});
+
+	// Fast sweeping in the 8 diagonal orders (the upstream neighbors along x, y and z are visited before each node)
+	int const stride_y = N.x, stride_z = N.x * N.y;
+	auto relax = [&](int offset, int offset_n, vec3 const& p) {
+		if (d2[offset_n] == no_point) return;
+		vec3 const& q = closest[offset_n];
+		float const d2_q = (p.x - q.x) * (p.x - q.x) + (p.y - q.y) * (p.y - q.y) + (p.z - q.z) * (p.z - q.z);
+		if (d2_q < d2[offset]) {
+			d2[offset] = d2_q;
+			closest[offset] = q;
+		}
+	};
+	for (int sweep = 0; sweep < 8; ++sweep) {
+		int const sx = (sweep & 1) ? -1 : 1, sy = (sweep & 2) ? -1 : 1, sz = (sweep & 4) ? -1 : 1;
+		for (int iz = 0; iz < N.z; ++iz) {
+			int const kz = sz > 0 ? iz : N.z - 1 - iz;
+			for (int iy = 0; iy < N.y; ++iy) {
+				int const ky = sy > 0 ? iy : N.y - 1 - iy;
+				for (int ix = 0; ix < N.x; ++ix) {
+					int const kx = sx > 0 ? ix : N.x - 1 - ix;
+					int const offset = kx + stride_y * ky + stride_z * kz;
+					vec3 const p = { p0.x + kx * h.x, p0.y + ky * h.y, p0.z + kz * h.z };
+					if (ix > 0) relax(offset, offset - sx, p);
+					if (iy > 0) relax(offset, offset - sy * stride_y, p);
+					if (iz > 0) relax(offset, offset - sz * stride_z, p);
+				}
+			}
+		}
+	}
+
+	// Unsigned distance to the triangles, clamped to band_width
+	std::vector<float> d_mesh(node.size());
+	for (int k = 0; k < node.size(); ++k)
+		d_mesh[k] = d2[k] == no_point ? band_width : std::min(std::sqrt(d2[k]), band_width);
+
+	// Sign: flood fill of the outside from the border of the domain, stopped by the nodes close to a surface
+	float const surface_threshold = 0.5f * norm(h); // Half of the diagonal of a voxel: a surface cannot pass between two neighbors farther than this
+	std::vector<char> outside(node.size(), 0);
+	std::deque<int3> front;
+	for (int kz = 0; kz < N.z; ++kz) {
+		for (int ky = 0; ky < N.y; ++ky) {
+			for (int kx = 0; kx < N.x; ++kx) {
+				bool const border = kx == 0 || ky == 0 || kz == 0 || kx == N.x - 1 || ky == N.y - 1 || kz == N.z - 1;
+				int const offset = node.index_to_offset(kx, ky, kz);
+				if (border && d_mesh[offset] > surface_threshold) {
+					outside[offset] = 1;
+					front.push_back({ kx, ky, kz });
+				}
+			}
+		}
+	}
+	int3 const neighbors[6] = { {1,0,0}, {-1,0,0}, {0,1,0}, {0,-1,0}, {0,0,1}, {0,0,-1} };
+	while (!front.empty()) {
+		int3 const k = front.front();
+		front.pop_front();
+		for (int3 const& dk : neighbors) {
+			int3 const n = k + dk;
+			if (n.x < 0 || n.y < 0 || n.z < 0 || n.x >= N.x || n.y >= N.y || n.z >= N.z) continue;
+			int const offset = node.index_to_offset(n.x, n.y, n.z);
+			if (outside[offset] == 0 && d_mesh[offset] > surface_threshold) {
+				outside[offset] = 1;
+				front.push_back(n);
+			}
+		}
+	}
+
+	// Signed distance combined with the analytic part
+	parallel_for(0, N.z, [&](int kz) {
+		for (int ky = 0; ky < N.y; ++ky) {
+			for (int kx = 0; kx < N.x; ++kx) {
+				int const offset = node.index_to_offset(kx, ky, kz);
+				bool const inside = outside[offset] == 0 && d_mesh[offset] > surface_threshold;
+				float d = inside ? -d_mesh[offset] : d_mesh[offset];
+				if (analytic_distance)
+					d = std::min(d, analytic_distance({ p0.x + kx * h.x, p0.y + ky * h.y, p0.z + kz * h.z }));
+				node.data[offset] = { d, 0, 0, 0 };
+			}
+		}
+	});
+
+	// Gradient by finite differences (centered inside the domain, one-sided on its border)
+	vec4* n = &node.data.data[0];
+	parallel_for(0, N.z, [&](int kz) {
+		int const z0 = std::max(kz - 1, 0), z1 = std::min(kz + 1, N.z - 1);
+		for (int ky = 0; ky < N.y; ++ky) {
+			int const y0 = std::max(ky - 1, 0), y1 = std::min(ky + 1, N.y - 1);
+			for (int kx = 0; kx < N.x; ++kx) {
+				int const x0 = std::max(kx - 1, 0), x1 = std::min(kx + 1, N.x - 1);
+				int const offset = kx + stride_y * ky + stride_z * kz;
+				vec4& g = n[offset];
+				g.y = (n[x1 + stride_y * ky + stride_z * kz].x - n[x0 + stride_y * ky + stride_z * kz].x) / ((x1 - x0) * h.x);
+				g.z = (n[kx + stride_y * y1 + stride_z * kz].x - n[kx + stride_y * y0 + stride_z * kz].x) / ((y1 - y0) * h.y);
+				g.w = (n[kx + stride_y * ky + stride_z * z1].x - n[kx + stride_y * ky + stride_z * z0].x) / ((z1 - z0) * h.z);
+			}
+		}
+	});
+}
+
+vec4 signed_distance_field_structure::value(vec3 const& p) const {
+	int3 const N = domain.samples;
+	vec3 const p0 = domain.corner_min();
+	vec3 const h = domain.voxel_length();
+	float const gx = std::min(std::max((p.x - p0.x) / h.x, 0.0f), float(N.x - 1));
+	float const gy = std::min(std::max((p.y - p0.y) / h.y, 0.0f), float(N.y - 1));
+	float const gz = std::min(std::max((p.z - p0.z) / h.z, 0.0f), float(N.z - 1));
+	int const kx = std::min(int(gx), N.x - 2), ky = std::min(int(gy), N.y - 2), kz = std::min(int(gz), N.z - 2);
+	float const ux = gx - kx, uy = gy - ky, uz = gz - kz;
+
+	int const sy = N.x, sz = N.x * N.y; // Offsets of the neighbors along y and z
+	vec4 const* n = &node.data.data[kx + sy * ky + sz * kz];
+	vec4 const c00 = (1 - ux) * n[0] + ux * n[1];
+	vec4 const c10 = (1 - ux) * n[sy] + ux * n[sy + 1];
+	vec4 const c01 = (1 - ux) * n[sz] + ux * n[sz + 1];
+	vec4 const c11 = (1 - ux) * n[sz + sy] + ux * n[sz + sy + 1];
+	return (1 - uz) * ((1 - uy) * c00 + uy * c10) + uz * ((1 - uy) * c01 + uy * c11);
+}
+
+grid_3D<float> signed_distance_field_structure::distance() const {
+	grid_3D<float> d(node.dimension);
+	for (int k = 0; k < node.size(); ++k)
+		d.data[k] = node.data[k].x;
+	return d;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "cgp/04_grid_container/grid_container.hpp"
+#include "cgp/05_vec/vec.hpp"
+#include "cgp/12_shape/spatial_domain/spatial_domain.hpp"
+#include <functional>
+#include <vector>
+
+// Signed distance to static geometry baked on a regular 3D grid
+//  Positive in the free space, negative inside the obstacles.
+//  Each node stores the distance and its gradient: a single trilinear lookup gives both.
+//  The distance to the triangles is exact near them, propagated by fast sweeping farther, and clamped to band_width.
+struct signed_distance_field_structure {
+	cgp::spatial_domain_grid_3D domain;
+	cgp::grid_3D<cgp::vec4> node; // (d, dd/dx, dd/dy, dd/dz) at each node of the domain
+	float band_width = 0;
+
+	// Bake the field on the domain from the triangles (3 consecutive positions per triangle, in world coordinates)
+	//  The sign is found by a flood fill from the border of the domain: only the closed parts of the meshes have an inside.
+	//  If analytic_distance is given, the result is the union min(d_triangles, analytic_distance(p)) (ex. walls and terrain)
+	void bake(std::vector<cgp::vec3> const& triangles, cgp::spatial_domain_grid_3D const& domain, float band_width,
+		std::function<float(cgp::vec3 const&)> const& analytic_distance = nullptr);
+
+	// Trilinear lookup (positions outside of the domain are clamped): (d, gradient)
+	cgp::vec4 value(cgp::vec3 const& p) const;
+
+	// Distances alone (ex. input of the marching cube to display an iso-surface)
+	cgp::grid_3D<float> distance() const;
+
+	bool empty() const { return node.size() == 0; }
+};
@@ -0,0 +1,25 @@
+#include "simulation_thread.hpp"
+
+void simulation_thread_structure::start(std::function<void()> const& step) {
+	if (running)
+		return;
+	running = true;
+	thread = std::thread([this, step]() {
+		using clock = std::chrono::steady_clock;
+		clock::duration const period = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / frequency));
+		clock::time_point next = clock::now();
+		while (running) {
+			step();
+			next += period;
+			if (clock::now() > next + 4 * period) // The simulation cannot keep up: drop the late steps instead of catching up
+				next = clock::now();
+			std::this_thread::sleep_until(next);
+		}
+	});
+}
+
+void simulation_thread_structure::stop() {
+	running = false;
+	if (thread.joinable())
+		thread.join();
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <thread>
+
+// Lock-free triple buffer: one writer thread publishes complete states, one reader thread always gets the most recent one
+//  The writer fills write_buffer() then calls publish(). The reader calls read() and can use the result until its next call to read().
+template <typename T>
+struct triple_buffer {
+	T const& read() {
+		if (middle.load() & fresh_flag) // A new state was published since the last read
+			front = middle.exchange(front) & index_mask;
+		return buffer[front];
+	}
+	T& write_buffer() { return buffer[back]; }
+	void publish() { back = middle.exchange(back | fresh_flag) & index_mask; }
+
+private:
+	static int const index_mask = 3;
+	static int const fresh_flag = 4;
+
+	T buffer[3];
+	int back = 0;              // Owned by the writer
+	std::atomic<int> middle{ 1 }; // Exchanged between the writer and the reader
+	int front = 2;             // Owned by the reader
+};
+
+
+// Thread calling a step function at a fixed rate, independently of the display
+struct simulation_thread_structure {
+	float frequency = 60.0f; // Number of steps per second
+
+	// Start the thread calling step() every 1/frequency seconds
+	void start(std::function<void()> const& step);
+	// Stop the thread and wait for the end of the current step
+	void stop();
+	bool is_running() const { return running; }
+
+	~simulation_thread_structure() { stop(); }
+
+private:
+	std::thread thread;
+	std::atomic<bool> running{ false };
+};
@@ -0,0 +1,97 @@
+#include "spatial_grid.hpp"
+#include "flock.hpp"
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+using namespace cgp;
+
+// Upper bound on the number of cells: the cell size is enlarged if the particles are spread over a very large domain
+static int const max_number_of_cells = 1 << 18;
+
+int3 spatial_grid_structure::cell_coordinates(vec3 const& p) const {
+	int3 k;
+	for (int c = 0; c < 3; ++c) {
+		k[c] = int((p[c] - p_min[c]) / cell_size);
+		k[c] = std::min(std::max(k[c], 0), dimension[c] - 1);
+	}
+	return k;
+}
+
+void spatial_grid_structure::build(std::vector<vec3> const& p, float cell_size_min, thread_pool* pool) {
+	if (p.size() == 0)
+		build(nullptr, nullptr, nullptr, 0, cell_size_min, 3, pool);
+	else
+		build(&p[0].x, &p[0].y, &p[0].z, int(p.size()), cell_size_min, 3, pool);
+}
+
+void spatial_grid_structure::build(float const* x, float const* y, float const* z, int N, float cell_size_min, int stride, thread_pool* pool) {
+	float const* coord[3] = { x, y, z };
+
+	// Bounding box of the particles
+	vec3 p_max;
+	p_min = N > 0 ? vec3(x[0], y[0], z[0]) : vec3(0, 0, 0);
+	p_max = p_min;
+	for (int c = 0; c < 3; ++c) {
+		for (int i = 1; i < N; ++i) {
+			float const value = coord[c][size_t(i) * stride];
+			p_min[c] = std::min(p_min[c], value);
+			p_max[c] = std::max(p_max[c], value);
+		}
+	}
+
+	cell_size = cell_size_min;
+	do {
+		for (int c = 0; c < 3; ++c)
+			dimension[c] = int((p_max[c] - p_min[c]) / cell_size) + 1;
+		if (number_of_cells() > max_number_of_cells)
+			cell_size *= 2;
+	} while (number_of_cells() > max_number_of_cells);
+	int const N_cell = number_of_cells();
+
+	particle_cell.resize(N);
+	sorted_index.resize(N);
+
+	flock_parallel_for(pool, N, 1024, [&](int i) {
+		size_t const offset = size_t(i) * stride;
+		int3 const k = cell_coordinates(vec3(x[offset], y[offset], z[offset]));
+		particle_cell[i] = cell_index(k.x, k.y, k.z);
+	});
+
+	// Parallel counting sort: each thread counts the particles of its own contiguous range
+	int N_thread = 1;
+	if (pool != nullptr)
+		N_thread = pool->size();
+#ifdef _OPENMP
+	else
+		N_thread = omp_get_max_threads();
+#endif
+	N_thread = std::max(1, std::min(N_thread, N / 1024));
+	std::vector<int> count(size_t(N_thread) * N_cell, 0);
+
+	flock_parallel_for(pool, N_thread, 1, [&](int t) {
+		int* count_t = &count[size_t(t) * N_cell];
+		for (int i = N * t / N_thread; i < N * (t + 1) / N_thread; ++i)
+			count_t[particle_cell[i]]++;
+	});
+
+	// Exclusive prefix sum (cell major, thread minor) so that the sort is stable
+	cell_start.resize(N_cell + 1);
+	int offset = 0;
+	for (int c = 0; c < N_cell; ++c) {
+		cell_start[c] = offset;
+		for (int t = 0; t < N_thread; ++t) {
+			int const n = count[size_t(t) * N_cell + c];
+			count[size_t(t) * N_cell + c] = offset;
+			offset += n;
+		}
+	}
+	cell_start[N_cell] = offset;
+
+	flock_parallel_for(pool, N_thread, 1, [&](int t) {
+		int* offset_t = &count[size_t(t) * N_cell];
+		for (int i = N * t / N_thread; i < N * (t + 1) / N_thread; ++i)
+			sorted_index[offset_t[particle_cell[i]]++] = i;
+	});
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "cgp/01_base/thread_pool/thread_pool.hpp"
+#include "cgp/05_vec/vec.hpp"
+#include <vector>
+#include <algorithm>
+
+// Uniform grid (cell list) used to accelerate the neighbor search between fishes
+//  The grid is rebuilt at every step with a counting sort: the particles of a same cell are stored contiguously in sorted_index.
+//  With a cell size larger than the interaction radius, all the neighbors of a particle are in the 27 cells around it.
+struct spatial_grid_structure {
+	float cell_size = 1.0f;
+	cgp::vec3 p_min;                 // Corner of the grid
+	cgp::int3 dimension = { 0,0,0 }; // Number of cells along x, y, z
+
+	std::vector<int> cell_start;    // Particles of cell c are sorted_index[cell_start[c]] ... sorted_index[cell_start[c+1]-1]
+	std::vector<int> sorted_index;  // Particle indices sorted by cell (x is the fastest varying index)
+	std::vector<int> particle_cell; // Cell index of each particle
+
+	// Rebuild the grid from the positions p. cell_size_min should be at least the interaction radius
+	//  pool: threads of the parallel loops (OpenMP if null, see flock_parallel_for)
+	void build(std::vector<cgp::vec3> const& p, float cell_size_min, cgp::thread_pool* pool = nullptr);
+	// Same from N positions stored as separate coordinates: (x[i*stride], y[i*stride], z[i*stride])
+	void build(float const* x, float const* y, float const* z, int N, float cell_size_min, int stride = 1, cgp::thread_pool* pool = nullptr);
+
+	cgp::int3 cell_coordinates(cgp::vec3 const& p) const;
+	int cell_index(int kx, int ky, int kz) const { return kx + dimension.x * (ky + dimension.y * kz); }
+	int number_of_cells() const { return dimension.x * dimension.y * dimension.z; }
+
+	// Call f(j) for every particle j stored in the 27 cells around the position p (p itself may be part of it)
+	template <typename F> void for_each_neighbor(cgp::vec3 const& p, F const& f) const;
+};
+
+
+template <typename F> void spatial_grid_structure::for_each_neighbor(cgp::vec3 const& p, F const& f) const
+{
+	cgp::int3 const k = cell_coordinates(p);
+	int const x0 = std::max(k.x - 1, 0), x1 = std::min(k.x + 1, dimension.x - 1);
+	int const y0 = std::max(k.y - 1, 0), y1 = std::min(k.y + 1, dimension.y - 1);
+	int const z0 = std::max(k.z - 1, 0), z1 = std::min(k.z + 1, dimension.z - 1);
+
+	for (int kz = z0; kz <= z1; ++kz) {
+		for (int ky = y0; ky <= y1; ++ky) {
+			// Cells along x are consecutive: their particles form a single contiguous run
+			int const start = cell_start[cell_index(x0, ky, kz)];
+			int const end = cell_start[cell_index(x1, ky, kz) + 1];
+			for (int s = start; s < end; ++s)
+				f(sorted_index[s]);
+		}
+	}
+}
@@ -1,55 +1,98 @@
 #include "terrain.hpp"
+#include "cgp/11_mesh/primitive/primitive.hpp"
+#include "cgp/08_random_noise/random_stream/random_stream.hpp"
+#include <algorithm>
 #include <cmath>
 #include <vector>
-#include <cstdlib>
-#include <ctime>  
 #include <unordered_set>
 
 using namespace cgp;
 
 
+// Gaussian bumps of the dunes: centers, heights and widths
+static int const dune_count = 15;
+static vec2 const dune_center[dune_count] = { {-25,-25}, {20,20}, {-10,15}, {15,15}, {-20,-20},
+                                              {0,0}, {-15,10}, {10,-15}, {-5,20}, {25,25},
+                                              {-25,0}, {0,25}, {25,-25}, {20,0}, {0,-20} };
+static float const dune_height[dune_count] = { 2.0f, -1.0f, 1.5f, 2.5f, 4.0f,
+                                               0.5f, 1.0f, 2.0f, -0.5f, 8.0f,
+                                               1.0f, 2.0f, -1.5f, 3.0f, 2.0f };
+static float const dune_sigma[dune_count] = { 24.0f, 9.0f, 12.0f, 12.0f, 15.0f,
+                                              6.0f, 9.0f, 12.0f, 15.0f, 18.0f,
+                                              9.0f, 9.0f, 12.0f, 12.0f, 9.0f };
+
 // Fonction pour valuer la hauteur des dunes
 float evaluate_dune_height(float x, float y) {
-    int const n = 15;
-    vec2 p_i[n] = { {-25,-25}, {20,20}, {-10,15}, {15,15}, {-20,-20},
-                    {0,0}, {-15,10}, {10,-15}, {-5,20}, {25,25},
-                    {-25,0}, {0,25}, {25,-25}, {20,0}, {0,-20} };
-    float h_i[n] = { 2.0f, -1.0f, 1.5f, 2.5f, 4.0f,
-                     0.5f, 1.0f, 2.0f, -0.5f, 8.0f,
-                     1.0f, 2.0f, -1.5f, 3.0f, 2.0f };
-    float sigma_i[n] = { 24.0f, 9.0f, 12.0f, 12.0f, 15.0f,
-                         6.0f, 9.0f, 12.0f, 15.0f, 18.0f,
-                         9.0f, 9.0f, 12.0f, 12.0f, 9.0f };
     float s = 0.0;
     float d = 0.0;
-    for (int i = 0; i < n; i++) {
-        d = norm(vec2{ x, y } - p_i[i]) / sigma_i[i];
-        s += h_i[i] * std::exp(-d * d);
+    for (int i = 0; i < dune_count; i++) {
+        d = norm(vec2{ x, y } - dune_center[i]) / dune_sigma[i];
+        s += dune_height[i] * std::exp(-d * d);
     }
 
     return s;
 }
 
-mesh create_dune_mesh(int N, float size) {
+vec4 evaluate_dune_height_derivatives(float x, float y) {
+    vec4 s = { 0,0,0,0 };
+    for (int i = 0; i < dune_count; i++) {
+        float const inv_sigma2 = 1.0f / (dune_sigma[i] * dune_sigma[i]);
+        float const rx = x - dune_center[i].x;
+        float const ry = y - dune_center[i].y;
+        float const g = dune_height[i] * std::exp(-(rx * rx + ry * ry) * inv_sigma2);
+        s += vec4(g, -2 * rx * inv_sigma2 * g, -2 * ry * inv_sigma2 * g, 4 * rx * ry * inv_sigma2 * inv_sigma2 * g);
+    }
+    return s;
+}
+
+heightfield_structure create_dune_heightfield(float length, int N) {
+    heightfield_structure heightfield;
+    heightfield.initialize(evaluate_dune_height_derivatives, length, N);
+    return heightfield;
+}
+
+mesh create_dune_mesh(heightfield_structure const& heightfield, int N, float size) {
     mesh terrain = mesh_primitive_grid(vec3(-size / 2, -size / 2, 0), vec3(size / 2, -size / 2, 0), vec3(size / 2, size / 2, 0), vec3(-size / 2, size / 2, 0), N, N);
-    for (size_t i = 0; i < terrain.position.size(); ++i) { // Modify the heights of the vertices
-        terrain.position[i].z = evaluate_dune_height(terrain.position[i].x, terrain.position[i].y);
+    for (size_t i = 0; i < terrain.position.size(); ++i) { // Heights and normals of the vertices from the bicubic patches
+        vec3& p = terrain.position[i];
+        vec2 gradient;
+        p.z = heightfield.height_bicubic(p.x, p.y, gradient);
+        terrain.normal[i] = normalize(vec3(-gradient.x, -gradient.y, 1.0f));
     }
     terrain.fill_empty_field();
 
     return terrain;
 }
 
-float rand_interval(float min, float max) {
-    return min + static_cast<float>(rand()) / (static_cast<float>(RAND_MAX / (max - min)));
+mesh create_dune_occluder(mesh const& terrain, int N, int N_occluder) {
+    vec3 const& p_min = terrain.position[0];
+    vec3 const& p_max = terrain.position[N * N - 1];
+    mesh occluder = mesh_primitive_grid(vec3(p_min.x, p_min.y, 0), vec3(p_max.x, p_min.y, 0), vec3(p_max.x, p_max.y, 0), vec3(p_min.x, p_max.y, 0), N_occluder, N_occluder);
+
+    // Terrain vertices within one coarse cell (and one fine cell) of the coarse vertex: they cover the coarse triangles around it
+    int const step = (N - 1 + N_occluder - 2) / (N_occluder - 1) + 1;
+    for (int ku = 0; ku < N_occluder; ++ku) {
+        for (int kv = 0; kv < N_occluder; ++kv) {
+            int const fu = ku * (N - 1) / (N_occluder - 1);
+            int const fv = kv * (N - 1) / (N_occluder - 1);
+            float h = terrain.position[fv + N * fu].z;
+            for (int u = std::max(fu - step, 0); u <= std::min(fu + step, N - 1); ++u)
+                for (int v = std::max(fv - step, 0); v <= std::min(fv + step, N - 1); ++v)
+                    h = std::min(h, terrain.position[v + N * u].z);
+            occluder.position[kv + N_occluder * ku].z = h;
+        }
+    }
+    return occluder;
+}
+
+static float rand_interval(float min, float max) {
+    return random_stream_thread().uniform(min, max);
 }
 
 std::vector<cgp::vec3> generate_positions_on_terrain(int N, float terrain_radius, float trans, float bordure) {
     std::vector<cgp::vec3> list;
     float x, y;
 
-    std::srand(static_cast<unsigned int>(std::time(0)));
-
     for (int i = 0; i < N; i++) {
         float num = terrain_radius / 2 - bordure;
         x = rand_interval(-num,num );
@@ -64,10 +107,8 @@ std::vector<vec3> generate_positions_around_points(int N, float terrain_radius,
     std::vector<vec3> list;
     float x, y;
 
-    std::srand(static_cast<unsigned int>(std::time(0)));
-
     for (int i = 0; i < N; i++) {
-        const vec3& center = points[rand() % points.size()];
+        const vec3& center = points[random_stream_thread().uniform_int(0, int(points.size()) - 1)];
 
         x = center.x + rand_interval(-spread, spread);
         y = center.y + rand_interval(-spread, spread);
@@ -1,6 +1,7 @@
 #pragma once
 
-#include "cgp/cgp.hpp"
+#include "cgp/11_mesh/mesh/mesh.hpp"
+#include "heightfield.hpp"
 
 struct perlin_noise_parameters {
 	int octave = 10;
@@ -10,15 +11,23 @@ struct perlin_noise_parameters {
 
 
 float evaluate_dune_height(float x, float y);
+// Height of the dunes and its derivatives (h, dh/dx, dh/dy, d2h/dxdy), computed analytically
+cgp::vec4 evaluate_dune_height_derivatives(float x, float y);
+
+// Dunes baked on N x N nodes over [-length/2, length/2]^2 (height lookups without evaluating the gaussians)
+heightfield_structure create_dune_heightfield(float length, int N = 257);
 
 
 
 /** Compute a terrain mesh 
 	The (x,y) coordinates of the terrain are set in [-length/2, length/2].
-	The z coordinates of the vertices are computed using evaluate_terrain_height(x,y).
+	The z coordinates and the normals of the vertices are given by the bicubic lookup in the heightfield.
 	The vertices are sampled along a regular grid structure in (x,y) directions. 
 	The total number of vertices is N*N (N along each direction x/y) 	*/
-cgp::mesh create_dune_mesh(int N, float length);
+cgp::mesh create_dune_mesh(heightfield_structure const& heightfield, int N, float length);
+// Coarse grid of N_occluder x N_occluder vertices below the terrain mesh (N x N vertices created by create_dune_mesh)
+//  Each vertex takes the lowest height of the terrain vertices around it: the coarse surface never passes above the terrain (occluder of the occlusion culling).
+cgp::mesh create_dune_occluder(cgp::mesh const& terrain, int N, int N_occluder);
 std::vector<cgp::vec3> generate_positions_on_terrain(int N, float size, float trans, float bordure);
 std::vector<cgp::vec3> generate_positions_around_points(int N, float terrain_radius, float trans, const std::vector<cgp::vec3>& points, float spread);
 
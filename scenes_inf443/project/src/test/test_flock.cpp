@@ -0,0 +1,105 @@
+#include "test_flock.hpp"
+
+#include "../flock.hpp"
+#include "cgp/01_base/base.hpp"
+#include "cgp/09_geometric_transformation/rotation_transform/rotation_transform.hpp"
+
+#include <random>
+#include <algorithm>
+
+using namespace cgp;
+
+namespace project_test
+{
+	// Maximal error allowed between the SIMD kernel and the scalar path, relative to the magnitude of the force
+	static float const tolerance = 1e-3f;
+
+	static bool is_close(vec3 const& a, vec3 const& b) {
+		return norm(a - b) <= tolerance * (1.0f + norm(b));
+	}
+
+	void test_flock_forces()
+	{
+		int const N = 3000;
+		float const l = 10.0f; // Dense flock: every interaction regime is present
+
+		std::mt19937 generator(42);
+		std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+		std::vector<vec3> p(N), v(N);
+		flock_structure flock;
+		flock.resize(N);
+		for (int i = 0; i < N; ++i) {
+			p[i] = l * vec3(uniform(generator), uniform(generator), uniform(generator));
+			v[i] = vec3(uniform(generator), uniform(generator), uniform(generator));
+			flock.p.set(i, p[i]);
+			flock.v.set(i, v[i]);
+		}
+		p[1] = p[0]; // Superimposed fishes are ignored
+		flock.p.set(1, p[1]);
+
+		std::vector<vec3> F_reference;
+		flock_interaction_forces_reference(p, v, F_reference);
+
+		soa_vec3_array F_brute_force;
+		flock_interaction_forces_brute_force(flock, F_brute_force);
+
+		spatial_grid_structure grid;
+		grid.build(flock.p.x.data(), flock.p.y.data(), flock.p.z.data(), N, 3.0f);
+		soa_vec3_array F_grid;
+		flock_interaction_forces(flock, grid, F_grid);
+
+		// Same cells with the parallel loops run on a thread pool
+		thread_pool pool(4);
+		spatial_grid_structure grid_pool;
+		grid_pool.build(flock.p.x.data(), flock.p.y.data(), flock.p.z.data(), N, 3.0f, 1, &pool);
+		assert_cgp(grid_pool.cell_start == grid.cell_start && grid_pool.sorted_index == grid.sorted_index, "Neighbor grid built on the thread pool differs from the one built with OpenMP");
+
+		for (int i = 0; i < N; ++i) {
+			assert_cgp(is_close(F_brute_force[i], F_reference[i]), "SIMD force differs from the scalar path for fish " + str(i) + ": " + str(F_brute_force[i]) + " / " + str(F_reference[i]));
+			assert_cgp(is_close(F_grid[i], F_reference[i]), "SIMD force with neighbor grid differs from the scalar path for fish " + str(i) + ": " + str(F_grid[i]) + " / " + str(F_reference[i]));
+		}
+	}
+
+	void test_flock_instance_transforms()
+	{
+		int const N = 200;
+		std::mt19937 generator(7);
+		std::uniform_real_distribution<float> uniform(-1.0f, 1.0f);
+
+		flock_snapshot_structure snapshot;
+		snapshot.p_previous.resize(N);
+		snapshot.p.resize(N);
+		snapshot.v.resize(N);
+		for (int i = 0; i < N; ++i) {
+			vec3 const p = 10.0f * vec3(uniform(generator), uniform(generator), uniform(generator));
+			snapshot.p_previous.set(i, p);
+			snapshot.p.set(i, p + 0.1f * vec3(uniform(generator), uniform(generator), uniform(generator)));
+			snapshot.v.set(i, vec3(uniform(generator), uniform(generator), uniform(generator)));
+		}
+		snapshot.p.set(0, snapshot.p_previous[0] + vec3(5, 0, 0)); // Teleported fish
+		snapshot.v.set(1, vec3(-2, 0, 0));                          // Speed opposite to the model axis
+
+		float const alpha = 0.25f;
+		std::vector<vec4> position_phase(N), orientation(N);
+		flock_instance_transforms(snapshot, alpha, position_phase.data(), orientation.data());
+
+		vec3 const axes[3] = { {1,0,0}, {0,1,0}, {0,0,1} };
+		for (int i = 0; i < N; ++i) {
+			vec3 const p_expected = i == 0 ? snapshot.p[0] : snapshot.p_previous[i] + alpha * (snapshot.p[i] - snapshot.p_previous[i]);
+			vec3 const p = { position_phase[i].x, position_phase[i].y, position_phase[i].z };
+			assert_cgp(norm(p - p_expected) < 1e-4f, "Wrong instance position for fish " + str(i) + ": " + str(p) + " / " + str(p_expected));
+
+			// Same rotation as the one of a single mesh_drawable oriented toward the speed
+			rotation_transform const R_expected = rotation_transform::from_vector_transform(vec3(1, 0, 0), normalize(snapshot.v[i])) * rotation_transform::from_axis_angle({ 0, 0, 1 }, Pi / 2);
+			rotation_transform const R(quaternion(orientation[i].x, orientation[i].y, orientation[i].z, orientation[i].w));
+			assert_cgp(std::abs(norm(orientation[i]) - 1.0f) < 1e-4f, "Instance orientation of fish " + str(i) + " is not a unit quaternion");
+			if (i == 1) { // Any half turn is valid: the head must still follow the speed
+				assert_cgp(norm(R * vec3(0, -1, 0) - vec3(-1, 0, 0)) < 1e-3f, "Wrong instance orientation for the fish swimming along -x");
+				continue;
+			}
+			for (vec3 const& e : axes)
+				assert_cgp(norm(R * e - R_expected * e) < 1e-3f, "Wrong instance orientation for fish " + str(i) + ": " + str(R * e) + " / " + str(R_expected * e));
+		}
+	}
+}
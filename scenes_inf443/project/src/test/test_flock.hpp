@@ -0,0 +1,10 @@
+#pragma once
+
+
+namespace project_test
+{
+	// Compare the SIMD force kernel (with and without neighbor grid) to the scalar reference path
+	void test_flock_forces();
+	// Compare the batched instance transforms of the display to the rotation of a single mesh_drawable
+	void test_flock_instance_transforms();
+}
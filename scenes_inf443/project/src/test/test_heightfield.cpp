@@ -0,0 +1,65 @@
+#include "test_heightfield.hpp"
+
+#include "../heightfield.hpp"
+#include "cgp/01_base/base.hpp"
+
+#include <vector>
+#include <cmath>
+
+using namespace cgp;
+
+namespace project_test
+{
+	// Bilinear function and its derivatives: both interpolations reproduce it exactly on every cell
+	static vec4 bilinear_function(float x, float y) {
+		return { 0.5f + 0.2f * x - 0.3f * y + 0.05f * x * y, 0.2f + 0.05f * y, -0.3f + 0.05f * x, 0.05f };
+	}
+
+	void test_heightfield()
+	{
+		float const length = 8.0f;
+		int const N = 5; // dx = 2
+		heightfield_structure field;
+		field.initialize(bilinear_function, length, N);
+		assert_cgp(std::abs(field.dx - 2.0f) < 1e-6f, "Wrong distance between the nodes of the heightfield: " + str(field.dx));
+
+		float const tolerance = 1e-4f;
+		std::vector<vec2> samples = {
+			{ -4, -4 }, { 0, 0 }, { 2, -2 }, { 4, 4 },  // Nodes (including the corners)
+			{ -3, -3 }, { 1, 0 }, { 0.5f, 3.25f }, { 3.9f, -1.1f } // Between the nodes
+		};
+		for (vec2 const& p : samples) {
+			float const h_expected = bilinear_function(p.x, p.y).x;
+			float const h = field.height(p.x, p.y);
+			assert_cgp(std::abs(h - h_expected) < tolerance, "Wrong bilinear height at " + str(p) + ": " + str(h) + " / " + str(h_expected));
+
+			vec2 gradient;
+			float const h_bicubic = field.height_bicubic(p.x, p.y, gradient);
+			vec4 const f = bilinear_function(p.x, p.y);
+			assert_cgp(std::abs(h_bicubic - h_expected) < tolerance, "Wrong bicubic height at " + str(p) + ": " + str(h_bicubic) + " / " + str(h_expected));
+			assert_cgp(norm(gradient - vec2(f.y, f.z)) < tolerance, "Wrong bicubic gradient at " + str(p) + ": " + str(gradient) + " / " + str(vec2(f.y, f.z)));
+		}
+
+		// Middle of a cell: mean of its 4 nodes
+		float const h_center = field.height(-3, -3);
+		float const h_mean = (bilinear_function(-4, -4).x + bilinear_function(-2, -4).x + bilinear_function(-4, -2).x + bilinear_function(-2, -2).x) / 4;
+		assert_cgp(std::abs(h_center - h_mean) < tolerance, "Bilinear height at the middle of a cell differs from the mean of its nodes: " + str(h_center) + " / " + str(h_mean));
+
+		// Outside of the square: clamped to the border
+		assert_cgp(std::abs(field.height(10, 0) - field.height(4, 0)) < tolerance, "Height outside of the heightfield is not clamped to its border");
+
+		// Batched queries give the same result as the single ones
+		int const count = int(samples.size());
+		std::vector<float> x(count), y(count), h(count), dhdx(count), dhdy(count);
+		for (int k = 0; k < count; ++k) {
+			x[k] = samples[k].x;
+			y[k] = samples[k].y;
+		}
+		field.height_and_gradient(x.data(), y.data(), h.data(), dhdx.data(), dhdy.data(), count);
+		for (int k = 0; k < count; ++k) {
+			vec2 const g = field.gradient(x[k], y[k]);
+			assert_cgp(std::abs(h[k] - field.height(x[k], y[k])) < tolerance, "Batched height differs from the single query at " + str(samples[k]));
+			assert_cgp(std::abs(dhdx[k] - g.x) < tolerance && std::abs(dhdy[k] - g.y) < tolerance, "Batched gradient differs from the single query at " + str(samples[k]));
+		}
+	}
+}
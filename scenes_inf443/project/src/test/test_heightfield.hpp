@@ -0,0 +1,8 @@
+#pragma once
+
+
+namespace project_test
+{
+	// Bilinear and bicubic lookups of a heightfield baked from a bilinear function (interpolated exactly), at the nodes and between them
+	void test_heightfield();
+}
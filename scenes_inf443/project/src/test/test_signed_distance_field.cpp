@@ -0,0 +1,64 @@
+#include "test_signed_distance_field.hpp"
+
+#include "../signed_distance_field.hpp"
+#include "cgp/01_base/base.hpp"
+#include "cgp/11_mesh/primitive/primitive.hpp"
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+
+using namespace cgp;
+
+namespace project_test
+{
+	// Exact signed distance to the box [-r,r]^3
+	static float distance_box(vec3 const& p, float r) {
+		vec3 const q = { std::abs(p.x) - r, std::abs(p.y) - r, std::abs(p.z) - r };
+		vec3 const q_outside = { std::max(q.x, 0.0f), std::max(q.y, 0.0f), std::max(q.z, 0.0f) };
+		return norm(q_outside) + std::min(std::max(q.x, std::max(q.y, q.z)), 0.0f);
+	}
+
+	void test_signed_distance_field()
+	{
+		float const r = 1.0f;
+		mesh const cube = mesh_primitive_cube({ 0,0,0 }, 2 * r);
+		std::vector<vec3> triangles;
+		for (uint3 const& f : cube.connectivity)
+			for (int k = 0; k < 3; ++k)
+				triangles.push_back(cube.position[f[k]]);
+
+		float const band_width = 2.0f;
+		spatial_domain_grid_3D const domain = spatial_domain_grid_3D::from_corners({ -3,-3,-3 }, { 3,3,3 }, { 31,31,31 }); // Voxels of 0.2
+		signed_distance_field_structure field;
+		field.bake(triangles, domain, band_width);
+
+		// Sign and distance at the nodes and between them (the trilinear lookup is exact for the planar parts of the distance)
+		float const tolerance = 0.02f;
+		std::vector<vec3> samples = {
+			{ 0,0,0 }, { 0.5f,0,0 }, { 0.2f,-0.6f,0.4f },        // Inside
+			{ 1.4f,0,0 }, { 0,-1.7f,0.3f }, { 0.1f,0.2f,2.5f }, // Outside, in front of a face
+			{ 1.6f,1.6f,0 }, { 1.4f,1.4f,1.4f }                 // Outside, close to an edge and to a corner
+		};
+		for (vec3 const& p : samples) {
+			float const d_expected = std::max(distance_box(p, r), -band_width);
+			float const d = field.value(p).x;
+			assert_cgp((d < 0) == (d_expected < 0), "Wrong sign of the distance field at " + str(p) + ": " + str(d));
+			float const tolerance_p = std::abs(d_expected) > 1.0f ? 0.05f : tolerance; // Around the edges the distance is curved between the nodes
+			assert_cgp(std::abs(d - d_expected) < tolerance_p, "Wrong distance at " + str(p) + ": " + str(d) + " / " + str(d_expected));
+		}
+
+		// Clamped to the band far from the cube
+		assert_cgp(std::abs(field.value({ 3,3,3 }).x - band_width) < 1e-4f, "Distance far from the cube is not clamped to the band width");
+
+		// Gradient pointing away from the closest face
+		vec4 const g = field.value({ 1.5f,0.1f,-0.1f });
+		assert_cgp(norm(vec3(g.y, g.z, g.w) - vec3(1, 0, 0)) < 0.05f, "Wrong gradient of the distance field in front of the face x=1: " + str(vec3(g.y, g.z, g.w)));
+
+		// Union with an analytic distance (plane z = -2)
+		signed_distance_field_structure field_plane;
+		field_plane.bake(triangles, domain, band_width, [](vec3 const& p) { return p.z + 2; });
+		assert_cgp(std::abs(field_plane.value({ 0,0,-2.4f }).x + 0.4f) < tolerance, "Analytic distance is not combined with the distance to the triangles");
+		assert_cgp(std::abs(field_plane.value({ 0,0,1.4f }).x - 0.4f) < tolerance, "Analytic distance changes the distance to the triangles");
+	}
+}
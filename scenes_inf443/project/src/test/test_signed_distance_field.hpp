@@ -0,0 +1,8 @@
+#pragma once
+
+
+namespace project_test
+{
+	// Sign and distance of the field baked around a closed cube, compared to the exact signed distance of the box
+	void test_signed_distance_field();
+}